@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "boot_manager.h"
+
+static const char *BOOT_TAG = "BOOT";
+
+#define BOOT_STAGE_PRIORITY        4
+#define BOOT_STAGE_STACK_KB        4
+// A stage's done bit is BOOT_STAGE_BIT(index), its failed bit sits BOOT_FAILED_SHIFT above.
+// Event groups have 24 usable bits, which is what caps the stage count.
+#define BOOT_FAILED_SHIFT          BOOT_MAX_STAGES
+#define BOOT_TIMELINE_BAR_WIDTH    40
+
+static EventGroupHandle_t boot_events = NULL;
+static const boot_stage_t *stage_table = NULL;
+static int stage_count = 0;
+static boot_stage_record_t timeline[BOOT_MAX_STAGES];
+
+static void boot_stage_task(void *arg)
+{
+    int index = (int)(intptr_t)arg;
+    const boot_stage_t *stage = &stage_table[index];
+    boot_stage_record_t *record = &timeline[index];
+
+    if (stage->depends_on) {
+        xEventGroupWaitBits(boot_events, stage->depends_on, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+
+    record->start_us = esp_timer_get_time();
+    EventBits_t failed = (xEventGroupGetBits(boot_events) >> BOOT_FAILED_SHIFT) & stage->depends_on;
+    if (failed) {
+        record->result = ESP_ERR_INVALID_STATE;
+        ESP_LOGW(BOOT_TAG, "Skipping %s: a stage it depends on failed", stage->name);
+    } else {
+        record->result = stage->run();
+        if (record->result != ESP_OK) {
+            ESP_LOGE(BOOT_TAG, "Stage %s failed: %s", stage->name, esp_err_to_name(record->result));
+        }
+    }
+    record->end_us = esp_timer_get_time();
+
+    EventBits_t bits = BOOT_STAGE_BIT(index);
+    if (record->result != ESP_OK) {
+        bits |= BOOT_STAGE_BIT(index) << BOOT_FAILED_SHIFT;
+    }
+    xEventGroupSetBits(boot_events, bits);
+    vTaskDelete(NULL);
+}
+
+esp_err_t boot_manager_start(const boot_stage_t *stages, int count)
+{
+    if (boot_events || count <= 0 || count > BOOT_MAX_STAGES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Depending only on earlier stages keeps the graph free of cycles
+    for (int i = 0; i < count; i++) {
+        if (stages[i].depends_on & ~(BOOT_STAGE_BIT(i) - 1)) {
+            ESP_LOGE(BOOT_TAG, "Stage %s depends on itself or a later stage", stages[i].name);
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    boot_events = xEventGroupCreate();
+    if (!boot_events) {
+        return ESP_ERR_NO_MEM;
+    }
+    stage_table = stages;
+    stage_count = count;
+    memset(timeline, 0, sizeof(timeline));
+
+    for (int i = 0; i < count; i++) {
+        const boot_stage_t *stage = &stages[i];
+        timeline[i].name = stage->name;
+        timeline[i].core = stage->core;
+
+        int stack_kb = stage->stack_kb > 0 ? stage->stack_kb : BOOT_STAGE_STACK_KB;
+        BaseType_t core_id = (stage->core < 0) ? tskNO_AFFINITY : stage->core;
+        BaseType_t ret = xTaskCreatePinnedToCore(boot_stage_task, stage->name, stack_kb * 1024, (void *)(intptr_t)i,
+                                                 BOOT_STAGE_PRIORITY, NULL, core_id);
+        if (ret != pdPASS) {
+            // Count it as failed so the stages waiting on it are skipped instead of hanging
+            ESP_LOGE(BOOT_TAG, "Failed to create task for stage %s", stage->name);
+            timeline[i].start_us = esp_timer_get_time();
+            timeline[i].result = ESP_ERR_NO_MEM;
+            timeline[i].end_us = timeline[i].start_us;
+            xEventGroupSetBits(boot_events, BOOT_STAGE_BIT(i) | (BOOT_STAGE_BIT(i) << BOOT_FAILED_SHIFT));
+        }
+    }
+
+    ESP_LOGI(BOOT_TAG, "Started %d boot stages", count);
+    return ESP_OK;
+}
+
+bool boot_manager_wait(uint32_t stage_mask, TickType_t timeout)
+{
+    if (!boot_events) {
+        return false;
+    }
+    EventBits_t bits = xEventGroupWaitBits(boot_events, stage_mask, pdFALSE, pdTRUE, timeout);
+    return (bits & stage_mask) == stage_mask;
+}
+
+bool boot_manager_succeeded(int index)
+{
+    if (!boot_events || index < 0 || index >= stage_count) {
+        return false;
+    }
+    EventBits_t bits = xEventGroupGetBits(boot_events);
+    return (bits & BOOT_STAGE_BIT(index)) && !(bits & (BOOT_STAGE_BIT(index) << BOOT_FAILED_SHIFT));
+}
+
+int boot_manager_get_timeline(boot_stage_record_t *records, int max_records)
+{
+    int count = (stage_count < max_records) ? stage_count : max_records;
+    memcpy(records, timeline, count * sizeof(records[0]));
+    return count;
+}
+
+void boot_manager_dump_timeline(void)
+{
+    boot_stage_record_t records[BOOT_MAX_STAGES];
+    int count = boot_manager_get_timeline(records, BOOT_MAX_STAGES);
+
+    int64_t last_end_us = 1;
+    for (int i = 0; i < count; i++) {
+        if (records[i].end_us > last_end_us) {
+            last_end_us = records[i].end_us;
+        }
+    }
+
+    ESP_LOGI(BOOT_TAG, "Boot timeline (ms since power-on)");
+    ESP_LOGI(BOOT_TAG, "%-10s core   start     end    took", "stage");
+    for (int i = 0; i < count; i++) {
+        const boot_stage_record_t *r = &records[i];
+        char bar[BOOT_TIMELINE_BAR_WIDTH + 1];
+        memset(bar, '.', BOOT_TIMELINE_BAR_WIDTH);
+        bar[BOOT_TIMELINE_BAR_WIDTH] = '\0';
+        if (r->end_us) {
+            int from = (int)(r->start_us * BOOT_TIMELINE_BAR_WIDTH / last_end_us);
+            int to = (int)(r->end_us * BOOT_TIMELINE_BAR_WIDTH / last_end_us);
+            for (int x = from; x <= to && x < BOOT_TIMELINE_BAR_WIDTH; x++) {
+                bar[x] = '#';
+            }
+        }
+
+        char core[4];
+        snprintf(core, sizeof(core), "%d", r->core);
+        ESP_LOGI(BOOT_TAG, "%-10s %4s %7.1f %7.1f %7.1f  |%s| %s", r->name, r->core < 0 ? "any" : core,
+                 r->start_us / 1000.0f, r->end_us / 1000.0f,
+                 r->end_us ? (r->end_us - r->start_us) / 1000.0f : 0.0f, bar,
+                 !r->end_us ? "running" : (r->result == ESP_OK ? "" : esp_err_to_name(r->result)));
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef BOOT_MANAGER_H
+#define BOOT_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+// Boot orchestration: each stage runs in its own short-lived task pinned to a core and starts as
+// soon as every stage it depends on has finished, so independent work (WiFi bring-up, panel and
+// touch init, UI construction) overlaps instead of adding up. Stages a failed stage feeds are
+// skipped. Every stage's start and end time is recorded for the boot timeline.
+#define BOOT_MAX_STAGES 12
+
+#define BOOT_STAGE_BIT(index) (1u << (index))
+
+typedef struct {
+    const char *name;
+    esp_err_t (*run)(void);
+    uint32_t depends_on;   // BOOT_STAGE_BIT()s of earlier stages in the table to wait for
+    int core;              // Core to run on, -1 for either
+    int stack_kb;          // Task stack, 0 for the default
+} boot_stage_t;
+
+// One stage on the boot timeline. Times are esp_timer microseconds since power-on, 0 until reached.
+typedef struct {
+    const char *name;
+    int core;
+    int64_t start_us;      // Dependencies met, stage began
+    int64_t end_us;
+    esp_err_t result;      // ESP_ERR_INVALID_STATE if skipped because a dependency failed
+} boot_stage_record_t;
+
+// Function declarations
+// Start every stage of the table (kept by reference, so it must outlive the boot). Returns at once.
+esp_err_t boot_manager_start(const boot_stage_t *stages, int count);
+// Wait until all stages in stage_mask have finished. True if they did (successfully or not).
+bool boot_manager_wait(uint32_t stage_mask, TickType_t timeout);
+bool boot_manager_succeeded(int index);   // Finished without error
+int boot_manager_get_timeline(boot_stage_record_t *records, int max_records);
+void boot_manager_dump_timeline(void);    // Log the timeline as a table with a bar per stage
+
+#endif // BOOT_MANAGER_H
@@ -14,10 +14,13 @@
 #include "esp_log.h"
 #include "lvgl.h"
 #include "lvgl_port.h"
+#include "wifi_manager.h"
 
 static const char *TAG = "lv_port";                      // Tag for logging
 static SemaphoreHandle_t lvgl_mux;                       // LVGL mutex for synchronization
 static TaskHandle_t lvgl_task_handle = NULL;             // Handle for the LVGL task
+static SemaphoreHandle_t lvgl_wake_sem = NULL;           // Ends the LVGL task's sleep early (task notifications are taken by vsync)
+static void (*lvgl_cycle_cb)(void) = NULL;               // Run under the LVGL lock every task cycle
 
 #if EXAMPLE_LVGL_PORT_ROTATION_DEGREE != 0
 // Function to get the next frame buffer for double buffering
@@ -444,6 +447,7 @@ static void touchpad_read(lv_indev_drv_t *indev_drv, lv_indev_data_t *data)
         data->point.x = touchpad_x; // Set the X coordinate
         data->point.y = touchpad_y; // Set the Y coordinate
         data->state = LV_INDEV_STATE_PRESSED; // Set state to pressed
+        wifi_note_activity(); // Touches keep the radio out of power save the way commands do
         ESP_LOGD(TAG, "Touch position: %d,%d", touchpad_x, touchpad_y); // Log touch position
     } else {
         data->state = LV_INDEV_STATE_RELEASED; // Set state to released
@@ -490,6 +494,9 @@ static void lvgl_port_task(void *arg)
     uint32_t task_delay_ms = LVGL_PORT_TASK_MAX_DELAY_MS; // Set initial task delay
     while (1) {
         if (lvgl_port_lock(-1)) { // Try to lock the LVGL mutex
+            if (lvgl_cycle_cb) {
+                lvgl_cycle_cb(); // Let the application apply work queued from other tasks
+            }
             task_delay_ms = lv_timer_handler(); // Handle LVGL timer events
             lvgl_port_unlock(); // Unlock the mutex
         }
@@ -499,7 +506,7 @@ static void lvgl_port_task(void *arg)
         } else if (task_delay_ms < LVGL_PORT_TASK_MIN_DELAY_MS) {
             task_delay_ms = LVGL_PORT_TASK_MIN_DELAY_MS;
         }
-        vTaskDelay(pdMS_TO_TICKS(task_delay_ms)); // Delay the task for the calculated time
+        xSemaphoreTake(lvgl_wake_sem, pdMS_TO_TICKS(task_delay_ms)); // Sleep for the calculated time or until woken
     }
 }
 
@@ -530,6 +537,8 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
 
     lvgl_mux = xSemaphoreCreateRecursiveMutex(); // Create a recursive mutex for LVGL
     assert(lvgl_mux); // Ensure mutex creation was successful
+    lvgl_wake_sem = xSemaphoreCreateBinary(); // Create the semaphore that wakes the LVGL task
+    assert(lvgl_wake_sem); // Ensure semaphore creation was successful
 
     ESP_LOGI(TAG, "Create LVGL task"); // Log task creation
     BaseType_t core_id = (LVGL_PORT_TASK_CORE < 0) ? tskNO_AFFINITY : LVGL_PORT_TASK_CORE; // Determine core ID for the task
@@ -543,6 +552,18 @@ esp_err_t lvgl_port_init(esp_lcd_panel_handle_t lcd_handle, esp_lcd_touch_handle
     return ESP_OK; // Return success
 }
 
+void lvgl_port_set_cycle_cb(void (*cb)(void))
+{
+    lvgl_cycle_cb = cb;
+}
+
+void lvgl_port_wake(void)
+{
+    if (lvgl_wake_sem) {
+        xSemaphoreGive(lvgl_wake_sem); // Already given means the task is already due to wake
+    }
+}
+
 bool lvgl_port_lock(int timeout_ms)
 {
     assert(lvgl_mux && "lvgl_port_init must be called first"); // Ensure the mutex is initialized
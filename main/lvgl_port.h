@@ -145,6 +145,19 @@ bool lvgl_port_lock(int timeout_ms);
  */
 void lvgl_port_unlock(void);
 
+/**
+ * @brief Set a callback the LVGL task runs, with the LVGL mutex held, at the start of every cycle
+ *
+ * @param[in] cb: Callback, NULL to remove. Must be set with the LVGL mutex held.
+ */
+void lvgl_port_set_cycle_cb(void (*cb)(void));
+
+/**
+ * @brief Wake the LVGL task now instead of when its next timer is due. Safe from any task.
+ *
+ */
+void lvgl_port_wake(void);
+
 /**
  * @brief Notifies the LVGL task when the transmission of the RGB frame buffer is completed.
  *
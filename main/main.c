@@ -4,115 +4,213 @@
  * SPDX-License-Identifier: CC0-1.0
  */
 
+#include <stdatomic.h>
 #include "esp_log.h"
 #include "waveshare_rgb_lcd_port.h"
+#include "boot_manager.h"  // Parallel boot stages
+#include "status_bus.h"  // Connection state events
 #include "ui.h"  // Include your custom UI
 #include "wifi_manager.h"  // Include WiFi manager
+#include "wifi_supervisor.h"  // Reconnects and link quality
 #include "robot_arm_comm.h"  // Include robot arm communication
 #include "ui_robot_interface.h"  // Include UI robot interface
 
 static const char *MAIN_TAG = "MAIN";
 
 // Robot arm state tracking
-static bool robot_arm_initialized = false;
+static atomic_bool robot_arm_initialized = false;
 static const char* ROBOT_ARM_IP = "192.168.4.1";  // Default robot arm IP (adjust as needed)
 
+// How long the boot waits for WiFi before leaving the robot connection to the status timer
+#define BOOT_WIFI_WAIT_MS 15000
+
+// Boot stages, in dependency order (a stage may only depend on stages above it)
+enum {
+    STAGE_NVS,
+    STAGE_WIFI,
+    STAGE_PANEL,
+    STAGE_TOUCH,
+    STAGE_LVGL,
+    STAGE_UI,
+    STAGE_BACKLIGHT,
+    STAGE_ROBOT,
+    STAGE_COUNT
+};
+
+// Handed from the panel and touch stages to the LVGL stage
+static esp_lcd_panel_handle_t panel_handle = NULL;
+static esp_lcd_touch_handle_t touch_handle = NULL;
+
+// Initialize robot arm communication and enable torque, once per connection
+static void robot_arm_connect(void)
+{
+    bool expected = false;
+    if (!atomic_compare_exchange_strong(&robot_arm_initialized, &expected, true)) {
+        return;
+    }
+
+    robot_arm_comm_status_t result = robot_arm_init(ROBOT_ARM_IP);
+    if (result == ROBOT_ARM_COMM_OK) {
+        ESP_LOGI(MAIN_TAG, "Robot arm communication initialized successfully");
+
+        // Enable robot arm torque when connected
+        robot_arm_enable_torque();
+    } else {
+        ESP_LOGE(MAIN_TAG, "Failed to initialize robot arm communication");
+        atomic_store(&robot_arm_initialized, false);
+    }
+}
+
 // LVGL timer callback for UI updates
 static void ui_tick_timer_cb(lv_timer_t *timer)
 {
     ui_tick();  // Call the UI tick function
 }
 
-// WiFi status monitoring timer callback
-static void wifi_status_timer_cb(lv_timer_t *timer)
+// WiFi status changes, delivered by the status bus on the LVGL task
+static void on_wifi_status(status_topic_t topic, int value, void *user_data)
 {
-    static wifi_status_t last_status = WIFI_STATUS_DISCONNECTED;
-    wifi_status_t current_status = wifi_get_status();
-    
-    if (current_status != last_status) {
-        switch (current_status) {
-            case WIFI_STATUS_DISCONNECTED:
-                ESP_LOGI(MAIN_TAG, "WiFi Status: Disconnected");
-                robot_arm_initialized = false;
-                break;
-            case WIFI_STATUS_CONNECTING:
-                ESP_LOGI(MAIN_TAG, "WiFi Status: Connecting...");
-                break;
-            case WIFI_STATUS_CONNECTED:
-                ESP_LOGI(MAIN_TAG, "WiFi Status: Connected - IP: %s", wifi_get_ip_address());
-                
-                // Initialize robot arm communication once WiFi is connected
-                if (!robot_arm_initialized) {
-                    robot_arm_comm_status_t result = robot_arm_init(ROBOT_ARM_IP);
-                    if (result == ROBOT_ARM_COMM_OK) {
-                        robot_arm_initialized = true;
-                        ESP_LOGI(MAIN_TAG, "Robot arm communication initialized successfully");
-                        
-                        // Enable robot arm torque when connected
-                        robot_arm_enable_torque();
-                    } else {
-                        ESP_LOGE(MAIN_TAG, "Failed to initialize robot arm communication");
-                    }
-                }
-                break;
-            case WIFI_STATUS_FAILED:
-                ESP_LOGI(MAIN_TAG, "WiFi Status: Connection Failed");
-                robot_arm_initialized = false;
-                break;
-        }
-        last_status = current_status;
-        
-        // Update UI status display
-        update_robot_status_display();
+    switch ((wifi_status_t)value) {
+        case WIFI_STATUS_DISCONNECTED:
+            ESP_LOGI(MAIN_TAG, "WiFi Status: Disconnected");
+            atomic_store(&robot_arm_initialized, false);
+            break;
+        case WIFI_STATUS_CONNECTING:
+            ESP_LOGI(MAIN_TAG, "WiFi Status: Connecting...");
+            break;
+        case WIFI_STATUS_CONNECTED:
+            ESP_LOGI(MAIN_TAG, "WiFi Status: Connected - IP: %s", wifi_get_ip_address());
+
+            // Initialize robot arm communication once WiFi is connected
+            robot_arm_connect();
+            break;
+        case WIFI_STATUS_FAILED:
+            ESP_LOGI(MAIN_TAG, "WiFi Status: Connection Failed");
+            atomic_store(&robot_arm_initialized, false);
+            break;
     }
 }
 
-// UI status update timer callback
-static void ui_status_timer_cb(lv_timer_t *timer)
+static esp_err_t boot_nvs(void)
 {
-    // Update UI display with current robot arm status
-    update_robot_status_display();
+    return wifi_storage_init();
 }
 
-void app_main()
+static esp_err_t boot_wifi(void)
+{
+    wifi_start_sta();
+    // Keeps retrying after the manager gives up, so the panel never needs a power cycle
+    return wifi_supervisor_start();
+}
+
+static esp_err_t boot_panel(void)
+{
+    return waveshare_rgb_lcd_panel_init(&panel_handle);
+}
+
+static esp_err_t boot_touch(void)
+{
+    return waveshare_rgb_lcd_touch_init(&touch_handle);
+}
+
+static esp_err_t boot_lvgl(void)
+{
+    // Touch is waited for but not required: without it the panel still shows the arm's state
+    boot_manager_wait(BOOT_STAGE_BIT(STAGE_TOUCH), portMAX_DELAY);
+    if (!boot_manager_succeeded(STAGE_TOUCH)) {
+        ESP_LOGW(MAIN_TAG, "No touch input, starting the display without it");
+    }
+    return waveshare_rgb_lcd_lvgl_init(panel_handle, touch_handle);
+}
+
+static esp_err_t boot_ui(void)
 {
-    ESP_LOGI(MAIN_TAG, "Starting Robot Arm Touch Screen Controller");
-    
-    // Initialize the display first
-    waveshare_esp32_s3_rgb_lcd_init(); // Initialize the Waveshare ESP32-S3 RGB LCD 
-    waveshare_rgb_lcd_bl_on();  // Turn on the screen backlight
-    
-    ESP_LOGI(MAIN_TAG, "Display initialized, initializing UI...");
-    
     // Lock the mutex due to the LVGL APIs are not thread-safe
-    if (lvgl_port_lock(-1)) {
-        // Initialize your custom UI once
-        ui_init();
-        
-        // Initialize the UI robot interface (setup event handlers)
-        ui_robot_interface_init();
-        
-        // Create an LVGL timer for periodic UI updates (EEZ flow ticking)
-        lv_timer_t *ui_timer = lv_timer_create(ui_tick_timer_cb, 50, NULL);
-        lv_timer_set_repeat_count(ui_timer, -1); // Repeat indefinitely
-        
-        // Create a timer for WiFi status monitoring
-        lv_timer_t *wifi_timer = lv_timer_create(wifi_status_timer_cb, 1000, NULL);
-        lv_timer_set_repeat_count(wifi_timer, -1); // Repeat indefinitely
-        
-        // Create a timer for UI status updates
-        lv_timer_t *status_timer = lv_timer_create(ui_status_timer_cb, 2000, NULL);
-        lv_timer_set_repeat_count(status_timer, -1); // Repeat indefinitely
-        
-        // Release the mutex
-        lvgl_port_unlock();
+    if (!lvgl_port_lock(-1)) {
+        return ESP_ERR_TIMEOUT;
     }
+
+    // Initialize your custom UI once
+    ui_init();
+
+    // Initialize the UI robot interface (setup event handlers)
+    ui_robot_interface_init();
+
+    // Create an LVGL timer for periodic UI updates (EEZ flow ticking)
+    lv_timer_t *ui_timer = lv_timer_create(ui_tick_timer_cb, 50, NULL);
+    lv_timer_set_repeat_count(ui_timer, -1); // Repeat indefinitely
+
+    // Connection state reaches the UI as it changes: publishers wake the LVGL task, which
+    // delivers to the subscribers at the start of its next cycle
+    status_bus_subscribe(STATUS_TOPIC_WIFI, on_wifi_status, NULL);
+    lvgl_port_set_cycle_cb(status_bus_dispatch);
+    status_bus_set_notify(lvgl_port_wake);
+
+    // Draw the first frame now rather than on the LVGL task's next cycle
+    lv_refr_now(NULL);
+
+    // Release the mutex
+    lvgl_port_unlock();
+    return ESP_OK;
+}
+
+static esp_err_t boot_backlight(void)
+{
+    // Only after the first frame, so the panel never shows an undrawn framebuffer. The I2C bus
+    // comes up with touch; if it did not, the expander write fails and says so.
+    boot_manager_wait(BOOT_STAGE_BIT(STAGE_TOUCH), portMAX_DELAY);
+    return waveshare_rgb_lcd_bl_on();
+}
+
+static esp_err_t boot_robot(void)
+{
+#ifndef CONFIG_ROBOT_ARM_TRANSPORT_DEFAULT_UART
+    if (!wifi_wait_connected(pdMS_TO_TICKS(BOOT_WIFI_WAIT_MS))) {
+        // on_wifi_status() connects the robot whenever WiFi comes up later
+        return ESP_ERR_TIMEOUT;
+    }
+#endif
+    // Wired link: robot commands do not have to wait for WiFi
+    robot_arm_connect();
+    return atomic_load(&robot_arm_initialized) ? ESP_OK : ESP_FAIL;
+}
+
+// LVGL work stays on the LVGL core, WiFi and the robot link on the protocol core. The panel
+// is brought up on core 0 as before: the RGB driver installs its interrupt on the calling core,
+// and there it does not compete with LVGL rendering for the bounce buffer refills.
+static const boot_stage_t boot_stages[STAGE_COUNT] = {
+    [STAGE_NVS]       = { "nvs",       boot_nvs,       0,                                                    0, 0 },
+    [STAGE_WIFI]      = { "wifi",      boot_wifi,      BOOT_STAGE_BIT(STAGE_NVS),                            0, 0 },
+    [STAGE_PANEL]     = { "panel",     boot_panel,     0,                                                    0, 0 },
+    [STAGE_TOUCH]     = { "touch",     boot_touch,     0,                                                    0, 0 },
+    [STAGE_LVGL]      = { "lvgl",      boot_lvgl,      BOOT_STAGE_BIT(STAGE_PANEL),                          1, 0 },
+    [STAGE_UI]        = { "ui",        boot_ui,        BOOT_STAGE_BIT(STAGE_LVGL),                           1, 8 },
+    [STAGE_BACKLIGHT] = { "backlight", boot_backlight, BOOT_STAGE_BIT(STAGE_UI),                             0, 0 },
+#ifdef CONFIG_ROBOT_ARM_TRANSPORT_DEFAULT_UART
+    [STAGE_ROBOT]     = { "robot",     boot_robot,     0,                                                    0, 0 },
+#else
+    [STAGE_ROBOT]     = { "robot",     boot_robot,     BOOT_STAGE_BIT(STAGE_WIFI),                           0, 0 },
+#endif
+};
+
+void app_main()
+{
+    ESP_LOGI(MAIN_TAG, "Starting Robot Arm Touch Screen Controller");
     
-    ESP_LOGI(MAIN_TAG, "UI initialized successfully. Initializing WiFi...");
-    
-    // Initialize WiFi and connect to robot arm
-    wifi_init_sta();
-    
+    // Display, touch, UI and WiFi come up concurrently; see boot_stages for the dependencies
+    ESP_ERROR_CHECK(boot_manager_start(boot_stages, STAGE_COUNT));
+
+    boot_manager_wait(BOOT_STAGE_BIT(STAGE_COUNT) - 1, portMAX_DELAY);
+    boot_manager_dump_timeline();
+
+    wifi_connect_stats_t wifi_stats;
+    wifi_get_connect_stats(&wifi_stats);
+    boot_stage_record_t timeline[BOOT_MAX_STAGES];
+    boot_manager_get_timeline(timeline, BOOT_MAX_STAGES);
+    ESP_LOGI(MAIN_TAG, "First frame at %.1f ms, WiFi at %lu ms, robot ready at %.1f ms",
+             timeline[STAGE_UI].end_us / 1000.0f, (unsigned long)wifi_stats.boot_to_connected_ms,
+             boot_manager_succeeded(STAGE_ROBOT) ? timeline[STAGE_ROBOT].end_us / 1000.0f : 0.0f);
+
     ESP_LOGI(MAIN_TAG, "System initialization complete. Touch screen controls are now active!");
     ESP_LOGI(MAIN_TAG, "Move the sliders to control robot arm joints:");
     ESP_LOGI(MAIN_TAG, "  - Base Joint: ±90° rotation");
@@ -0,0 +1,221 @@
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "robot_arm_cmd_cache.h"
+#include "robot_arm_encode.h"
+#include "robot_arm_json.h"
+
+static const char *CACHE_TAG = "ROBOT_CACHE";
+
+// One pre-encoded T:101 command per slider step, in both wire forms, plus this joint's member of
+// an all-joint move (T:102) at that step: ,"base":-1.57 or its URL-encoded form
+#define CACHE_JSON_MAX   64
+#define CACHE_PATH_MAX   128
+#define MEMBER_JSON_MAX  24
+#define MEMBER_PATH_MAX  40
+typedef struct {
+    float radians;               // Exact value the UI mapping produces for this step
+    char json[CACHE_JSON_MAX];
+    char path[CACHE_PATH_MAX];
+    char member_json[MEMBER_JSON_MAX];
+    char member_path[MEMBER_PATH_MAX];
+} cache_entry_t;
+
+// What surrounds the joint members of a T:102 at this table's speed and acceleration
+#define HEAD_MAX 32
+#define TAIL_MAX 64
+typedef struct {
+    char head[HEAD_MAX];         // {"T":102 (path form: /js?json=%7B%22T%22%3A102)
+    char tail[TAIL_MAX];         // ,"spd":0,"acc":10}
+} cache_frame_t;
+
+typedef struct {
+    float min_rad;
+    float max_rad;
+    int speed;
+    int acceleration;
+    cache_frame_t joints_json;
+    cache_frame_t joints_path;
+    cache_entry_t entries[ROBOT_ARM_CMD_CACHE_STEPS + 1];
+} cache_table_t;
+
+// Published once by robot_arm_cmd_cache_build(), then only read
+static _Atomic(cache_table_t *) cache_tables[ROBOT_ARM_JOINT_COUNT];
+static atomic_uint cache_hits = 0;
+static atomic_uint cache_misses = 0;
+
+// Pre-encode the head and tail of an all-joint move in one wire form
+static bool build_frame(cache_frame_t *frame, bool url_encode, int speed, int acceleration)
+{
+    robot_arm_json_writer_t writer;
+    robot_arm_json_init(&writer, frame->head, sizeof(frame->head), url_encode);
+    if (url_encode) {
+        robot_arm_json_raw(&writer, ROBOT_ARM_HTTP_PATH_PREFIX);
+    }
+    robot_arm_json_begin_object(&writer);
+    robot_arm_json_int(&writer, "T", 102);
+    if (robot_arm_json_finish(&writer) < 0) {
+        return false;
+    }
+
+    robot_arm_json_init(&writer, frame->tail, sizeof(frame->tail), url_encode);
+    writer.need_comma = true;
+    robot_arm_json_int(&writer, "spd", speed);
+    robot_arm_json_int(&writer, "acc", acceleration);
+    robot_arm_json_end_object(&writer);
+    return robot_arm_json_finish(&writer) >= 0;
+}
+
+// Pre-encode one joint's member of an all-joint move, comma included
+static bool build_member(char *out, size_t size, bool url_encode, int index, float radians)
+{
+    robot_arm_json_writer_t writer;
+    robot_arm_json_init(&writer, out, size, url_encode);
+    writer.need_comma = true;
+    robot_arm_json_fixed(&writer, robot_arm_encode_joint_keys[index], radians, ROBOT_ARM_RADIAN_DECIMALS);
+    return robot_arm_json_finish(&writer) >= 0;
+}
+
+bool robot_arm_cmd_cache_build(robot_arm_joint_t joint, float min_rad, float max_rad, int speed, int acceleration)
+{
+    if (joint < ROBOT_ARM_JOINT_BASE || joint > ROBOT_ARM_JOINT_GRIPPER || max_rad <= min_rad) {
+        return false;
+    }
+    int index = joint - ROBOT_ARM_JOINT_BASE;
+    if (atomic_load(&cache_tables[index])) {
+        ESP_LOGW(CACHE_TAG, "Command cache for joint %d already built", joint);
+        return false;
+    }
+
+    // The table is ~26 KB per joint: keep it in PSRAM when there is some
+    cache_table_t *table = heap_caps_malloc(sizeof(cache_table_t), MALLOC_CAP_SPIRAM);
+    if (!table) {
+        table = malloc(sizeof(cache_table_t));
+    }
+    if (!table) {
+        ESP_LOGE(CACHE_TAG, "No memory for joint %d command cache", joint);
+        return false;
+    }
+
+    table->min_rad = min_rad;
+    table->max_rad = max_rad;
+    table->speed = speed;
+    table->acceleration = acceleration;
+    if (!build_frame(&table->joints_json, false, speed, acceleration) ||
+        !build_frame(&table->joints_path, true, speed, acceleration)) {
+        ESP_LOGE(CACHE_TAG, "All-joint frame for joint %d does not fit the cache", joint);
+        free(table);
+        return false;
+    }
+
+    robot_arm_cmd_t cmd = {
+        .type = ROBOT_ARM_CMD_MOVE_JOINT,
+        .move = { .joint = joint, .speed = speed, .acceleration = acceleration },
+    };
+    for (int step = 0; step <= ROBOT_ARM_CMD_CACHE_STEPS; step++) {
+        cache_entry_t *entry = &table->entries[step];
+        // Same arithmetic as map_slider_to_joint_range() so lookups match bit for bit
+        cmd.move.radians = min_rad + (float)step * (max_rad - min_rad) / 100.0f;
+        entry->radians = cmd.move.radians;
+        if (robot_arm_encode_command(&cmd, ROBOT_ARM_PAYLOAD_JSON, entry->json, sizeof(entry->json)) < 0 ||
+            robot_arm_encode_command(&cmd, ROBOT_ARM_PAYLOAD_HTTP_PATH, entry->path, sizeof(entry->path)) < 0 ||
+            !build_member(entry->member_json, sizeof(entry->member_json), false, index, cmd.move.radians) ||
+            !build_member(entry->member_path, sizeof(entry->member_path), true, index, cmd.move.radians)) {
+            ESP_LOGE(CACHE_TAG, "Command for joint %d step %d does not fit the cache", joint, step);
+            free(table);
+            return false;
+        }
+    }
+
+    atomic_store_explicit(&cache_tables[index], table, memory_order_release);
+    ESP_LOGI(CACHE_TAG, "Pre-encoded %d positions for joint %d", ROBOT_ARM_CMD_CACHE_STEPS + 1, joint);
+    return true;
+}
+
+// The entry for a slider position of a joint, or NULL if the table does not hold it
+static const cache_entry_t *find_entry(robot_arm_joint_t joint, float radians, int speed, int acceleration)
+{
+    if (joint < ROBOT_ARM_JOINT_BASE || joint > ROBOT_ARM_JOINT_GRIPPER) {
+        return NULL;
+    }
+    const cache_table_t *table = atomic_load_explicit(&cache_tables[joint - ROBOT_ARM_JOINT_BASE],
+                                                      memory_order_acquire);
+    if (!table || speed != table->speed || acceleration != table->acceleration) {
+        return NULL;
+    }
+
+    // Nearest step, then confirm the command is exactly what that step produces
+    float position = (radians - table->min_rad) * ROBOT_ARM_CMD_CACHE_STEPS / (table->max_rad - table->min_rad);
+    long step = lroundf(position);
+    if (step < 0 || step > ROBOT_ARM_CMD_CACHE_STEPS || table->entries[step].radians != radians) {
+        return NULL;
+    }
+    return &table->entries[step];
+}
+
+// Append text at *len, keeping the terminator; false if it does not fit
+static bool append(char *out, size_t size, size_t *len, const char *text)
+{
+    size_t n = strlen(text);
+    if (*len + n >= size) {
+        return false;
+    }
+    memcpy(out + *len, text, n + 1);
+    *len += n;
+    return true;
+}
+
+// Assemble an all-joint move from the cached members of every joint
+static const char *assemble_joints(const robot_arm_cmd_t *cmd, bool url_encode, char *buffer, size_t size)
+{
+    const cache_entry_t *entries[ROBOT_ARM_JOINT_COUNT];
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        entries[i] = find_entry((robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + i), cmd->joints.radians[i],
+                                cmd->joints.speed, cmd->joints.acceleration);
+        if (!entries[i]) {
+            return NULL;
+        }
+    }
+
+    // Every table matched the command's speed and acceleration, so any of them has its frame
+    const cache_table_t *table = atomic_load_explicit(&cache_tables[0], memory_order_acquire);
+    const cache_frame_t *frame = url_encode ? &table->joints_path : &table->joints_json;
+    size_t len = 0;
+    bool fits = append(buffer, size, &len, frame->head);
+    for (int i = 0; fits && i < ROBOT_ARM_JOINT_COUNT; i++) {
+        fits = append(buffer, size, &len, url_encode ? entries[i]->member_path : entries[i]->member_json);
+    }
+    fits = fits && append(buffer, size, &len, frame->tail);
+    return fits ? buffer : NULL;
+}
+
+const char *robot_arm_cmd_cache_lookup(const robot_arm_cmd_t *cmd, robot_arm_payload_t format, char *buffer, size_t size)
+{
+    bool url_encode = (format == ROBOT_ARM_PAYLOAD_HTTP_PATH);
+    const char *payload = NULL;
+
+    if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINT) {
+        const cache_entry_t *entry = find_entry(cmd->move.joint, cmd->move.radians, cmd->move.speed, cmd->move.acceleration);
+        payload = !entry ? NULL : url_encode ? entry->path : entry->json;
+    } else if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINTS) {
+        payload = assemble_joints(cmd, url_encode, buffer, size);
+    } else {
+        return NULL;
+    }
+
+    atomic_fetch_add(payload ? &cache_hits : &cache_misses, 1);
+    return payload;
+}
+
+void robot_arm_cmd_cache_get_stats(uint32_t *hits, uint32_t *misses)
+{
+    if (hits) {
+        *hits = atomic_load(&cache_hits);
+    }
+    if (misses) {
+        *misses = atomic_load(&cache_misses);
+    }
+}
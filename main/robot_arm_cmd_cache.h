@@ -0,0 +1,26 @@
+#ifndef ROBOT_ARM_CMD_CACHE_H
+#define ROBOT_ARM_CMD_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "robot_arm_comm.h"
+#include "robot_arm_transport.h"
+
+// Number of slider steps per joint (slider range 0-100)
+#define ROBOT_ARM_CMD_CACHE_STEPS 100
+
+// Pre-encode the single-joint move, and the joint's part of an all-joint move, for every slider
+// step of a joint, using the same slider-to-radian mapping as the UI. Call once per joint before
+// commands flow.
+bool robot_arm_cmd_cache_build(robot_arm_joint_t joint, float min_rad, float max_rad, int speed, int acceleration);
+
+// Return the pre-encoded payload for a command, or NULL if it is not one the cache holds.
+// A single-joint move (T:101) is returned from the cache itself. An all-joint move (T:102) with
+// every joint on a slider step is put together in buffer from pre-encoded pieces, with no number
+// formatting; buffer may be NULL when only T:101 is looked up.
+const char *robot_arm_cmd_cache_lookup(const robot_arm_cmd_t *cmd, robot_arm_payload_t format, char *buffer, size_t size);
+
+// Cache hit/miss counters (single- and all-joint moves)
+void robot_arm_cmd_cache_get_stats(uint32_t *hits, uint32_t *misses);
+
+#endif // ROBOT_ARM_CMD_CACHE_H
@@ -1,10 +1,22 @@
 #include <string.h>
+#include <math.h>
 #include <stdio.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_log.h"
-#include "esp_http_client.h"
-#include "cJSON.h"
+#include "esp_timer.h"
 #include "robot_arm_comm.h"
+#include "robot_arm_queue.h"
+#include "robot_arm_transport.h"
+#include "robot_arm_encode.h"
+#include "robot_arm_cmd_cache.h"
+#include "robot_arm_feedback.h"
+#include "robot_arm_stats.h"
+#include "robot_arm_rate.h"
 #include "wifi_manager.h"
+#include "wifi_supervisor.h"
+#include "status_bus.h"
 
 static const char *ROBOT_TAG = "ROBOT_ARM";
 
@@ -13,125 +25,554 @@ static char robot_ip[16] = {0};
 static bool robot_initialized = false;
 static robot_arm_comm_status_t comm_status = ROBOT_ARM_COMM_NOT_CONNECTED;
 
-// HTTP response buffer
-#define HTTP_BUFFER_SIZE 1024
-static char http_response_buffer[HTTP_BUFFER_SIZE];
-static int http_response_len = 0;
-
-// HTTP event handler
-static esp_err_t http_event_handler(esp_http_client_event_t *evt)
-{
-    switch (evt->event_id) {
-        case HTTP_EVENT_ERROR:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_ERROR");
-            break;
-        case HTTP_EVENT_ON_CONNECTED:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_ON_CONNECTED");
-            break;
-        case HTTP_EVENT_HEADER_SENT:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_HEADER_SENT");
-            break;
-        case HTTP_EVENT_ON_HEADER:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_ON_HEADER, key=%s, value=%s", evt->header_key, evt->header_value);
-            break;
-        case HTTP_EVENT_ON_HEADERS_COMPLETE:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_ON_HEADERS_COMPLETE");
-            break;
-        case HTTP_EVENT_ON_DATA:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_ON_DATA, len=%d", evt->data_len);
-            if (evt->data_len < HTTP_BUFFER_SIZE - http_response_len) {
-                memcpy(http_response_buffer + http_response_len, evt->data, evt->data_len);
-                http_response_len += evt->data_len;
-                http_response_buffer[http_response_len] = '\0';
-            }
-            break;
-        case HTTP_EVENT_ON_FINISH:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_ON_FINISH");
-            break;
-        case HTTP_EVENT_DISCONNECTED:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_DISCONNECTED");
-            break;
-        case HTTP_EVENT_REDIRECT:
-            ESP_LOGD(ROBOT_TAG, "HTTP_EVENT_REDIRECT");
-            break;
+// Transport selection. The requested transport is opened lazily by the comm task; if it cannot
+// be opened or a send on it fails, the comm task falls back to HTTP until the next selection.
+#if defined(CONFIG_ROBOT_ARM_TRANSPORT_DEFAULT_WS)
+#define DEFAULT_TRANSPORT ROBOT_ARM_TRANSPORT_WS
+#elif defined(CONFIG_ROBOT_ARM_TRANSPORT_DEFAULT_UART)
+#define DEFAULT_TRANSPORT ROBOT_ARM_TRANSPORT_UART
+#else
+#define DEFAULT_TRANSPORT ROBOT_ARM_TRANSPORT_HTTP
+#endif
+static const robot_arm_transport_t *const transports[] = {
+    [ROBOT_ARM_TRANSPORT_HTTP] = &robot_arm_transport_http,
+    [ROBOT_ARM_TRANSPORT_WS] = &robot_arm_transport_ws,
+    [ROBOT_ARM_TRANSPORT_UART] = &robot_arm_transport_uart,
+};
+static atomic_int requested_transport = DEFAULT_TRANSPORT;
+static robot_arm_transport_kind_t selected_transport = DEFAULT_TRANSPORT;  // Last selection acted on
+static const robot_arm_transport_t *active_transport = NULL;               // Open transport, if any
+static atomic_int active_transport_kind = DEFAULT_TRANSPORT;
+static atomic_uint transport_fallbacks = 0;
+static atomic_bool session_reset_pending = false;  // Set by robot_arm_init(), handled by the comm task
+
+// Record the result of the last command; the status bus only passes on changes
+static void set_comm_status(robot_arm_comm_status_t status)
+{
+    comm_status = status;
+    status_bus_publish(STATUS_TOPIC_ROBOT, status);
+}
+
+// Largest encoded command (URL-encoded all-joint move plus request path)
+#define COMMAND_BUFFER_SIZE 256
+
+// Comm worker task and its request queue; transports are only touched by this task
+#define COMM_TASK_STACK_SIZE   (CONFIG_ROBOT_ARM_COMM_TASK_STACK_SIZE_KB * 1024)
+#define COMM_TASK_PRIORITY     (CONFIG_ROBOT_ARM_COMM_TASK_PRIORITY)
+#define COMM_TASK_CORE         (CONFIG_ROBOT_ARM_COMM_TASK_CORE)
+#define COMM_QUEUE_LENGTH      (CONFIG_ROBOT_ARM_COMM_QUEUE_LENGTH)
+static TaskHandle_t comm_task_handle = NULL;
+static robot_arm_queue_slot_t comm_queue_slots[COMM_QUEUE_LENGTH];
+static robot_arm_queue_t comm_queue;
+static atomic_uint comm_dropped = 0;
+
+// Feedback polling: the comm task requests joint feedback every period while it is idle or busy
+#define FEEDBACK_POLL_MS       (CONFIG_ROBOT_ARM_FEEDBACK_POLL_MS)
+
+// Latest-wins coalescing: one pending slot per joint, one for all-joint moves and one for the
+// LED. A newer target overwrites an unsent one, so each joint has at most one command in
+// flight and one waiting. The all-joint slot comes first so single-joint edits made after it
+// are applied on top.
+#define PENDING_SLOT_JOINTS    0
+#define PENDING_SLOT_JOINT(j)  (1 + (j) - ROBOT_ARM_JOINT_BASE)
+#define PENDING_SLOT_LED       (1 + ROBOT_ARM_JOINT_COUNT)
+#define PENDING_SLOT_COUNT     (2 + ROBOT_ARM_JOINT_COUNT)
+typedef struct {
+    bool pending;
+    robot_arm_request_t request;
+} pending_slot_t;
+static pending_slot_t pending_slots[PENDING_SLOT_COUNT];
+static portMUX_TYPE pending_lock = portMUX_INITIALIZER_UNLOCKED;
+// Store count per slot; a request in flight whose slot has moved on has been superseded
+static atomic_uint pending_generation[PENDING_SLOT_COUNT];
+static atomic_uint comm_coalesced = 0;
+static uint32_t pending_next = 0;   // Round-robin start among the single-joint and LED slots
+
+// Send-rate control: pending (coalescable) commands are paced by the AIMD controller, so a slow
+// link gets fewer, larger steps from the latest-wins slots instead of a growing backlog.
+// Ordered commands and feedback polls are not paced. Written by the comm task only.
+#define RATE_MIN_HZ            (CONFIG_ROBOT_ARM_RATE_MIN_HZ)
+#define RATE_MAX_HZ            (CONFIG_ROBOT_ARM_RATE_MAX_HZ)
+static robot_arm_rate_t send_rate;
+static portMUX_TYPE rate_lock = portMUX_INITIALIZER_UNLOCKED;
+// The WiFi link quality caps the rate, scaled from RATE_MAX_HZ at 100 down to RATE_MIN_HZ at 0,
+// so a marginal link is paced down before it starts losing commands
+static uint8_t applied_link_quality = 255;   // Comm task only; 255 until first applied
+
+// Send time limits per command class. Each waits one retransmission timeout (from the RTT the
+// rate controller tracks) for a reply before resending, so a lost request costs a few round
+// trips instead of a fixed multi-second timeout. Coalesced commands are given up as soon as a
+// newer one supersedes them; ordered ones keep trying longer; a lost feedback poll is not
+// resent, the next poll replaces it.
+#define RTO_MIN_MS             (CONFIG_ROBOT_ARM_RTO_MIN_MS)
+#define MOVE_BUDGET_MS         (CONFIG_ROBOT_ARM_MOVE_TIMEOUT_MS)
+#define ORDERED_BUDGET_MS      (CONFIG_ROBOT_ARM_ORDERED_TIMEOUT_MS)
+#define PRIORITY_BUDGET_MS     1000
+
+// Priority lane: torque-off and home skip the command queue and the pending slots. A
+// higher-priority task sends them on a connection of its own, so a stop never waits behind a
+// move in flight. Each one also flushes pending motion and bumps the safety epoch, so moves (and
+// torque-on) submitted before it are dropped unsent; torque-off holds further motion until
+// torque is enabled again.
+#define PRIORITY_TASK_STACK_SIZE  (4 * 1024)
+#define PRIORITY_TASK_PRIORITY    (CONFIG_ROBOT_ARM_PRIORITY_TASK_PRIORITY)
+#define PRIORITY_QUEUE_LENGTH     8
+#define PRIORITY_DEADLINE_US      (CONFIG_ROBOT_ARM_PRIORITY_DEADLINE_MS * 1000)
+static TaskHandle_t priority_task_handle = NULL;
+static robot_arm_queue_slot_t priority_queue_slots[PRIORITY_QUEUE_LENGTH];
+static robot_arm_queue_t priority_queue;
+static bool priority_session_open = false;           // Priority task only
+static atomic_bool priority_reset_pending = false;   // Set by robot_arm_init()
+static atomic_uint safety_epoch = 0;
+static atomic_bool motion_halted = false;
+static atomic_uint priority_sent = 0;
+static atomic_uint priority_max_dispatch_us = 0;
+static atomic_uint priority_deadline_misses = 0;
+static atomic_uint comm_flushed = 0;
+
+// Last joint angles the robot accepted, NAN until a joint is first commanded
+static float commanded_radians[ROBOT_ARM_JOINT_COUNT] = { NAN, NAN, NAN, NAN };
+static portMUX_TYPE commanded_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Close whatever transport is open (comm task only)
+static void transport_close_active(void)
+{
+    if (active_transport) {
+        active_transport->close();
+        active_transport = NULL;
+    }
+}
+
+// Switch to the HTTP transport after the selected one failed (comm task only)
+static bool transport_fall_back_to_http(void)
+{
+    transport_close_active();
+    atomic_fetch_add(&transport_fallbacks, 1);
+    if (!robot_arm_transport_http.open(robot_ip)) {
+        return false;
+    }
+    active_transport = &robot_arm_transport_http;
+    atomic_store(&active_transport_kind, ROBOT_ARM_TRANSPORT_HTTP);
+    status_bus_publish(STATUS_TOPIC_TRANSPORT, ROBOT_ARM_TRANSPORT_HTTP);
+    return true;
+}
+
+// Make sure a transport is open, honouring a new selection or address (comm task only)
+static bool transport_ensure_open(void)
+{
+    robot_arm_transport_kind_t wanted = (robot_arm_transport_kind_t)atomic_load(&requested_transport);
+    bool reset = atomic_exchange(&session_reset_pending, false);
+
+    if (active_transport && !reset && wanted == selected_transport) {
+        return true;
+    }
+
+    transport_close_active();
+    selected_transport = wanted;
+
+    const robot_arm_transport_t *transport = transports[wanted];
+    if (transport->open(robot_ip)) {
+        active_transport = transport;
+        atomic_store(&active_transport_kind, wanted);
+        status_bus_publish(STATUS_TOPIC_TRANSPORT, wanted);
+        ESP_LOGI(ROBOT_TAG, "Using %s transport", transport->name);
+        return true;
+    }
+
+    if (wanted != ROBOT_ARM_TRANSPORT_HTTP) {
+        ESP_LOGW(ROBOT_TAG, "Could not open %s transport, falling back to HTTP", transport->name);
+        return transport_fall_back_to_http();
     }
-    return ESP_OK;
+    return false;
 }
 
-// Send HTTP GET request with JSON data to robot arm (equivalent to curl --get --data-urlencode)
-static robot_arm_comm_status_t send_robot_command_json(const char* json_data)
+// Encode a command in the active transport's wire form and send it (comm task only).
+// Slider positions come from the pre-encoded cache; anything else is encoded here.
+static robot_arm_comm_status_t send_on_active_transport(const robot_arm_cmd_t *cmd, robot_arm_send_limits_t *limits)
 {
-    if (!wifi_is_connected()) {
+    char buffer[COMMAND_BUFFER_SIZE];
+    const char *payload = robot_arm_cmd_cache_lookup(cmd, active_transport->payload, buffer, sizeof(buffer));
+
+    if (!payload) {
+        if (robot_arm_encode_command(cmd, active_transport->payload, buffer, sizeof(buffer)) < 0) {
+            ESP_LOGE(ROBOT_TAG, "Could not encode command type %d", cmd->type);
+            return ROBOT_ARM_COMM_ERROR;
+        }
+        payload = buffer;
+    }
+
+    ESP_LOGD(ROBOT_TAG, "Sending command over %s: %s", active_transport->name, payload);
+    return active_transport->send(payload, limits);
+}
+
+// Send a command to the robot over the active transport within limits (comm task only)
+static robot_arm_comm_status_t execute_command(const robot_arm_cmd_t *cmd, robot_arm_send_limits_t *limits)
+{
+    if (!robot_initialized) {
+        ESP_LOGW(ROBOT_TAG, "Robot arm not initialized");
+        return ROBOT_ARM_COMM_NOT_CONNECTED;
+    }
+
+    if (!transport_ensure_open()) {
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    if (active_transport->needs_wifi && !wifi_is_connected()) {
         ESP_LOGW(ROBOT_TAG, "WiFi not connected");
         return ROBOT_ARM_COMM_NOT_CONNECTED;
     }
 
+    robot_arm_comm_status_t result = send_on_active_transport(cmd, limits);
+    if (result != ROBOT_ARM_COMM_OK && active_transport != &robot_arm_transport_http) {
+        ESP_LOGW(ROBOT_TAG, "%s send failed, falling back to HTTP", active_transport->name);
+        if (!transport_fall_back_to_http()) {
+            return ROBOT_ARM_COMM_ERROR;
+        }
+        result = send_on_active_transport(cmd, limits);
+    }
+
+    return result;
+}
+
+// Commands that go out on the priority lane
+static bool is_priority_command(const robot_arm_cmd_t *cmd)
+{
+    return (cmd->type == ROBOT_ARM_CMD_TORQUE && !cmd->torque_on) || cmd->type == ROBOT_ARM_CMD_HOME;
+}
+
+// Commands a later stop or home supersedes: anything that would make the arm move
+static bool is_motion_command(const robot_arm_cmd_t *cmd)
+{
+    return cmd->type == ROBOT_ARM_CMD_MOVE_JOINT || cmd->type == ROBOT_ARM_CMD_MOVE_JOINTS ||
+           (cmd->type == ROBOT_ARM_CMD_TORQUE && cmd->torque_on);
+}
+
+// Map a coalescable command to its pending slot, or -1 if it must be queued in order
+static int pending_slot_index(const robot_arm_cmd_t *cmd)
+{
+    if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINT &&
+        cmd->move.joint >= ROBOT_ARM_JOINT_BASE && cmd->move.joint <= ROBOT_ARM_JOINT_GRIPPER) {
+        return PENDING_SLOT_JOINT(cmd->move.joint);
+    }
+    if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINTS) {
+        return PENDING_SLOT_JOINTS;
+    }
+    if (cmd->type == ROBOT_ARM_CMD_LED) {
+        return PENDING_SLOT_LED;
+    }
+    return -1;
+}
+
+// Store a request in its slot, replacing any unsent one. Returns how many unsent requests it
+// superseded: an all-joint move also supersedes every pending single-joint move.
+static uint32_t pending_slot_store(int index, const robot_arm_request_t *request)
+{
+    uint32_t replaced = 0;
+
+    portENTER_CRITICAL(&pending_lock);
+    if (index == PENDING_SLOT_JOINTS) {
+        for (int j = ROBOT_ARM_JOINT_BASE; j <= ROBOT_ARM_JOINT_GRIPPER; j++) {
+            replaced += pending_slots[PENDING_SLOT_JOINT(j)].pending;
+            pending_slots[PENDING_SLOT_JOINT(j)].pending = false;
+            atomic_fetch_add(&pending_generation[PENDING_SLOT_JOINT(j)], 1);
+        }
+    }
+    replaced += pending_slots[index].pending;
+    pending_slots[index].request = *request;
+    pending_slots[index].request.generation = atomic_fetch_add(&pending_generation[index], 1) + 1;
+    pending_slots[index].pending = true;
+    portEXIT_CRITICAL(&pending_lock);
+    return replaced;
+}
+
+// Drop every unsent joint move. Returns how many were dropped; their callbacks are not called.
+static uint32_t pending_slot_flush_motion(void)
+{
+    uint32_t flushed = 0;
+
+    portENTER_CRITICAL(&pending_lock);
+    for (int j = ROBOT_ARM_JOINT_BASE; j <= ROBOT_ARM_JOINT_GRIPPER; j++) {
+        flushed += pending_slots[PENDING_SLOT_JOINT(j)].pending;
+        pending_slots[PENDING_SLOT_JOINT(j)].pending = false;
+    }
+    flushed += pending_slots[PENDING_SLOT_JOINTS].pending;
+    pending_slots[PENDING_SLOT_JOINTS].pending = false;
+    portEXIT_CRITICAL(&pending_lock);
+    return flushed;
+}
+
+// Take the next waiting request (comm task only). The all-joint slot always goes first; the
+// others are visited round-robin so a busy joint cannot starve the rest while sends are paced.
+static bool pending_slot_take_next(robot_arm_request_t *request)
+{
+    bool pending = false;
+
+    portENTER_CRITICAL(&pending_lock);
+    if (pending_slots[PENDING_SLOT_JOINTS].pending) {
+        *request = pending_slots[PENDING_SLOT_JOINTS].request;
+        pending_slots[PENDING_SLOT_JOINTS].pending = false;
+        pending = true;
+    }
+    for (uint32_t n = 0; n < PENDING_SLOT_COUNT - 1 && !pending; n++) {
+        uint32_t index = 1 + (pending_next + n) % (PENDING_SLOT_COUNT - 1);
+        if (pending_slots[index].pending) {
+            *request = pending_slots[index].request;
+            pending_slots[index].pending = false;
+            pending_next = index % (PENDING_SLOT_COUNT - 1);
+            pending = true;
+        }
+    }
+    portEXIT_CRITICAL(&pending_lock);
+    return pending;
+}
+
+static bool pending_slot_any(void)
+{
+    bool pending = false;
+
+    portENTER_CRITICAL(&pending_lock);
+    for (int i = 0; i < PENDING_SLOT_COUNT && !pending; i++) {
+        pending = pending_slots[i].pending;
+    }
+    portEXIT_CRITICAL(&pending_lock);
+    return pending;
+}
+
+// Feed one send result to the latency stats and the rate controller (comm task only). A send
+// that needed a resend counts as a loss, and its time is no round-trip sample.
+static void record_result(robot_arm_cmd_type_t type, int64_t queue_us, int64_t start_us, robot_arm_comm_status_t result,
+                          const robot_arm_send_limits_t *limits)
+{
+    int64_t now_us = esp_timer_get_time();
+    robot_arm_stats_record(type, queue_us, now_us - start_us, result);
+    if (result != ROBOT_ARM_COMM_NOT_CONNECTED && transports[atomic_load(&active_transport_kind)]->needs_wifi) {
+        robot_arm_stats_record_radio(wifi_power_save_active() ? ROBOT_ARM_RADIO_POWER_SAVE : ROBOT_ARM_RADIO_AWAKE,
+                                     now_us - start_us);
+    }
+
+    // Nothing went on the wire without a link, so it says nothing about the link's capacity
+    if (result != ROBOT_ARM_COMM_NOT_CONNECTED) {
+        portENTER_CRITICAL(&rate_lock);
+        robot_arm_rate_on_result(&send_rate, now_us, (uint32_t)(now_us - start_us),
+                                 result == ROBOT_ARM_COMM_OK && limits->attempts <= 1);
+        portEXIT_CRITICAL(&rate_lock);
+    }
+}
+
+// Pending slot of a request; timed moves bypass the slots and go through the ordered queue
+static int request_slot(const robot_arm_request_t *request)
+{
+    return request->timed ? -1 : pending_slot_index(&request->cmd);
+}
+
+// A request in flight is pointless once a stop or home outranked it, or a newer target for its
+// pending slot was stored (an all-joint move supersedes every single-joint one). Any task may
+// store; only the comm task asks.
+static bool request_superseded(const void *context)
+{
+    const robot_arm_request_t *request = (const robot_arm_request_t *)context;
+    if (is_motion_command(&request->cmd) && request->epoch != atomic_load(&safety_epoch)) {
+        return true;
+    }
+    int slot = request_slot(request);
+    return slot >= 0 && atomic_load(&pending_generation[slot]) != request->generation;
+}
+
+// Time limits of one send by command class (comm and priority tasks)
+static void send_limits_init(robot_arm_send_limits_t *limits, uint32_t budget_ms, const robot_arm_request_t *request)
+{
+    portENTER_CRITICAL(&rate_lock);
+    uint32_t rto_us = robot_arm_rate_rto_us(&send_rate, RTO_MIN_MS * 1000, budget_ms * 1000);
+    portEXIT_CRITICAL(&rate_lock);
+
+    limits->timeout_ms = (rto_us + 999) / 1000;
+    limits->budget_ms = budget_ms;
+    limits->superseded = request ? request_superseded : NULL;
+    limits->context = request;
+    limits->attempts = 0;
+}
+
+// Send one request and report the result to its owner (comm task only)
+static void dispatch_request(const robot_arm_request_t *request)
+{
+    // A stop or home submitted after this move outranks it; the move must not follow the stop
+    if (is_motion_command(&request->cmd) && request->epoch != atomic_load(&safety_epoch)) {
+        atomic_fetch_add(&comm_flushed, 1);
+        if (request->done_cb) {
+            request->done_cb(&request->cmd, ROBOT_ARM_COMM_ERROR, request->user_data);
+        }
+        return;
+    }
+
+    robot_arm_send_limits_t limits;
+    bool move = request->timed || request_slot(request) >= 0;
+    send_limits_init(&limits, move ? MOVE_BUDGET_MS : ORDERED_BUDGET_MS, request);
+
+    int64_t start_us = esp_timer_get_time();
+    robot_arm_comm_status_t result = execute_command(&request->cmd, &limits);
+    record_result(request->cmd.type, start_us - request->submit_us, start_us, result, &limits);
+
+    if (result == ROBOT_ARM_COMM_OK && request->cmd.type == ROBOT_ARM_CMD_MOVE_JOINTS) {
+        portENTER_CRITICAL(&commanded_lock);
+        memcpy(commanded_radians, request->cmd.joints.radians, sizeof(commanded_radians));
+        portEXIT_CRITICAL(&commanded_lock);
+    } else if (result == ROBOT_ARM_COMM_OK && request->cmd.type == ROBOT_ARM_CMD_MOVE_JOINT &&
+               request->cmd.move.joint >= ROBOT_ARM_JOINT_BASE && request->cmd.move.joint <= ROBOT_ARM_JOINT_GRIPPER) {
+        portENTER_CRITICAL(&commanded_lock);
+        commanded_radians[request->cmd.move.joint - ROBOT_ARM_JOINT_BASE] = request->cmd.move.radians;
+        portEXIT_CRITICAL(&commanded_lock);
+    }
+    set_comm_status(result);
+    if (request->done_cb) {
+        request->done_cb(&request->cmd, result, request->user_data);
+    }
+}
+
+// Encode and send a priority command on the lane's own connection (priority task only).
+// Over UART there is no second link, but its sends are single atomic writes and never wait
+// behind a reply, so the priority task shares it.
+static robot_arm_comm_status_t execute_priority_command(const robot_arm_cmd_t *cmd)
+{
     if (!robot_initialized) {
-        ESP_LOGW(ROBOT_TAG, "Robot arm not initialized");
         return ROBOT_ARM_COMM_NOT_CONNECTED;
     }
 
-    // URL encode the JSON data
-    char encoded_json[512];
-    char url[640];
-    
-    // Simple URL encoding for the JSON string
-    int j = 0;
-    for (int i = 0; json_data[i] != '\0' && j < sizeof(encoded_json) - 4; i++) {
-        if (json_data[i] == ' ') {
-            encoded_json[j++] = '+';
-        } else if (json_data[i] == '{' || json_data[i] == '}' || json_data[i] == '"' || 
-                   json_data[i] == ':' || json_data[i] == ',') {
-            sprintf(&encoded_json[j], "%%%02X", (unsigned char)json_data[i]);
-            j += 3;
-        } else {
-            encoded_json[j++] = json_data[i];
-        }
-    }
-    encoded_json[j] = '\0';
-
-    // Build the complete URL with encoded JSON parameter
-    snprintf(url, sizeof(url), "http://%s/js?json=%s", robot_ip, encoded_json);
-    
-    ESP_LOGI(ROBOT_TAG, "Sending command: %s", json_data);
-    ESP_LOGD(ROBOT_TAG, "Full URL: %s", url);
-
-    // Reset response buffer
-    http_response_len = 0;
-    memset(http_response_buffer, 0, HTTP_BUFFER_SIZE);
-
-    // Configure HTTP client
-    esp_http_client_config_t config = {
-        .url = url,
-        .event_handler = http_event_handler,
-        .timeout_ms = 5000,
-        .buffer_size = HTTP_BUFFER_SIZE,
-    };
+    const robot_arm_transport_t *transport = &robot_arm_transport_uart;
+    if (atomic_load(&active_transport_kind) != ROBOT_ARM_TRANSPORT_UART) {
+        if (!wifi_is_connected()) {
+            return ROBOT_ARM_COMM_NOT_CONNECTED;
+        }
+        transport = &robot_arm_transport_http_priority;
+        if (atomic_exchange(&priority_reset_pending, false) && priority_session_open) {
+            transport->close();
+            priority_session_open = false;
+        }
+        if (!priority_session_open) {
+            priority_session_open = transport->open(robot_ip);
+            if (!priority_session_open) {
+                return ROBOT_ARM_COMM_ERROR;
+            }
+        }
+    }
 
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    if (!client) {
-        ESP_LOGE(ROBOT_TAG, "Failed to initialize HTTP client");
+    char buffer[COMMAND_BUFFER_SIZE];
+    if (robot_arm_encode_command(cmd, transport->payload, buffer, sizeof(buffer)) < 0) {
+        ESP_LOGE(ROBOT_TAG, "Could not encode priority command type %d", cmd->type);
         return ROBOT_ARM_COMM_ERROR;
     }
+    // The round trip the comm task measured is the best guess for this connection too
+    robot_arm_send_limits_t limits;
+    send_limits_init(&limits, PRIORITY_BUDGET_MS, NULL);
+    return transport->send(buffer, &limits);
+}
 
-    // Perform HTTP GET request
-    esp_err_t err = esp_http_client_perform(client);
-    int status_code = esp_http_client_get_status_code(client);
+// Priority worker: sends safety commands the moment they are submitted
+static void robot_arm_priority_task(void *arg)
+{
+    (void)arg;
+    robot_arm_request_t request;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
-    esp_http_client_cleanup(client);
+        while (robot_arm_queue_pop(&priority_queue, &request)) {
+            int64_t start_us = esp_timer_get_time();
+            uint32_t dispatch_us = (uint32_t)(start_us - request.submit_us);
 
-    if (err != ESP_OK) {
-        ESP_LOGE(ROBOT_TAG, "HTTP request failed: %s", esp_err_to_name(err));
-        return ROBOT_ARM_COMM_ERROR;
+            unsigned int max = atomic_load(&priority_max_dispatch_us);
+            while (dispatch_us > max && !atomic_compare_exchange_weak(&priority_max_dispatch_us, &max, dispatch_us)) {
+            }
+            if (dispatch_us > PRIORITY_DEADLINE_US) {
+                atomic_fetch_add(&priority_deadline_misses, 1);
+                ESP_LOGW(ROBOT_TAG, "Priority command dispatched after %lu us", (unsigned long)dispatch_us);
+            }
+
+            robot_arm_comm_status_t result = execute_priority_command(&request.cmd);
+            robot_arm_stats_record(request.cmd.type, dispatch_us, esp_timer_get_time() - start_us, result);
+            atomic_fetch_add(&priority_sent, 1);
+            set_comm_status(result);
+            if (request.done_cb) {
+                request.done_cb(&request.cmd, result, request.user_data);
+            }
+        }
     }
+}
 
-    if (status_code != 200) {
-        ESP_LOGE(ROBOT_TAG, "HTTP request failed with status code: %d", status_code);
-        return ROBOT_ARM_COMM_ERROR;
+// Cap the send rate by the WiFi link quality (comm task only)
+static void apply_link_quality(void)
+{
+    uint8_t quality = transports[atomic_load(&active_transport_kind)]->needs_wifi ? wifi_get_link_quality() : 100;
+    if (quality == WIFI_LINK_QUALITY_UNKNOWN) {
+        quality = 100;   // Not sampled since the link came up: no evidence to slow down for
     }
+    if (quality == applied_link_quality) {
+        return;
+    }
+    applied_link_quality = quality;
 
-    ESP_LOGI(ROBOT_TAG, "Robot command sent successfully");
-    return ROBOT_ARM_COMM_OK;
+    portENTER_CRITICAL(&rate_lock);
+    robot_arm_rate_set_ceiling(&send_rate, RATE_MIN_HZ + (RATE_MAX_HZ - RATE_MIN_HZ) * quality / 100.0f);
+    portEXIT_CRITICAL(&rate_lock);
+}
+
+// Comm worker: drains the request queue and pending slots so callers never block on the network
+static void robot_arm_comm_task(void *arg)
+{
+    (void)arg;
+    ESP_LOGI(ROBOT_TAG, "Robot comm task started on core %d", xPortGetCoreID());
+
+    robot_arm_request_t request;
+    TickType_t next_poll = xTaskGetTickCount();
+    int64_t next_paced_us = 0;
+    while (1) {
+        // Sleep until a command arrives, the next feedback poll is due, or pacing lets the
+        // next pending command go
+        TickType_t wait = portMAX_DELAY;
+        if (FEEDBACK_POLL_MS > 0) {
+            TickType_t now = xTaskGetTickCount();
+            wait = ((int32_t)(next_poll - now) > 0) ? (next_poll - now) : 0;
+        }
+        if (pending_slot_any()) {
+            int64_t until_us = next_paced_us - esp_timer_get_time();
+            TickType_t paced = (until_us > 0) ? (TickType_t)((until_us + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000)) : 0;
+            wait = (paced < wait) ? paced : wait;
+        }
+        ulTaskNotifyTake(pdTRUE, wait);
+
+        if (FEEDBACK_POLL_MS > 0 && (int32_t)(xTaskGetTickCount() - next_poll) >= 0) {
+            next_poll = xTaskGetTickCount() + pdMS_TO_TICKS(FEEDBACK_POLL_MS);
+            if (robot_arm_is_connected()) {
+                robot_arm_cmd_t poll = { .type = ROBOT_ARM_CMD_FEEDBACK };
+                robot_arm_send_limits_t limits;
+                send_limits_init(&limits, FEEDBACK_POLL_MS, NULL);
+                limits.budget_ms = limits.timeout_ms;
+                int64_t start_us = esp_timer_get_time();
+                record_result(poll.type, 0, start_us, execute_command(&poll, &limits), &limits);
+            }
+        }
+
+        // Ordered commands (torque, home, timed moves) go out as soon as they arrive
+        while (robot_arm_queue_pop(&comm_queue, &request)) {
+            dispatch_request(&request);
+        }
+
+        apply_link_quality();
+
+        // Then the latest target of each joint, no faster than the controller allows. Anything
+        // edited meanwhile is merged in its slot, so a slow link sends fewer, larger steps.
+        while (esp_timer_get_time() >= next_paced_us && pending_slot_take_next(&request)) {
+            int64_t start_us = esp_timer_get_time();
+            dispatch_request(&request);
+
+            portENTER_CRITICAL(&rate_lock);
+            uint32_t interval_us = robot_arm_rate_interval_us(&send_rate);
+            portEXIT_CRITICAL(&rate_lock);
+            next_paced_us = start_us + interval_us;
+
+            while (robot_arm_queue_pop(&comm_queue, &request)) {
+                dispatch_request(&request);
+            }
+        }
+    }
 }
 
 robot_arm_comm_status_t robot_arm_init(const char* robot_ip_addr)
@@ -143,9 +584,42 @@ robot_arm_comm_status_t robot_arm_init(const char* robot_ip_addr)
 
     strncpy(robot_ip, robot_ip_addr, sizeof(robot_ip) - 1);
     robot_ip[sizeof(robot_ip) - 1] = '\0';
-    
+
+    // Drop any session to a previous address; the comm task reconnects on the next command
+    atomic_store(&session_reset_pending, true);
+    atomic_store(&priority_reset_pending, true);
+
+    if (!comm_task_handle) {
+        if (!robot_arm_queue_init(&comm_queue, comm_queue_slots, COMM_QUEUE_LENGTH)) {
+            ESP_LOGE(ROBOT_TAG, "Comm queue length must be a power of two");
+            return ROBOT_ARM_COMM_ERROR;
+        }
+        robot_arm_rate_init(&send_rate, RATE_MIN_HZ, RATE_MAX_HZ);
+        BaseType_t core_id = (COMM_TASK_CORE < 0) ? tskNO_AFFINITY : COMM_TASK_CORE;
+        BaseType_t ret = xTaskCreatePinnedToCore(robot_arm_comm_task, "robot_comm", COMM_TASK_STACK_SIZE, NULL,
+                                                 COMM_TASK_PRIORITY, &comm_task_handle, core_id);
+        if (ret != pdPASS) {
+            ESP_LOGE(ROBOT_TAG, "Failed to create robot comm task");
+            comm_task_handle = NULL;
+            return ROBOT_ARM_COMM_ERROR;
+        }
+    }
+
+    if (!priority_task_handle) {
+        robot_arm_queue_init(&priority_queue, priority_queue_slots, PRIORITY_QUEUE_LENGTH);
+        BaseType_t core_id = (COMM_TASK_CORE < 0) ? tskNO_AFFINITY : COMM_TASK_CORE;
+        BaseType_t ret = xTaskCreatePinnedToCore(robot_arm_priority_task, "robot_prio", PRIORITY_TASK_STACK_SIZE, NULL,
+                                                 PRIORITY_TASK_PRIORITY, &priority_task_handle, core_id);
+        if (ret != pdPASS) {
+            ESP_LOGE(ROBOT_TAG, "Failed to create robot priority task");
+            priority_task_handle = NULL;
+            return ROBOT_ARM_COMM_ERROR;
+        }
+    }
+
     robot_initialized = true;
-    comm_status = ROBOT_ARM_COMM_OK;
+    set_comm_status(ROBOT_ARM_COMM_OK);
+    status_bus_publish(STATUS_TOPIC_TRANSPORT, atomic_load(&active_transport_kind));
     
     ESP_LOGI(ROBOT_TAG, "Robot arm communication initialized for IP: %s", robot_ip);
     return ROBOT_ARM_COMM_OK;
@@ -156,31 +630,115 @@ robot_arm_comm_status_t robot_arm_get_status(void)
     return comm_status;
 }
 
+static robot_arm_comm_status_t submit_request(const robot_arm_cmd_t *cmd, robot_arm_done_cb_t done_cb, void *user_data,
+                                              bool timed)
+{
+    if (!cmd) {
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    if (!robot_initialized || !comm_task_handle || !priority_task_handle) {
+        return ROBOT_ARM_COMM_NOT_CONNECTED;
+    }
+
+    // Commands mean the arm is being operated: get the radio out of power save for low latency
+    if (transports[atomic_load(&active_transport_kind)]->needs_wifi) {
+        wifi_note_activity();
+    }
+
+    robot_arm_request_t request = {
+        .cmd = *cmd,
+        .done_cb = done_cb,
+        .user_data = user_data,
+        .submit_us = esp_timer_get_time(),
+        .timed = timed && pending_slot_index(cmd) >= 0,
+    };
+
+    if (is_priority_command(cmd)) {
+        // Supersede every move submitted so far, then hand the command straight to the lane.
+        // Halt before the epoch moves on: a move that reads the new epoch then also sees the halt.
+        if (cmd->type == ROBOT_ARM_CMD_TORQUE) {
+            atomic_store(&motion_halted, true);
+        }
+        atomic_fetch_add(&safety_epoch, 1);
+        uint32_t flushed = pending_slot_flush_motion();
+        if (flushed) {
+            atomic_fetch_add(&comm_flushed, flushed);
+        }
+
+        request.epoch = atomic_load(&safety_epoch);
+        if (!robot_arm_queue_push(&priority_queue, &request)) {
+            atomic_fetch_add(&comm_dropped, 1);
+            ESP_LOGE(ROBOT_TAG, "Priority queue full, dropping command type %d", cmd->type);
+            return ROBOT_ARM_COMM_ERROR;
+        }
+        xTaskNotifyGive(priority_task_handle);
+        return ROBOT_ARM_COMM_OK;
+    }
+
+    // Stamp the epoch before looking at the halt: a torque-off racing this submit either already
+    // halted motion, or bumps the epoch after the stamp and the move is discarded as stale
+    request.epoch = atomic_load(&safety_epoch);
+    if (is_motion_command(cmd)) {
+        if (cmd->type == ROBOT_ARM_CMD_TORQUE) {
+            atomic_store(&motion_halted, false);
+        } else if (atomic_load(&motion_halted)) {
+            ESP_LOGD(ROBOT_TAG, "Motion halted by torque-off, rejecting command type %d", cmd->type);
+            return ROBOT_ARM_COMM_ERROR;
+        }
+    }
+
+    int slot = request_slot(&request);
+    if (slot >= 0) {
+        uint32_t replaced = pending_slot_store(slot, &request);
+        if (replaced) {
+            atomic_fetch_add(&comm_coalesced, replaced);
+        }
+    } else if (!robot_arm_queue_push(&comm_queue, &request)) {
+        atomic_fetch_add(&comm_dropped, 1);
+        ESP_LOGW(ROBOT_TAG, "Command queue full, dropping command type %d", cmd->type);
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    xTaskNotifyGive(comm_task_handle);
+    return ROBOT_ARM_COMM_OK;
+}
+
+robot_arm_comm_status_t robot_arm_submit(const robot_arm_cmd_t *cmd, robot_arm_done_cb_t done_cb, void *user_data)
+{
+    return submit_request(cmd, done_cb, user_data, false);
+}
+
+robot_arm_comm_status_t robot_arm_submit_timed(const robot_arm_cmd_t *cmd, robot_arm_done_cb_t done_cb, void *user_data)
+{
+    return submit_request(cmd, done_cb, user_data, true);
+}
+
 robot_arm_comm_status_t robot_arm_enable_torque(void)
 {
-    char json_cmd[] = "{\"T\":210,\"cmd\":1}";
-    return send_robot_command_json(json_cmd);
+    robot_arm_cmd_t cmd = { .type = ROBOT_ARM_CMD_TORQUE, .torque_on = true };
+    return robot_arm_submit(&cmd, NULL, NULL);
 }
 
 robot_arm_comm_status_t robot_arm_disable_torque(void)
 {
-    char json_cmd[] = "{\"T\":210,\"cmd\":0}";
-    return send_robot_command_json(json_cmd);
+    robot_arm_cmd_t cmd = { .type = ROBOT_ARM_CMD_TORQUE, .torque_on = false };
+    return robot_arm_submit(&cmd, NULL, NULL);
 }
 
 robot_arm_comm_status_t robot_arm_home(void)
 {
-    char json_cmd[] = "{\"T\":100}";
-    return send_robot_command_json(json_cmd);
+    robot_arm_cmd_t cmd = { .type = ROBOT_ARM_CMD_HOME };
+    return robot_arm_submit(&cmd, NULL, NULL);
 }
 
 robot_arm_comm_status_t robot_arm_move_joint(robot_arm_joint_t joint, float radians, int speed, int acceleration)
 {
-    char json_cmd[128];
-    snprintf(json_cmd, sizeof(json_cmd), 
-             "{\"T\":101,\"joint\":%d,\"rad\":%.2f,\"spd\":%d,\"acc\":%d}", 
-             joint, radians, speed, acceleration);
-    return send_robot_command_json(json_cmd);
+    robot_arm_cmd_t cmd = {
+        .type = ROBOT_ARM_CMD_MOVE_JOINT,
+        .move = { .joint = joint, .radians = radians, .speed = speed, .acceleration = acceleration },
+    };
+    return robot_arm_submit(&cmd, NULL, NULL);
 }
 
 robot_arm_comm_status_t robot_arm_move_base(float radians, int speed, int acceleration)
@@ -203,29 +761,135 @@ robot_arm_comm_status_t robot_arm_move_gripper(float radians, int speed, int acc
     return robot_arm_move_joint(ROBOT_ARM_JOINT_GRIPPER, radians, speed, acceleration);
 }
 
+robot_arm_comm_status_t robot_arm_move_joints(const float radians[ROBOT_ARM_JOINT_COUNT], int speed, int acceleration)
+{
+    if (!radians) {
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    robot_arm_cmd_t cmd = {
+        .type = ROBOT_ARM_CMD_MOVE_JOINTS,
+        .joints = { .speed = speed, .acceleration = acceleration },
+    };
+    memcpy(cmd.joints.radians, radians, sizeof(cmd.joints.radians));
+    return robot_arm_submit(&cmd, NULL, NULL);
+}
+
 robot_arm_comm_status_t robot_arm_led_on(void)
 {
-    char json_cmd[] = "{\"T\":114,\"led\":255}";
-    return send_robot_command_json(json_cmd);
+    return robot_arm_led_set(255);
 }
 
 robot_arm_comm_status_t robot_arm_led_off(void)
 {
-    char json_cmd[] = "{\"T\":114,\"led\":0}";
-    return send_robot_command_json(json_cmd);
+    return robot_arm_led_set(0);
 }
 
 robot_arm_comm_status_t robot_arm_led_set(int brightness)
 {
     if (brightness < 0) brightness = 0;
     if (brightness > 255) brightness = 255;
-    
-    char json_cmd[64];
-    snprintf(json_cmd, sizeof(json_cmd), "{\"T\":114,\"led\":%d}", brightness);
-    return send_robot_command_json(json_cmd);
+
+    robot_arm_cmd_t cmd = { .type = ROBOT_ARM_CMD_LED, .led = brightness };
+    return robot_arm_submit(&cmd, NULL, NULL);
 }
 
 bool robot_arm_is_connected(void)
 {
-    return robot_initialized && wifi_is_connected();
-} 
\ No newline at end of file
+    if (!robot_initialized) {
+        return false;
+    }
+    return !transports[atomic_load(&active_transport_kind)]->needs_wifi || wifi_is_connected();
+}
+
+void robot_arm_get_session_stats(robot_arm_session_stats_t *stats)
+{
+    if (stats) {
+        transports[atomic_load(&active_transport_kind)]->get_stats(stats);
+    }
+}
+
+void robot_arm_set_transport(robot_arm_transport_kind_t transport)
+{
+    if (transport < ROBOT_ARM_TRANSPORT_HTTP || transport > ROBOT_ARM_TRANSPORT_UART) {
+        ESP_LOGE(ROBOT_TAG, "Invalid transport %d", transport);
+        return;
+    }
+
+    // The comm task switches over before its next command
+    atomic_store(&requested_transport, transport);
+    if (comm_task_handle) {
+        xTaskNotifyGive(comm_task_handle);
+    }
+}
+
+robot_arm_transport_kind_t robot_arm_get_transport(void)
+{
+    return (robot_arm_transport_kind_t)atomic_load(&active_transport_kind);
+}
+
+uint32_t robot_arm_get_transport_fallbacks(void)
+{
+    return atomic_load(&transport_fallbacks);
+}
+
+uint32_t robot_arm_get_dropped_count(void)
+{
+    return atomic_load(&comm_dropped);
+}
+
+uint32_t robot_arm_get_coalesced_count(void)
+{
+    return atomic_load(&comm_coalesced);
+}
+
+void robot_arm_get_rate_state(robot_arm_rate_state_t *state)
+{
+    if (!state) {
+        return;
+    }
+
+    portENTER_CRITICAL(&rate_lock);
+    state->rate_hz = send_rate.rate_hz;
+    state->ceiling_hz = send_rate.ceiling_hz;
+    state->interval_us = robot_arm_rate_interval_us(&send_rate);
+    state->srtt_us = send_rate.srtt_us;
+    state->min_rtt_us = (send_rate.min_rtt_us == UINT32_MAX) ? 0 : send_rate.min_rtt_us;
+    state->congestion_events = send_rate.congestion_events;
+    portEXIT_CRITICAL(&rate_lock);
+}
+
+bool robot_arm_is_motion_halted(void)
+{
+    return atomic_load(&motion_halted);
+}
+
+void robot_arm_get_priority_stats(robot_arm_priority_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+
+    stats->sent = atomic_load(&priority_sent);
+    stats->max_dispatch_us = atomic_load(&priority_max_dispatch_us);
+    stats->deadline_misses = atomic_load(&priority_deadline_misses);
+    stats->flushed = atomic_load(&comm_flushed);
+}
+
+bool robot_arm_get_commanded_joints(float radians[ROBOT_ARM_JOINT_COUNT])
+{
+    if (!radians) {
+        return false;
+    }
+
+    portENTER_CRITICAL(&commanded_lock);
+    memcpy(radians, commanded_radians, sizeof(commanded_radians));
+    portEXIT_CRITICAL(&commanded_lock);
+
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        if (isnan(radians[i])) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -2,6 +2,7 @@
 #define ROBOT_ARM_COMM_H
 
 #include <stdbool.h>
+#include <stdint.h>
 
 // Robot arm communication status
 typedef enum {
@@ -19,10 +20,96 @@ typedef enum {
     ROBOT_ARM_JOINT_GRIPPER = 4    // Joint 4 - Gripper tilt
 } robot_arm_joint_t;
 
+#define ROBOT_ARM_JOINT_COUNT 4
+
+// Transports that can carry commands to the robot
+typedef enum {
+    ROBOT_ARM_TRANSPORT_HTTP,   // HTTP GET /js?json=<url-encoded json> on a keep-alive session
+    ROBOT_ARM_TRANSPORT_WS,     // JSON text frames streamed on one WebSocket
+    ROBOT_ARM_TRANSPORT_UART    // Newline-delimited JSON on the robot's serial port
+} robot_arm_transport_kind_t;
+
+// Command kinds carried through the asynchronous comm queue
+typedef enum {
+    ROBOT_ARM_CMD_MOVE_JOINT,   // T:101 single joint move
+    ROBOT_ARM_CMD_MOVE_JOINTS,  // T:102 all joints in one command
+    ROBOT_ARM_CMD_LED,          // T:114 LED brightness
+    ROBOT_ARM_CMD_TORQUE,       // T:210 torque on/off
+    ROBOT_ARM_CMD_HOME,         // T:100 move to home pose
+    ROBOT_ARM_CMD_FEEDBACK      // T:105 joint feedback request (reply parsed by robot_arm_feedback)
+} robot_arm_cmd_type_t;
+
+#define ROBOT_ARM_CMD_TYPE_COUNT (ROBOT_ARM_CMD_FEEDBACK + 1)
+
+// A robot command, encoded to JSON by the comm task at send time
+typedef struct {
+    robot_arm_cmd_type_t type;
+    union {
+        struct {
+            robot_arm_joint_t joint;
+            float radians;
+            int speed;
+            int acceleration;
+        } move;                 // ROBOT_ARM_CMD_MOVE_JOINT
+        struct {
+            float radians[ROBOT_ARM_JOINT_COUNT];  // Indexed by joint - ROBOT_ARM_JOINT_BASE
+            int speed;
+            int acceleration;
+        } joints;               // ROBOT_ARM_CMD_MOVE_JOINTS
+        int led;                // ROBOT_ARM_CMD_LED, 0-255
+        bool torque_on;         // ROBOT_ARM_CMD_TORQUE
+    };
+} robot_arm_cmd_t;
+
+// Completion callback, invoked on the comm task once a command has been sent (or failed)
+typedef void (*robot_arm_done_cb_t)(const robot_arm_cmd_t *cmd, robot_arm_comm_status_t status, void *user_data);
+
+// Transport session counters
+typedef struct {
+    uint32_t requests;     // Commands sent over the session
+    uint32_t reused;       // Commands that went out on an already-open connection
+    uint32_t reconnects;   // Times the session was torn down and re-opened after an error
+    uint32_t failures;     // Commands that failed after the reconnect attempt
+    uint32_t cancelled;    // Commands given up before their time was spent because a newer one superseded them
+} robot_arm_session_stats_t;
+
+// Priority lane counters
+typedef struct {
+    uint32_t sent;              // Torque-off / home commands sent on the lane
+    uint32_t max_dispatch_us;   // Worst time from submit to the start of the send
+    uint32_t deadline_misses;   // Dispatches slower than CONFIG_ROBOT_ARM_PRIORITY_DEADLINE_MS
+    uint32_t flushed;           // Unsent moves dropped because a stop or home superseded them
+} robot_arm_priority_stats_t;
+
+// Adaptive send-rate controller state (paces coalesced joint/LED commands)
+typedef struct {
+    float rate_hz;               // Commands per second currently allowed
+    float ceiling_hz;            // Cap from the WiFi link quality
+    uint32_t interval_us;        // Minimum spacing between them
+    uint32_t srtt_us;            // Smoothed round-trip time
+    uint32_t min_rtt_us;         // Uncongested baseline RTT
+    uint32_t congestion_events;  // Times the rate was halved on errors or RTT inflation
+} robot_arm_rate_state_t;
+
 // Function declarations
 robot_arm_comm_status_t robot_arm_init(const char* robot_ip);
 robot_arm_comm_status_t robot_arm_get_status(void);
 
+// Queue a command for the comm task without blocking. Returns ROBOT_ARM_COMM_OK once queued,
+// ROBOT_ARM_COMM_ERROR if the queue is full. The commands below are thin wrappers around this,
+// so their return value reports queuing, not delivery.
+// Joint moves and LED commands are coalesced latest-wins per joint: a newer one replaces an
+// unsent one, and the replaced command's callback is never called.
+// Torque-off and home take a priority lane with its own task and connection: they are sent
+// at once, even while a move is in flight, and every move submitted before them is dropped.
+// After torque-off, moves are rejected until robot_arm_enable_torque().
+robot_arm_comm_status_t robot_arm_submit(const robot_arm_cmd_t *cmd, robot_arm_done_cb_t done_cb, void *user_data);
+// Like robot_arm_submit(), but a joint move is queued in order and sent as soon as the comm task
+// gets to it: never merged in a pending slot or held back by the pacer. For callers that time
+// their moves themselves (pose playback, trajectory streaming). Torque-off and home still drop
+// it if it is unsent.
+robot_arm_comm_status_t robot_arm_submit_timed(const robot_arm_cmd_t *cmd, robot_arm_done_cb_t done_cb, void *user_data);
+
 // Basic control commands
 robot_arm_comm_status_t robot_arm_enable_torque(void);
 robot_arm_comm_status_t robot_arm_disable_torque(void);
@@ -34,13 +121,29 @@ robot_arm_comm_status_t robot_arm_move_base(float radians, int speed, int accele
 robot_arm_comm_status_t robot_arm_move_shoulder(float radians, int speed, int acceleration);
 robot_arm_comm_status_t robot_arm_move_elbow(float radians, int speed, int acceleration);
 robot_arm_comm_status_t robot_arm_move_gripper(float radians, int speed, int acceleration);
+// Move base/shoulder/elbow/gripper together in one request with a shared speed and acceleration
+robot_arm_comm_status_t robot_arm_move_joints(const float radians[ROBOT_ARM_JOINT_COUNT], int speed, int acceleration);
 
 // LED control
 robot_arm_comm_status_t robot_arm_led_on(void);
 robot_arm_comm_status_t robot_arm_led_off(void);
 robot_arm_comm_status_t robot_arm_led_set(int brightness); // 0-255
 
+// Transport selection; takes effect on the next command. If the selected transport cannot be
+// opened or a send fails, commands fall back to HTTP until the next selection or robot_arm_init().
+void robot_arm_set_transport(robot_arm_transport_kind_t transport);
+robot_arm_transport_kind_t robot_arm_get_transport(void);  // Transport currently carrying commands
+uint32_t robot_arm_get_transport_fallbacks(void);
+
 // Connection status
 bool robot_arm_is_connected(void);
+void robot_arm_get_session_stats(robot_arm_session_stats_t *stats);  // Counters of the active transport
+uint32_t robot_arm_get_dropped_count(void);    // Commands rejected because the queue was full
+uint32_t robot_arm_get_coalesced_count(void);  // Unsent joint/LED commands replaced by a newer one
+void robot_arm_get_rate_state(robot_arm_rate_state_t *state);
+bool robot_arm_is_motion_halted(void);         // Torque-off seen and torque not yet re-enabled
+void robot_arm_get_priority_stats(robot_arm_priority_stats_t *stats);
+// Last angles the robot accepted per joint (NAN if never commanded); true once all are known
+bool robot_arm_get_commanded_joints(float radians[ROBOT_ARM_JOINT_COUNT]);
 
 #endif // ROBOT_ARM_COMM_H 
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "robot_arm_encode.h"
+#include "robot_arm_json.h"
+
+const char *const robot_arm_encode_joint_keys[ROBOT_ARM_JOINT_COUNT] = { "base", "shoulder", "elbow", "hand" };
+
+// Write the JSON body of a command; returns false for an unknown command type
+static bool write_command(robot_arm_json_writer_t *writer, const robot_arm_cmd_t *cmd)
+{
+    robot_arm_json_begin_object(writer);
+    switch (cmd->type) {
+        case ROBOT_ARM_CMD_MOVE_JOINT:
+            robot_arm_json_int(writer, "T", 101);
+            robot_arm_json_int(writer, "joint", cmd->move.joint);
+            robot_arm_json_fixed(writer, "rad", cmd->move.radians, ROBOT_ARM_RADIAN_DECIMALS);
+            robot_arm_json_int(writer, "spd", cmd->move.speed);
+            robot_arm_json_int(writer, "acc", cmd->move.acceleration);
+            break;
+        case ROBOT_ARM_CMD_MOVE_JOINTS:
+            robot_arm_json_int(writer, "T", 102);
+            for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+                robot_arm_json_fixed(writer, robot_arm_encode_joint_keys[i], cmd->joints.radians[i], ROBOT_ARM_RADIAN_DECIMALS);
+            }
+            robot_arm_json_int(writer, "spd", cmd->joints.speed);
+            robot_arm_json_int(writer, "acc", cmd->joints.acceleration);
+            break;
+        case ROBOT_ARM_CMD_LED:
+            robot_arm_json_int(writer, "T", 114);
+            robot_arm_json_int(writer, "led", cmd->led);
+            break;
+        case ROBOT_ARM_CMD_TORQUE:
+            robot_arm_json_int(writer, "T", 210);
+            robot_arm_json_int(writer, "cmd", cmd->torque_on ? 1 : 0);
+            break;
+        case ROBOT_ARM_CMD_HOME:
+            robot_arm_json_int(writer, "T", 100);
+            break;
+        case ROBOT_ARM_CMD_FEEDBACK:
+            robot_arm_json_int(writer, "T", 105);
+            break;
+        default:
+            return false;
+    }
+    robot_arm_json_end_object(writer);
+    return true;
+}
+
+int robot_arm_encode_command(const robot_arm_cmd_t *cmd, robot_arm_payload_t format, char *out, size_t out_size)
+{
+    robot_arm_json_writer_t writer;
+    bool url_encode = (format == ROBOT_ARM_PAYLOAD_HTTP_PATH);
+
+    // One pass straight into the caller's buffer (equivalent to curl --get --data-urlencode for HTTP)
+    robot_arm_json_init(&writer, out, out_size, url_encode);
+    if (url_encode) {
+        robot_arm_json_raw(&writer, ROBOT_ARM_HTTP_PATH_PREFIX);
+    }
+    if (!write_command(&writer, cmd)) {
+        return -1;
+    }
+    return robot_arm_json_finish(&writer);
+}
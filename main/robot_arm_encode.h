@@ -0,0 +1,22 @@
+#ifndef ROBOT_ARM_ENCODE_H
+#define ROBOT_ARM_ENCODE_H
+
+#include <stddef.h>
+#include "robot_arm_comm.h"
+#include "robot_arm_transport.h"
+
+// Path prefix of every HTTP command request
+#define ROBOT_ARM_HTTP_PATH_PREFIX "/js?json="
+
+// Radians are sent with two decimals
+#define ROBOT_ARM_RADIAN_DECIMALS 2
+
+// Member names of the all-joint move (T:102), indexed by joint - ROBOT_ARM_JOINT_BASE
+extern const char *const robot_arm_encode_joint_keys[ROBOT_ARM_JOINT_COUNT];
+
+// Encode a command in the given wire form directly into out. Returns the length written
+// (excluding the terminator) or -1 if the command is unknown or does not fit; output is
+// never silently truncated.
+int robot_arm_encode_command(const robot_arm_cmd_t *cmd, robot_arm_payload_t format, char *out, size_t out_size);
+
+#endif // ROBOT_ARM_ENCODE_H
@@ -0,0 +1,216 @@
+#include <string.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "robot_arm_feedback.h"
+
+// Reply type of the T:105 status command
+#define FEEDBACK_REPLY_TYPE 1051
+
+// Keys of the T:1051 reply and where each value lands in the snapshot
+typedef struct {
+    const char *key;
+    size_t offset;
+} feedback_field_t;
+
+static const feedback_field_t feedback_fields[] = {
+    { "b",    offsetof(robot_arm_feedback_t, joint_rad[0]) },
+    { "s",    offsetof(robot_arm_feedback_t, joint_rad[1]) },
+    { "e",    offsetof(robot_arm_feedback_t, joint_rad[2]) },
+    { "t",    offsetof(robot_arm_feedback_t, joint_rad[3]) },
+    { "torB", offsetof(robot_arm_feedback_t, joint_load[0]) },
+    { "torS", offsetof(robot_arm_feedback_t, joint_load[1]) },
+    { "torE", offsetof(robot_arm_feedback_t, joint_load[2]) },
+    { "torH", offsetof(robot_arm_feedback_t, joint_load[3]) },
+    { "x",    offsetof(robot_arm_feedback_t, x) },
+    { "y",    offsetof(robot_arm_feedback_t, y) },
+    { "z",    offsetof(robot_arm_feedback_t, z) },
+};
+
+// Seqlock-protected snapshot: readers retry while the sequence is odd or changes under them.
+// Replies can arrive from several tasks (comm task, WebSocket client, UART reader), so writers
+// serialize on a spinlock; readers never lock.
+static robot_arm_feedback_t snapshot;
+static atomic_uint snapshot_seq = 0;
+static portMUX_TYPE writer_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Parse a JSON number starting at *p (no exponent needed for robot replies, but accepted)
+static bool parse_number(const char **p, const char *end, float *out)
+{
+    const char *s = *p;
+    bool negative = false;
+    float value = 0.0f;
+    bool digits = false;
+
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = (*s == '-');
+        s++;
+    }
+    while (s < end && *s >= '0' && *s <= '9') {
+        value = value * 10.0f + (float)(*s - '0');
+        digits = true;
+        s++;
+    }
+    if (s < end && *s == '.') {
+        float scale = 0.1f;
+        s++;
+        while (s < end && *s >= '0' && *s <= '9') {
+            value += (float)(*s - '0') * scale;
+            scale *= 0.1f;
+            digits = true;
+            s++;
+        }
+    }
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        int exponent = 0;
+        bool exp_negative = false;
+        s++;
+        if (s < end && (*s == '-' || *s == '+')) {
+            exp_negative = (*s == '-');
+            s++;
+        }
+        while (s < end && *s >= '0' && *s <= '9') {
+            exponent = exponent * 10 + (*s - '0');
+            s++;
+        }
+        while (exponent-- > 0) {
+            value = exp_negative ? value / 10.0f : value * 10.0f;
+        }
+    }
+
+    *p = s;
+    *out = negative ? -value : value;
+    return digits;
+}
+
+// Skip a non-numeric value (string, literal, or nested container) starting at p
+static const char *skip_value(const char *p, const char *end)
+{
+    if (p < end && *p == '"') {
+        for (p++; p < end && *p != '"'; p++) {
+            if (*p == '\\') {
+                p++;
+            }
+        }
+        return (p < end) ? p + 1 : end;
+    }
+
+    int depth = 0;
+    for (; p < end; p++) {
+        if (*p == '{' || *p == '[') {
+            depth++;
+        } else if (*p == '}' || *p == ']') {
+            if (depth == 0) {
+                return p;
+            }
+            depth--;
+        } else if (*p == ',' && depth == 0) {
+            return p;
+        }
+    }
+    return end;
+}
+
+// Tokenize a flat JSON object in place into a feedback sample. Returns false if it is not a T:1051 reply.
+static bool parse_feedback(const char *data, size_t len, robot_arm_feedback_t *sample)
+{
+    const char *p = data;
+    const char *end = data + len;
+    bool is_feedback = false;
+    uint32_t fields_seen = 0;
+
+    while (p < end) {
+        // Next key
+        while (p < end && *p != '"') {
+            p++;
+        }
+        if (p >= end) {
+            break;
+        }
+        const char *key = ++p;
+        while (p < end && *p != '"') {
+            p++;
+        }
+        if (p >= end) {
+            break;
+        }
+        size_t key_len = (size_t)(p - key);
+        p++;
+
+        // Colon and value
+        while (p < end && (*p == ' ' || *p == ':')) {
+            p++;
+        }
+        if (p >= end) {
+            break;
+        }
+        if (*p != '-' && *p != '+' && (*p < '0' || *p > '9')) {
+            p = skip_value(p, end);
+            continue;
+        }
+
+        float value;
+        if (!parse_number(&p, end, &value)) {
+            continue;
+        }
+
+        if (key_len == 1 && key[0] == 'T') {
+            is_feedback = ((int)value == FEEDBACK_REPLY_TYPE);
+            continue;
+        }
+        for (size_t i = 0; i < sizeof(feedback_fields) / sizeof(feedback_fields[0]); i++) {
+            if (strlen(feedback_fields[i].key) == key_len && memcmp(feedback_fields[i].key, key, key_len) == 0) {
+                *(float *)((uint8_t *)sample + feedback_fields[i].offset) = value;
+                fields_seen |= 1u << i;
+                break;
+            }
+        }
+    }
+
+    // All four joint angles are required; loads and position are best effort
+    return is_feedback && (fields_seen & 0x0F) == 0x0F;
+}
+
+bool robot_arm_feedback_ingest(const char *data, size_t len)
+{
+    if (!data || len == 0) {
+        return false;
+    }
+
+    robot_arm_feedback_t sample;
+    memset(&sample, 0, sizeof(sample));
+    if (!parse_feedback(data, len, &sample)) {
+        return false;
+    }
+    sample.timestamp_us = esp_timer_get_time();
+
+    portENTER_CRITICAL(&writer_lock);
+    unsigned int seq = atomic_load_explicit(&snapshot_seq, memory_order_relaxed);
+    sample.sequence = seq / 2 + 1;
+    atomic_store_explicit(&snapshot_seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    snapshot = sample;
+    atomic_store_explicit(&snapshot_seq, seq + 2, memory_order_release);
+    portEXIT_CRITICAL(&writer_lock);
+    return true;
+}
+
+bool robot_arm_get_feedback(robot_arm_feedback_t *feedback)
+{
+    if (!feedback) {
+        return false;
+    }
+
+    unsigned int before, after;
+    do {
+        before = atomic_load_explicit(&snapshot_seq, memory_order_acquire);
+        if (before == 0) {
+            return false;  // Nothing published yet
+        }
+        *feedback = snapshot;
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&snapshot_seq, memory_order_relaxed);
+    } while ((before & 1) || before != after);
+
+    return true;
+}
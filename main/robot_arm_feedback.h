@@ -0,0 +1,25 @@
+#ifndef ROBOT_ARM_FEEDBACK_H
+#define ROBOT_ARM_FEEDBACK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "robot_arm_comm.h"
+
+// Latest joint feedback reported by the robot (T:1051 reply to the T:105 status command)
+typedef struct {
+    float joint_rad[ROBOT_ARM_JOINT_COUNT];   // Measured angles, indexed by joint - ROBOT_ARM_JOINT_BASE
+    float joint_load[ROBOT_ARM_JOINT_COUNT];  // Servo loads (torB/torS/torE/torH)
+    float x, y, z;                            // End-effector position reported by the robot (mm)
+    int64_t timestamp_us;                     // esp_timer time the reply was parsed
+    uint32_t sequence;                        // Increments with every accepted reply
+} robot_arm_feedback_t;
+
+// Parse a reply received on any transport and publish it if it is joint feedback.
+// Parsing happens in place with no allocation. Returns true if a snapshot was published.
+bool robot_arm_feedback_ingest(const char *data, size_t len);
+
+// Copy the latest snapshot without taking a lock. Returns false until the first reply arrives.
+bool robot_arm_get_feedback(robot_arm_feedback_t *feedback);
+
+#endif // ROBOT_ARM_FEEDBACK_H
@@ -0,0 +1,421 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "robot_arm_fleet.h"
+#include "robot_arm_queue.h"
+#include "robot_arm_encode.h"
+#include "robot_arm_stats.h"
+#include "robot_arm_http_session.h"
+#include "wifi_manager.h"
+
+static const char *FLEET_TAG = "ROBOT_FLEET";
+
+#define FLEET_MAX_ARMS          (CONFIG_ROBOT_ARM_FLEET_MAX_ARMS)
+#define FLEET_QUEUE_LENGTH      16
+#define FLEET_TASK_STACK_SIZE   (CONFIG_ROBOT_ARM_COMM_TASK_STACK_SIZE_KB * 1024)
+#define FLEET_TASK_PRIORITY     (CONFIG_ROBOT_ARM_COMM_TASK_PRIORITY)
+#define FLEET_HTTP_TIMEOUT_MS   5000
+#define BROADCAST_LEAD_US       (CONFIG_ROBOT_ARM_FLEET_BROADCAST_LEAD_MS * 1000)
+#define COMMAND_BUFFER_SIZE     256
+
+// Latest-wins motion slots, as in robot_arm_comm.c: one per joint and one for all-joint moves,
+// which goes first so single-joint edits made after it are applied on top
+#define MOTION_SLOT_JOINTS      0
+#define MOTION_SLOT_JOINT(j)    (1 + (j) - ROBOT_ARM_JOINT_BASE)
+#define MOTION_SLOT_COUNT       (1 + ROBOT_ARM_JOINT_COUNT)
+
+struct robot_arm {
+    int index;
+    atomic_bool ready;                   // Set once the worker runs; other fields are fixed from then on
+    char name[12];
+    TaskHandle_t task;
+    robot_arm_queue_slot_t queue_slots[FLEET_QUEUE_LENGTH];
+    robot_arm_queue_t queue;
+
+    // Latest-wins motion slots
+    robot_arm_request_t motion[MOTION_SLOT_COUNT];
+    bool motion_pending[MOTION_SLOT_COUNT];
+    uint32_t motion_next;                // Round-robin start among the single-joint slots
+    portMUX_TYPE motion_lock;
+
+    robot_arm_http_session_t session;    // Worker task only
+    robot_arm_latency_hist_t latency;
+    atomic_uint sent;
+    atomic_uint failures;
+    atomic_uint timeouts;
+    atomic_uint dropped;
+    atomic_uint coalesced;
+    atomic_uint late_broadcasts;
+};
+
+static robot_arm_t fleet_arms[FLEET_MAX_ARMS];
+static atomic_int fleet_count = 0;       // One past the highest ready slot
+static portMUX_TYPE fleet_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Slots taken by an add, under fleet_lock: two tasks adding arms at once never set up the same
+// slot, and a failed add hands its slot back
+static bool fleet_claimed[FLEET_MAX_ARMS];
+
+// Send start times of the latest broadcast, identified by its release time
+static int64_t broadcast_release_us = 0;
+static int64_t broadcast_first_us = 0;
+static int64_t broadcast_last_us = 0;
+static uint32_t broadcast_count = 0;
+static uint32_t broadcast_max_skew_us = 0;
+
+// Map a move to its motion slot, or -1 if it is queued in order
+static int motion_slot_index(const robot_arm_cmd_t *cmd)
+{
+    if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINT &&
+        cmd->move.joint >= ROBOT_ARM_JOINT_BASE && cmd->move.joint <= ROBOT_ARM_JOINT_GRIPPER) {
+        return MOTION_SLOT_JOINT(cmd->move.joint);
+    }
+    if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINTS) {
+        return MOTION_SLOT_JOINTS;
+    }
+    return -1;
+}
+
+// Note when an arm started sending a broadcast, widening that broadcast's skew
+static void broadcast_note_start(int64_t release_us, int64_t start_us)
+{
+    portENTER_CRITICAL(&fleet_lock);
+    if (release_us == broadcast_release_us) {
+        if (start_us < broadcast_first_us) broadcast_first_us = start_us;
+        if (start_us > broadcast_last_us) broadcast_last_us = start_us;
+        uint32_t skew = (uint32_t)(broadcast_last_us - broadcast_first_us);
+        if (skew > broadcast_max_skew_us) {
+            broadcast_max_skew_us = skew;
+        }
+    }
+    portEXIT_CRITICAL(&fleet_lock);
+}
+
+// Send one request to the arm and report the result (arm worker only)
+static void fleet_dispatch(robot_arm_t *arm, const robot_arm_request_t *request)
+{
+    robot_arm_comm_status_t result;
+    char buffer[COMMAND_BUFFER_SIZE];
+
+    if (!wifi_is_connected()) {
+        result = ROBOT_ARM_COMM_NOT_CONNECTED;
+    } else if (robot_arm_encode_command(&request->cmd, ROBOT_ARM_PAYLOAD_HTTP_PATH, buffer, sizeof(buffer)) < 0) {
+        ESP_LOGE(FLEET_TAG, "%s: could not encode command type %d", arm->name, request->cmd.type);
+        result = ROBOT_ARM_COMM_ERROR;
+    } else {
+        // Broadcasts wait for their shared release tick, already encoded, so every arm's
+        // worker wakes on the same tick and goes straight to the wire
+        if (request->release_us) {
+            int64_t wait_us = request->release_us - esp_timer_get_time();
+            if (wait_us > 0) {
+                vTaskDelay((TickType_t)((wait_us + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000)));
+            }
+        }
+
+        int64_t start_us = esp_timer_get_time();
+        if (request->release_us) {
+            broadcast_note_start(request->release_us, start_us);
+            if (start_us - request->release_us > BROADCAST_LEAD_US) {
+                atomic_fetch_add(&arm->late_broadcasts, 1);
+            }
+        }
+        result = robot_arm_http_session_send(&arm->session, buffer, NULL);
+        robot_arm_latency_record(&arm->latency, esp_timer_get_time() - start_us);
+    }
+
+    atomic_fetch_add(&arm->sent, 1);
+    if (result != ROBOT_ARM_COMM_OK) {
+        atomic_fetch_add(&arm->failures, 1);
+    }
+    if (result == ROBOT_ARM_COMM_TIMEOUT) {
+        atomic_fetch_add(&arm->timeouts, 1);
+    }
+    if (request->done_cb) {
+        request->done_cb(&request->cmd, result, request->user_data);
+    }
+}
+
+// Store a move in its slot, replacing any unsent one. Returns how many unsent moves it
+// superseded: an all-joint move also supersedes every pending single-joint move.
+static uint32_t fleet_store_motion(robot_arm_t *arm, int index, const robot_arm_request_t *request)
+{
+    uint32_t replaced = 0;
+
+    portENTER_CRITICAL(&arm->motion_lock);
+    if (index == MOTION_SLOT_JOINTS) {
+        for (int i = MOTION_SLOT_JOINTS + 1; i < MOTION_SLOT_COUNT; i++) {
+            replaced += arm->motion_pending[i];
+            arm->motion_pending[i] = false;
+        }
+    }
+    replaced += arm->motion_pending[index];
+    arm->motion[index] = *request;
+    arm->motion_pending[index] = true;
+    portEXIT_CRITICAL(&arm->motion_lock);
+    return replaced;
+}
+
+// Drop every unsent move; their callbacks are not called
+static void fleet_flush_motion(robot_arm_t *arm)
+{
+    portENTER_CRITICAL(&arm->motion_lock);
+    for (int i = 0; i < MOTION_SLOT_COUNT; i++) {
+        arm->motion_pending[i] = false;
+    }
+    portEXIT_CRITICAL(&arm->motion_lock);
+}
+
+// Take the next waiting move: the all-joint slot first, then the joints round-robin
+static bool fleet_take_motion(robot_arm_t *arm, robot_arm_request_t *request)
+{
+    bool pending = false;
+
+    portENTER_CRITICAL(&arm->motion_lock);
+    if (arm->motion_pending[MOTION_SLOT_JOINTS]) {
+        *request = arm->motion[MOTION_SLOT_JOINTS];
+        arm->motion_pending[MOTION_SLOT_JOINTS] = false;
+        pending = true;
+    }
+    for (uint32_t n = 0; n < MOTION_SLOT_COUNT - 1 && !pending; n++) {
+        uint32_t index = 1 + (arm->motion_next + n) % (MOTION_SLOT_COUNT - 1);
+        if (arm->motion_pending[index]) {
+            *request = arm->motion[index];
+            arm->motion_pending[index] = false;
+            arm->motion_next = index % (MOTION_SLOT_COUNT - 1);
+            pending = true;
+        }
+    }
+    portEXIT_CRITICAL(&arm->motion_lock);
+    return pending;
+}
+
+// Per-arm worker: ordered commands first, then the latest moves
+static void robot_arm_fleet_task(void *arg)
+{
+    robot_arm_t *arm = (robot_arm_t *)arg;
+    robot_arm_request_t request;
+
+    ESP_LOGI(FLEET_TAG, "%s worker started for %s", arm->name, arm->session.robot_ip);
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool sent;
+        do {
+            sent = false;
+            while (robot_arm_queue_pop(&arm->queue, &request)) {
+                fleet_dispatch(arm, &request);
+            }
+            if (fleet_take_motion(arm, &request)) {
+                fleet_dispatch(arm, &request);
+                sent = true;
+            }
+        } while (sent);
+    }
+}
+
+static int fleet_claim_slot(void)
+{
+    int index = -1;
+    portENTER_CRITICAL(&fleet_lock);
+    for (int i = 0; i < FLEET_MAX_ARMS && index < 0; i++) {
+        if (!fleet_claimed[i]) {
+            fleet_claimed[i] = true;
+            index = i;
+        }
+    }
+    portEXIT_CRITICAL(&fleet_lock);
+    return index;
+}
+
+static void fleet_release_slot(int index)
+{
+    portENTER_CRITICAL(&fleet_lock);
+    fleet_claimed[index] = false;
+    portEXIT_CRITICAL(&fleet_lock);
+}
+
+robot_arm_t *robot_arm_fleet_add(const char *robot_ip)
+{
+    if (!robot_ip) {
+        return NULL;
+    }
+
+    int index = fleet_claim_slot();
+    if (index < 0) {
+        ESP_LOGE(FLEET_TAG, "Fleet is full (%d arms)", FLEET_MAX_ARMS);
+        return NULL;
+    }
+
+    robot_arm_t *arm = &fleet_arms[index];
+    memset(arm, 0, sizeof(*arm));
+    arm->index = index;
+    snprintf(arm->name, sizeof(arm->name), "arm%d", index);
+    portMUX_INITIALIZE(&arm->motion_lock);
+    robot_arm_queue_init(&arm->queue, arm->queue_slots, FLEET_QUEUE_LENGTH);
+
+    arm->session.name = arm->name;
+    arm->session.timeout_ms = FLEET_HTTP_TIMEOUT_MS;
+    arm->session.ingest_feedback = false;
+    if (!robot_arm_http_session_start(&arm->session, robot_ip)) {
+        fleet_release_slot(index);
+        return NULL;
+    }
+
+    // Workers float between cores so two arms can be on the wire at once
+    BaseType_t ret = xTaskCreatePinnedToCore(robot_arm_fleet_task, arm->name, FLEET_TASK_STACK_SIZE, arm,
+                                             FLEET_TASK_PRIORITY, &arm->task, tskNO_AFFINITY);
+    if (ret != pdPASS) {
+        ESP_LOGE(FLEET_TAG, "Failed to create worker for %s", robot_ip);
+        robot_arm_http_session_close(&arm->session);
+        fleet_release_slot(index);
+        return NULL;
+    }
+
+    // Publish the arm, then widen the count past it; adds finishing out of order only ever grow it
+    atomic_store(&arm->ready, true);
+    int count = atomic_load(&fleet_count);
+    while (count <= index && !atomic_compare_exchange_weak(&fleet_count, &count, index + 1)) {
+    }
+    ESP_LOGI(FLEET_TAG, "Added %s at %s", arm->name, robot_ip);
+    return arm;
+}
+
+int robot_arm_fleet_count(void)
+{
+    return atomic_load(&fleet_count);
+}
+
+robot_arm_t *robot_arm_fleet_get(int index)
+{
+    if (index < 0 || index >= atomic_load(&fleet_count) || !atomic_load(&fleet_arms[index].ready)) {
+        return NULL;
+    }
+    return &fleet_arms[index];
+}
+
+const char *robot_arm_fleet_get_ip(const robot_arm_t *arm)
+{
+    return arm ? arm->session.robot_ip : NULL;
+}
+
+// Queue a request on one arm; shared by submit and broadcast
+static robot_arm_comm_status_t fleet_enqueue(robot_arm_t *arm, const robot_arm_request_t *request)
+{
+    const robot_arm_cmd_t *cmd = &request->cmd;
+
+    int slot = motion_slot_index(cmd);
+    if (slot >= 0) {
+        uint32_t replaced = fleet_store_motion(arm, slot, request);
+        if (replaced) {
+            atomic_fetch_add(&arm->coalesced, replaced);
+        }
+    } else {
+        if ((cmd->type == ROBOT_ARM_CMD_TORQUE && !cmd->torque_on) || cmd->type == ROBOT_ARM_CMD_HOME) {
+            fleet_flush_motion(arm);
+        }
+        if (!robot_arm_queue_push(&arm->queue, request)) {
+            atomic_fetch_add(&arm->dropped, 1);
+            ESP_LOGW(FLEET_TAG, "%s queue full, dropping command type %d", arm->name, cmd->type);
+            return ROBOT_ARM_COMM_ERROR;
+        }
+    }
+    return ROBOT_ARM_COMM_OK;
+}
+
+robot_arm_comm_status_t robot_arm_fleet_submit(robot_arm_t *arm, const robot_arm_cmd_t *cmd,
+                                               robot_arm_done_cb_t done_cb, void *user_data)
+{
+    if (!arm || !cmd || !atomic_load(&arm->ready)) {
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    robot_arm_request_t request = {
+        .cmd = *cmd,
+        .done_cb = done_cb,
+        .user_data = user_data,
+        .submit_us = esp_timer_get_time(),
+    };
+    robot_arm_comm_status_t result = fleet_enqueue(arm, &request);
+    if (result == ROBOT_ARM_COMM_OK) {
+        xTaskNotifyGive(arm->task);
+    }
+    return result;
+}
+
+robot_arm_comm_status_t robot_arm_fleet_broadcast(const robot_arm_cmd_t *cmd)
+{
+    if (!cmd) {
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    int count = atomic_load(&fleet_count);
+    int64_t now_us = esp_timer_get_time();
+    robot_arm_request_t request = {
+        .cmd = *cmd,
+        .submit_us = now_us,
+        .release_us = now_us + BROADCAST_LEAD_US,
+    };
+
+    portENTER_CRITICAL(&fleet_lock);
+    broadcast_release_us = request.release_us;
+    broadcast_first_us = INT64_MAX;
+    broadcast_last_us = INT64_MIN;
+    broadcast_count++;
+    portEXIT_CRITICAL(&fleet_lock);
+
+    // Queue everywhere first, then wake every worker, so no arm starts ahead of the others.
+    // A slot still being added is skipped both times.
+    robot_arm_comm_status_t result = ROBOT_ARM_COMM_OK;
+    bool queued[FLEET_MAX_ARMS] = { false };
+    for (int i = 0; i < count; i++) {
+        if (!atomic_load(&fleet_arms[i].ready)) {
+            continue;
+        }
+        queued[i] = (fleet_enqueue(&fleet_arms[i], &request) == ROBOT_ARM_COMM_OK);
+        if (!queued[i]) {
+            result = ROBOT_ARM_COMM_ERROR;
+        }
+    }
+    for (int i = 0; i < count; i++) {
+        if (queued[i]) {
+            xTaskNotifyGive(fleet_arms[i].task);
+        }
+    }
+    return result;
+}
+
+void robot_arm_fleet_get_arm_stats(robot_arm_t *arm, robot_arm_fleet_arm_stats_t *stats)
+{
+    if (!arm || !stats) {
+        return;
+    }
+
+    stats->sent = atomic_load(&arm->sent);
+    stats->failures = atomic_load(&arm->failures);
+    stats->timeouts = atomic_load(&arm->timeouts);
+    stats->dropped = atomic_load(&arm->dropped);
+    stats->coalesced = atomic_load(&arm->coalesced);
+    stats->late_broadcasts = atomic_load(&arm->late_broadcasts);
+    stats->p50_us = robot_arm_latency_percentile(&arm->latency, 50.0f);
+    stats->p99_us = robot_arm_latency_percentile(&arm->latency, 99.0f);
+    stats->max_us = robot_arm_latency_max(&arm->latency);
+    // Session counters are plain words written by the worker; a torn read only skews one sample
+    stats->session = arm->session.stats;
+}
+
+void robot_arm_fleet_get_stats(robot_arm_fleet_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+
+    portENTER_CRITICAL(&fleet_lock);
+    stats->broadcasts = broadcast_count;
+    stats->last_skew_us = (broadcast_last_us >= broadcast_first_us) ? (uint32_t)(broadcast_last_us - broadcast_first_us) : 0;
+    stats->max_skew_us = broadcast_max_skew_us;
+    portEXIT_CRITICAL(&fleet_lock);
+}
@@ -0,0 +1,54 @@
+#ifndef ROBOT_ARM_FLEET_H
+#define ROBOT_ARM_FLEET_H
+
+#include <stdint.h>
+#include "robot_arm_comm.h"
+
+// Fleet mode: several arms driven from one panel. Each arm added here gets its own worker task,
+// command queue, latest-wins motion slots and keep-alive HTTP session, so a slow arm never holds
+// up the others. This is independent of the single-arm API in robot_arm_comm.h, which keeps
+// driving the panel's own arm (with feedback, WebSocket/UART transports and the priority lane).
+typedef struct robot_arm robot_arm_t;
+
+// Counters of one fleet arm
+typedef struct {
+    uint32_t sent;
+    uint32_t failures;
+    uint32_t timeouts;
+    uint32_t dropped;            // Rejected because the arm's queue was full
+    uint32_t coalesced;          // Unsent moves replaced by a newer one
+    uint32_t late_broadcasts;    // Broadcasts this arm started after their release window
+    uint32_t p50_us;             // Wire latency (send to reply)
+    uint32_t p99_us;
+    uint32_t max_us;
+    robot_arm_session_stats_t session;
+} robot_arm_fleet_arm_stats_t;
+
+// Broadcast timing across the fleet
+typedef struct {
+    uint32_t broadcasts;
+    uint32_t last_skew_us;       // Spread of send start times of the latest broadcast
+    uint32_t max_skew_us;
+} robot_arm_fleet_stats_t;
+
+// Function declarations
+robot_arm_t *robot_arm_fleet_add(const char *robot_ip);   // NULL if the fleet is full; any task
+int robot_arm_fleet_count(void);
+robot_arm_t *robot_arm_fleet_get(int index);               // NULL while that slot is still being added
+const char *robot_arm_fleet_get_ip(const robot_arm_t *arm);
+
+// Queue a command for one arm without blocking. Moves are coalesced latest-wins per joint, as
+// robot_arm_submit() does: a move only replaces an unsent move of the same joint, and an
+// all-joint move replaces all of them. Torque-off and home drop the arm's unsent moves.
+robot_arm_comm_status_t robot_arm_fleet_submit(robot_arm_t *arm, const robot_arm_cmd_t *cmd,
+                                               robot_arm_done_cb_t done_cb, void *user_data);
+
+// Queue a command on every arm with a shared release time, so all arms start sending it
+// together (within ROBOT_ARM_FLEET_BROADCAST_LEAD_MS) instead of one after the other.
+// Returns ROBOT_ARM_COMM_ERROR if any arm could not take it.
+robot_arm_comm_status_t robot_arm_fleet_broadcast(const robot_arm_cmd_t *cmd);
+
+void robot_arm_fleet_get_arm_stats(robot_arm_t *arm, robot_arm_fleet_arm_stats_t *stats);
+void robot_arm_fleet_get_stats(robot_arm_fleet_stats_t *stats);
+
+#endif // ROBOT_ARM_FLEET_H
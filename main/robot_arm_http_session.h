@@ -0,0 +1,34 @@
+#ifndef ROBOT_ARM_HTTP_SESSION_H
+#define ROBOT_ARM_HTTP_SESSION_H
+
+#include <stdbool.h>
+#include "esp_http_client.h"
+#include "robot_arm_comm.h"
+#include "robot_arm_transport.h"
+
+#define ROBOT_ARM_HTTP_BUFFER_SIZE 1024
+
+// Persistent keep-alive HTTP session to one robot, reused across commands. The HTTP transports
+// each own one; fleet arms get one each. A session is used by one task at a time.
+typedef struct {
+    const char *name;
+    int timeout_ms;                    // Reply wait when a send comes without limits
+    int applied_timeout_ms;            // Wait the client is currently set to
+    bool ingest_feedback;              // Hand replies to robot_arm_feedback (the panel's own arm only)
+    char robot_ip[16];
+    esp_http_client_handle_t client;
+    bool connected;                    // Set by HTTP_EVENT_ON_CONNECTED during a request
+    robot_arm_session_stats_t stats;
+    char response[ROBOT_ARM_HTTP_BUFFER_SIZE];
+    int response_len;
+} robot_arm_http_session_t;
+
+// Function declarations
+bool robot_arm_http_session_start(robot_arm_http_session_t *session, const char *ip);
+void robot_arm_http_session_close(robot_arm_http_session_t *session);
+// GET a pre-encoded request path (/js?json=...) on a fresh socket after any error, within the
+// limits (NULL: the session timeout, resent once in case the socket went stale)
+robot_arm_comm_status_t robot_arm_http_session_send(robot_arm_http_session_t *session, const char *path,
+                                                    robot_arm_send_limits_t *limits);
+
+#endif // ROBOT_ARM_HTTP_SESSION_H
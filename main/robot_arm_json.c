@@ -0,0 +1,164 @@
+#include <math.h>
+#include "robot_arm_json.h"
+
+// Per-byte URL class: 0 = unreserved (copied), 1 = percent-encoded, 2 = space (written as '+')
+#define URL_PASS   0
+#define URL_ESCAPE 1
+#define URL_SPACE  2
+static const uint8_t url_class[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0x00
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0x10
+    2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 1,  // 0x20
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1,  // 0x30
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x40
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 0,  // 0x50
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  // 0x60
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 1,  // 0x70
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0x80
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0x90
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0xA0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0xB0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0xC0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0xD0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0xE0
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  // 0xF0
+};
+
+static const char hex_digits[] = "0123456789ABCDEF";
+
+// Append one byte, already in wire form
+static inline void put_raw(robot_arm_json_writer_t *writer, char c)
+{
+    // Keep one byte for the terminator
+    if (writer->len + 1 < writer->size) {
+        writer->buf[writer->len++] = c;
+    } else {
+        writer->overflow = true;
+    }
+}
+
+// Append one JSON character, percent-encoding it if the writer encodes
+static inline void put_char(robot_arm_json_writer_t *writer, char c)
+{
+    if (!writer->url_encode) {
+        put_raw(writer, c);
+        return;
+    }
+
+    switch (url_class[(uint8_t)c]) {
+        case URL_PASS:
+            put_raw(writer, c);
+            break;
+        case URL_SPACE:
+            put_raw(writer, '+');
+            break;
+        default:
+            put_raw(writer, '%');
+            put_raw(writer, hex_digits[(uint8_t)c >> 4]);
+            put_raw(writer, hex_digits[(uint8_t)c & 0x0F]);
+            break;
+    }
+}
+
+// Append decimal digits of an unsigned value, at least min_digits long
+static void put_digits(robot_arm_json_writer_t *writer, uint32_t value, int min_digits)
+{
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value > 0 || n < min_digits);
+    while (n > 0) {
+        put_char(writer, digits[--n]);
+    }
+}
+
+// Start a member: separator, quoted key and colon
+static void put_key(robot_arm_json_writer_t *writer, const char *key)
+{
+    if (writer->need_comma) {
+        put_char(writer, ',');
+    }
+    writer->need_comma = true;
+
+    put_char(writer, '"');
+    while (*key) {
+        put_char(writer, *key++);
+    }
+    put_char(writer, '"');
+    put_char(writer, ':');
+}
+
+void robot_arm_json_init(robot_arm_json_writer_t *writer, char *buf, size_t size, bool url_encode)
+{
+    writer->buf = buf;
+    writer->size = size;
+    writer->len = 0;
+    writer->url_encode = url_encode;
+    writer->need_comma = false;
+    writer->overflow = (buf == NULL || size == 0);
+}
+
+void robot_arm_json_raw(robot_arm_json_writer_t *writer, const char *text)
+{
+    while (*text) {
+        put_raw(writer, *text++);
+    }
+}
+
+void robot_arm_json_begin_object(robot_arm_json_writer_t *writer)
+{
+    put_char(writer, '{');
+    writer->need_comma = false;
+}
+
+void robot_arm_json_end_object(robot_arm_json_writer_t *writer)
+{
+    put_char(writer, '}');
+    writer->need_comma = true;
+}
+
+void robot_arm_json_int(robot_arm_json_writer_t *writer, const char *key, int32_t value)
+{
+    put_key(writer, key);
+    if (value < 0) {
+        put_char(writer, '-');
+        put_digits(writer, (uint32_t)0 - (uint32_t)value, 1);
+    } else {
+        put_digits(writer, (uint32_t)value, 1);
+    }
+}
+
+void robot_arm_json_fixed(robot_arm_json_writer_t *writer, const char *key, float value, int decimals)
+{
+    static const uint32_t scales[] = { 1, 10, 100, 1000, 10000 };
+    if (decimals < 0) decimals = 0;
+    if (decimals > 4) decimals = 4;
+
+    put_key(writer, key);
+
+    // Round once to an integer count of the last decimal place, then print it as fixed point
+    long scaled = lroundf(value * (float)scales[decimals]);
+    uint32_t magnitude = (scaled < 0) ? (uint32_t)(-scaled) : (uint32_t)scaled;
+    if (scaled < 0) {
+        put_char(writer, '-');
+    }
+    put_digits(writer, magnitude / scales[decimals], 1);
+    if (decimals > 0) {
+        put_char(writer, '.');
+        put_digits(writer, magnitude % scales[decimals], decimals);
+    }
+}
+
+int robot_arm_json_finish(robot_arm_json_writer_t *writer)
+{
+    if (writer->overflow) {
+        if (writer->size > 0) {
+            writer->buf[0] = '\0';
+        }
+        return -1;
+    }
+    writer->buf[writer->len] = '\0';
+    return (int)writer->len;
+}
@@ -0,0 +1,29 @@
+#ifndef ROBOT_ARM_JSON_H
+#define ROBOT_ARM_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming JSON writer for robot commands. Output goes straight into the caller's buffer,
+// optionally percent-encoded on the way, in a single pass with no libc formatting.
+// Running out of room sets the overflow flag instead of truncating.
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+    bool url_encode;     // Percent-encode every character as it is written
+    bool need_comma;     // A member has been written in the current object
+    bool overflow;
+} robot_arm_json_writer_t;
+
+// Function declarations
+void robot_arm_json_init(robot_arm_json_writer_t *writer, char *buf, size_t size, bool url_encode);
+void robot_arm_json_raw(robot_arm_json_writer_t *writer, const char *text);  // Written as-is, never encoded
+void robot_arm_json_begin_object(robot_arm_json_writer_t *writer);
+void robot_arm_json_end_object(robot_arm_json_writer_t *writer);
+void robot_arm_json_int(robot_arm_json_writer_t *writer, const char *key, int32_t value);
+void robot_arm_json_fixed(robot_arm_json_writer_t *writer, const char *key, float value, int decimals); // 0-4 decimals
+int robot_arm_json_finish(robot_arm_json_writer_t *writer);  // NUL-terminates; length, or -1 on overflow
+
+#endif // ROBOT_ARM_JSON_H
@@ -0,0 +1,157 @@
+#include <math.h>
+#include <string.h>
+#include "robot_arm_kinematics.h"
+
+#define HALF_PI  1.57079632679f
+#define PI       3.14159265359f
+
+// Quarter-wave sine and [0, 1] arctangent tables, filled by robot_arm_kinematics_init()
+#define TRIG_TABLE_SIZE 256
+static float sin_table[TRIG_TABLE_SIZE + 1];
+static float atan_table[TRIG_TABLE_SIZE + 1];
+
+void robot_arm_kinematics_init(void)
+{
+    for (int i = 0; i <= TRIG_TABLE_SIZE; i++) {
+        sin_table[i] = sinf(HALF_PI * i / TRIG_TABLE_SIZE);
+        atan_table[i] = atanf((float)i / TRIG_TABLE_SIZE);
+    }
+}
+
+// Linear interpolation in a table over [0, 1]
+static float table_lookup(const float *table, float t)
+{
+    float f = t * TRIG_TABLE_SIZE;
+    int i = (int)f;
+    if (i >= TRIG_TABLE_SIZE) {
+        return table[TRIG_TABLE_SIZE];
+    }
+    return table[i] + (table[i + 1] - table[i]) * (f - i);
+}
+
+static float fast_sin(float a)
+{
+    // Reduce to [0, 2pi), then fold into the first quadrant
+    a = fmodf(a, 2.0f * PI);
+    if (a < 0.0f) a += 2.0f * PI;
+    float sign = 1.0f;
+    if (a >= PI) {
+        a -= PI;
+        sign = -1.0f;
+    }
+    if (a > HALF_PI) {
+        a = PI - a;
+    }
+    return sign * table_lookup(sin_table, a / HALF_PI);
+}
+
+static float fast_cos(float a)
+{
+    return fast_sin(a + HALF_PI);
+}
+
+static float fast_atan2(float y, float x)
+{
+    float ax = fabsf(x), ay = fabsf(y);
+    if (ax == 0.0f && ay == 0.0f) {
+        return 0.0f;
+    }
+
+    // Octant reduction: atan of a ratio in [0, 1]
+    float a = (ay <= ax) ? table_lookup(atan_table, ay / ax) : HALF_PI - table_lookup(atan_table, ax / ay);
+    if (x < 0.0f) a = PI - a;
+    return (y < 0.0f) ? -a : a;
+}
+
+static float clampf(float value, float low, float high)
+{
+    return (value < low) ? low : (value > high) ? high : value;
+}
+
+// The upper arm is bent: treat it as one straight link L2 tilted forward by L2_OFFSET
+#define L2_MM      sqrtf(ROBOT_ARM_L2A_MM * ROBOT_ARM_L2A_MM + ROBOT_ARM_L2B_MM * ROBOT_ARM_L2B_MM)
+#define L2_OFFSET  fast_atan2(ROBOT_ARM_L2B_MM, ROBOT_ARM_L2A_MM)
+
+void robot_arm_fk(const float radians[ROBOT_ARM_JOINT_COUNT], robot_arm_cartesian_t *pose)
+{
+    float base = radians[0], shoulder = radians[1], elbow = radians[2];
+
+    // Angles measured from vertical: sine gives reach, cosine gives height
+    float upper = shoulder + L2_OFFSET;
+    float fore = shoulder + elbow;
+    float reach = L2_MM * fast_sin(upper) + ROBOT_ARM_L3_MM * fast_sin(fore);
+    float height = L2_MM * fast_cos(upper) + ROBOT_ARM_L3_MM * fast_cos(fore);
+
+    pose->x = reach * fast_cos(base);
+    pose->y = reach * fast_sin(base);
+    pose->z = ROBOT_ARM_L1_MM + height;
+    pose->gripper = radians[3];
+}
+
+robot_arm_ik_status_t robot_arm_ik(const robot_arm_cartesian_t *pose,
+                                   const robot_arm_traj_limits_t limits[ROBOT_ARM_JOINT_COUNT],
+                                   float radians[ROBOT_ARM_JOINT_COUNT])
+{
+    robot_arm_ik_status_t status = ROBOT_ARM_IK_OK;
+    float l2 = L2_MM;
+    float l3 = ROBOT_ARM_L3_MM;
+
+    float base = fast_atan2(pose->y, pose->x);
+    float reach = sqrtf(pose->x * pose->x + pose->y * pose->y);
+    float height = pose->z - ROBOT_ARM_L1_MM;
+
+    // Pull targets outside the annulus the two links can reach onto its edge
+    float distance = sqrtf(reach * reach + height * height);
+    float max_distance = (l2 + l3) * 0.9999f;
+    float min_distance = fabsf(l2 - l3) * 1.0001f;
+    if (distance > max_distance || distance < min_distance) {
+        float scale = (distance > max_distance) ? max_distance / distance : min_distance / fmaxf(distance, 1e-3f);
+        reach *= scale;
+        height *= scale;
+        distance = sqrtf(reach * reach + height * height);
+        status = ROBOT_ARM_IK_OUT_OF_REACH;
+    }
+
+    // Law of cosines for the angle between the upper arm and the shoulder-to-tip line
+    float cos_inner = clampf((l2 * l2 + distance * distance - l3 * l3) / (2.0f * l2 * distance), -1.0f, 1.0f);
+    float inner = fast_atan2(sqrtf(1.0f - cos_inner * cos_inner), cos_inner);
+
+    // Candidates in order of preference: elbow up (upper arm closer to vertical than that line),
+    // elbow down, then both again with the base turned around and the arm leaning back over
+    // the top, which reaches a tip just behind the base axis. The first that fits every range
+    // wins; otherwise the one needing the least clamping.
+    float best[ROBOT_ARM_JOINT_COUNT];
+    float best_excess = INFINITY;
+    for (int option = 0; option < 4 && best_excess > 0.0f; option++) {
+        bool flipped = option >= 2;
+        float side_base = flipped ? fast_atan2(-pose->y, -pose->x) : base;
+        float side_reach = flipped ? -reach : reach;
+
+        float line = fast_atan2(side_reach, height);
+        float upper = (option % 2 == 0) ? line - inner : line + inner;
+        float elbow_reach = l2 * fast_sin(upper);
+        float elbow_height = l2 * fast_cos(upper);
+        float fore = fast_atan2(side_reach - elbow_reach, height - elbow_height);
+        float shoulder = upper - L2_OFFSET;
+
+        float solved[ROBOT_ARM_JOINT_COUNT] = { side_base, shoulder, fore - shoulder, pose->gripper };
+        float clamped[ROBOT_ARM_JOINT_COUNT];
+        float excess = 0.0f;
+        for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+            clamped[i] = clampf(solved[i], limits[i].min_rad, limits[i].max_rad);
+            if (i < ROBOT_ARM_JOINT_COUNT - 1) {
+                excess += fabsf(clamped[i] - solved[i]);
+            }
+        }
+        if (option == 0 || excess < best_excess) {
+            best_excess = excess;
+            memcpy(best, clamped, sizeof(best));
+        }
+    }
+
+    memcpy(radians, best, sizeof(best));
+    if (best_excess > 0.0f) {
+        status = ROBOT_ARM_IK_JOINT_LIMIT;
+    }
+    return status;
+}
@@ -0,0 +1,39 @@
+#ifndef ROBOT_ARM_KINEMATICS_H
+#define ROBOT_ARM_KINEMATICS_H
+
+#include <stdbool.h>
+#include "robot_arm_comm.h"
+#include "robot_arm_traj.h"
+
+// RoArm-M2 kinematics. Frame: origin on the table under the base axis, x forward, y left,
+// z up, millimetres. Joint conventions match the robot's own: base 0 faces +x; shoulder 0
+// is the upper arm upright, positive tilts it forward; elbow pi/2 puts the forearm at a right
+// angle to the upper arm (horizontal at home). Trig goes through small tables with linear
+// interpolation; nothing touches the heap, so the solver can run at the trajectory rate.
+// tools/host_bench/test_kinematics.c checks IK against FK across the joint ranges.
+#define ROBOT_ARM_L1_MM    126.06f   // Table to shoulder pivot
+#define ROBOT_ARM_L2A_MM   236.82f   // Shoulder to elbow, along the upper arm
+#define ROBOT_ARM_L2B_MM    30.00f   // Shoulder to elbow, forward offset
+#define ROBOT_ARM_L3_MM    280.15f   // Elbow to gripper tip
+
+typedef struct {
+    float x, y, z;       // Gripper tip (mm)
+    float gripper;       // Gripper joint angle (rad), passed through
+} robot_arm_cartesian_t;
+
+typedef enum {
+    ROBOT_ARM_IK_OK = 0,
+    ROBOT_ARM_IK_OUT_OF_REACH,   // Target pulled in to the nearest reachable point on its ray
+    ROBOT_ARM_IK_JOINT_LIMIT     // A joint was clamped to its range; the tip misses the target
+} robot_arm_ik_status_t;
+
+// Function declarations
+void robot_arm_kinematics_init(void);   // Builds the trig tables; once at start-up, before any task solves
+void robot_arm_fk(const float radians[ROBOT_ARM_JOINT_COUNT], robot_arm_cartesian_t *pose);
+// Closed-form solution, elbow up unless only elbow down fits the joint ranges in limits.
+// Joints that still fall outside their range are clamped.
+robot_arm_ik_status_t robot_arm_ik(const robot_arm_cartesian_t *pose,
+                                   const robot_arm_traj_limits_t limits[ROBOT_ARM_JOINT_COUNT],
+                                   float radians[ROBOT_ARM_JOINT_COUNT]);
+
+#endif // ROBOT_ARM_KINEMATICS_H
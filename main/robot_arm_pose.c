@@ -0,0 +1,373 @@
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_spiffs.h"
+#include "robot_arm_pose.h"
+#include "robot_arm_pose_log.h"
+#include "robot_arm_comm.h"
+#include "robot_arm_feedback.h"
+
+static const char *POSE_TAG = "ROBOT_POSE";
+
+#define POSE_BASE_PATH        "/storage"
+#define POSE_PARTITION_LABEL  "storage"
+#define POSE_LOG_MAX_SIZE     (CONFIG_ROBOT_ARM_POSE_LOG_MAX_KB * 1024)
+#define POSE_PATH_MAX         64
+#define PLAYER_TASK_STACK     3072
+#define PLAYER_TASK_PRIORITY  (CONFIG_ROBOT_ARM_COMM_TASK_PRIORITY + 1)
+#define PLAYER_START_LEAD_US  20000   // Time to get the first pose queued before it is due
+#define PLAYER_SPEED          0       // Poses are already timed; the servos just follow them
+#define PLAYER_ACCELERATION   0
+
+static bool storage_mounted = false;
+
+// Recorder: an esp_timer samples into a RAM log that is written out on stop
+static esp_timer_handle_t record_timer = NULL;
+static uint8_t *record_buffer = NULL;
+static size_t record_len = 0;
+static robot_arm_pose_codec_t record_codec;
+static robot_arm_pose_source_t record_source;
+static int64_t record_start_us = 0;
+static char record_path[POSE_PATH_MAX];
+static atomic_bool recording = false;
+static atomic_bool record_full = false;
+
+// Player: a task decodes ahead and sleeps on a one-shot esp_timer until each pose is due,
+// so the send time does not depend on tick granularity or file I/O. Poses are submitted timed,
+// so the pacer cannot delay them and the latest-wins slot cannot merge them.
+static TaskHandle_t player_task_handle = NULL;
+static esp_timer_handle_t player_timer = NULL;
+static uint8_t *play_buffer = NULL;          // Owned by the player task while playing
+static size_t play_len = 0;
+static float play_speed = 1.0f;
+static bool play_loop = false;
+static atomic_bool playing = false;
+static atomic_bool player_busy = false;
+
+esp_err_t robot_arm_pose_storage_mount(void)
+{
+    if (storage_mounted) {
+        return ESP_OK;
+    }
+
+    esp_vfs_spiffs_conf_t conf = {
+        .base_path = POSE_BASE_PATH,
+        .partition_label = POSE_PARTITION_LABEL,
+        .max_files = 4,
+        .format_if_mount_failed = false,   // A mount error must not wipe the saved recordings
+    };
+    esp_err_t err = esp_vfs_spiffs_register(&conf);
+    if (err != ESP_OK) {
+        ESP_LOGE(POSE_TAG, "Failed to mount pose storage: %s; left unformatted so saved recordings survive",
+                 esp_err_to_name(err));
+        return err;
+    }
+
+    storage_mounted = true;
+    ESP_LOGI(POSE_TAG, "Pose storage mounted at %s", POSE_BASE_PATH);
+    return ESP_OK;
+}
+
+static esp_err_t pose_path(char *path, size_t size, const char *name)
+{
+    if (!name || !name[0] || strchr(name, '/')) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int len = snprintf(path, size, POSE_BASE_PATH "/%s.pose", name);
+    return (len > 0 && (size_t)len < size) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+// Large buffers go to PSRAM when there is some
+static uint8_t *pose_buffer_alloc(size_t size)
+{
+    uint8_t *buffer = heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+    return buffer ? buffer : malloc(size);
+}
+
+// Take one sample (esp_timer task)
+static void record_timer_cb(void *arg)
+{
+    robot_arm_pose_t pose = {
+        .time_ms = (uint32_t)((esp_timer_get_time() - record_start_us) / 1000),
+    };
+
+    bool known = false;
+    if (record_source == ROBOT_ARM_POSE_SOURCE_COMMANDED) {
+        known = robot_arm_get_commanded_joints(pose.radians);
+    }
+    if (!known) {
+        // Nothing commanded yet (or feedback wanted): use what the robot reports
+        robot_arm_feedback_t feedback;
+        known = robot_arm_get_feedback(&feedback);
+        memcpy(pose.radians, feedback.joint_rad, sizeof(pose.radians));
+    }
+    if (!known) {
+        return;
+    }
+
+    int written = robot_arm_pose_encode(&record_codec, &pose, record_buffer + record_len, POSE_LOG_MAX_SIZE - record_len);
+    if (written < 0) {
+        // Out of room: stop sampling; robot_arm_pose_record_stop() still saves what was taken
+        esp_timer_stop(record_timer);
+        atomic_store(&record_full, true);
+        return;
+    }
+    record_len += written;
+}
+
+esp_err_t robot_arm_pose_record_start(const char *name, robot_arm_pose_source_t source, int rate_hz)
+{
+    if (atomic_load(&recording)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (rate_hz <= 0 || pose_path(record_path, sizeof(record_path), name) != ESP_OK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t err = robot_arm_pose_storage_mount();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (!record_buffer) {
+        record_buffer = pose_buffer_alloc(POSE_LOG_MAX_SIZE);
+        if (!record_buffer) {
+            ESP_LOGE(POSE_TAG, "No memory for pose recording");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    if (!record_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = record_timer_cb,
+            .name = "pose_record",
+        };
+        err = esp_timer_create(&timer_args, &record_timer);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    record_len = robot_arm_pose_write_header(record_buffer, POSE_LOG_MAX_SIZE);
+    robot_arm_pose_codec_reset(&record_codec);
+    record_source = source;
+    record_start_us = esp_timer_get_time();
+    atomic_store(&record_full, false);
+    atomic_store(&recording, true);
+
+    err = esp_timer_start_periodic(record_timer, 1000000 / rate_hz);
+    if (err != ESP_OK) {
+        atomic_store(&recording, false);
+        return err;
+    }
+
+    ESP_LOGI(POSE_TAG, "Recording %s at %d Hz", record_path, rate_hz);
+    return ESP_OK;
+}
+
+esp_err_t robot_arm_pose_record_stop(void)
+{
+    if (!atomic_load(&recording)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_timer_stop(record_timer);
+    atomic_store(&recording, false);
+    if (atomic_load(&record_full)) {
+        ESP_LOGW(POSE_TAG, "Pose log filled its %d KB buffer; recording was cut short", CONFIG_ROBOT_ARM_POSE_LOG_MAX_KB);
+    }
+
+    FILE *file = fopen(record_path, "wb");
+    if (!file) {
+        ESP_LOGE(POSE_TAG, "Failed to open %s for writing", record_path);
+        return ESP_FAIL;
+    }
+    size_t written = fwrite(record_buffer, 1, record_len, file);
+    fclose(file);
+    if (written != record_len) {
+        ESP_LOGE(POSE_TAG, "Failed to write %s", record_path);
+        return ESP_FAIL;
+    }
+
+    ESP_LOGI(POSE_TAG, "Saved %s (%u bytes)", record_path, (unsigned)record_len);
+    return ESP_OK;
+}
+
+bool robot_arm_pose_is_recording(void)
+{
+    return atomic_load(&recording);
+}
+
+static void player_timer_cb(void *arg)
+{
+    xTaskNotifyGive(player_task_handle);
+}
+
+// Sleep until an esp_timer time; returns false if playback was stopped meanwhile
+static bool player_wait_until(int64_t due_us)
+{
+    int64_t wait_us = due_us - esp_timer_get_time();
+    if (wait_us > 0) {
+        esp_timer_start_once(player_timer, (uint64_t)wait_us);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+    return atomic_load(&playing);
+}
+
+// Play the loaded log once per start request; loops by rewinding the decoder
+static void robot_arm_player_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (!atomic_load(&playing)) {
+            continue;
+        }
+
+        robot_arm_pose_codec_t codec;
+        robot_arm_pose_t pose;
+        int64_t base_us = esp_timer_get_time() + PLAYER_START_LEAD_US;
+        uint32_t last_time_ms = 0;
+        uint32_t period_ms = 0;
+        size_t pos = ROBOT_ARM_POSE_LOG_HEADER_SIZE;
+        robot_arm_pose_codec_reset(&codec);
+
+        while (atomic_load(&playing)) {
+            int used = robot_arm_pose_decode(&codec, play_buffer + pos, play_len - pos, &pose);
+            if (used <= 0) {
+                if (used < 0) {
+                    ESP_LOGW(POSE_TAG, "Pose log truncated at byte %u", (unsigned)pos);
+                }
+                // A log spanning no time has nothing to loop over
+                if (!play_loop || last_time_ms == 0) {
+                    break;
+                }
+                // Next pass starts one sample period after the last pose of this one
+                base_us += (int64_t)((last_time_ms + period_ms) * 1000.0f / play_speed);
+                pos = ROBOT_ARM_POSE_LOG_HEADER_SIZE;
+                last_time_ms = 0;
+                robot_arm_pose_codec_reset(&codec);
+                continue;
+            }
+            pos += used;
+            period_ms = pose.time_ms - last_time_ms;
+            last_time_ms = pose.time_ms;
+
+            // Absolute schedule from the start of the pass, so waits never accumulate drift
+            if (!player_wait_until(base_us + (int64_t)(pose.time_ms * 1000.0f / play_speed))) {
+                break;
+            }
+            robot_arm_cmd_t cmd = {
+                .type = ROBOT_ARM_CMD_MOVE_JOINTS,
+                .joints = { .speed = PLAYER_SPEED, .acceleration = PLAYER_ACCELERATION },
+            };
+            memcpy(cmd.joints.radians, pose.radians, sizeof(cmd.joints.radians));
+            robot_arm_submit_timed(&cmd, NULL, NULL);
+        }
+
+        esp_timer_stop(player_timer);
+        free(play_buffer);
+        play_buffer = NULL;
+        atomic_store(&playing, false);
+        atomic_store(&player_busy, false);
+        ESP_LOGI(POSE_TAG, "Playback finished");
+    }
+}
+
+// Read a whole pose log into memory
+static esp_err_t pose_load(const char *path, uint8_t **buffer, size_t *len)
+{
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        ESP_LOGE(POSE_TAG, "No pose log %s", path);
+        return ESP_ERR_NOT_FOUND;
+    }
+    if (st.st_size < ROBOT_ARM_POSE_LOG_HEADER_SIZE || st.st_size > POSE_LOG_MAX_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint8_t *data = pose_buffer_alloc(st.st_size);
+    if (!data) {
+        return ESP_ERR_NO_MEM;
+    }
+    FILE *file = fopen(path, "rb");
+    size_t read = file ? fread(data, 1, st.st_size, file) : 0;
+    if (file) {
+        fclose(file);
+    }
+    if (read != (size_t)st.st_size || !robot_arm_pose_check_header(data, read)) {
+        ESP_LOGE(POSE_TAG, "%s is not a valid pose log", path);
+        free(data);
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    *buffer = data;
+    *len = read;
+    return ESP_OK;
+}
+
+esp_err_t robot_arm_pose_play_start(const char *name, float speed, bool loop)
+{
+    char path[POSE_PATH_MAX];
+    if (speed <= 0.0f || pose_path(path, sizeof(path), name) != ESP_OK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (atomic_load(&player_busy)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    esp_err_t err = robot_arm_pose_storage_mount();
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    if (!player_task_handle) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = player_timer_cb,
+            .name = "pose_play",
+        };
+        err = esp_timer_create(&timer_args, &player_timer);
+        if (err != ESP_OK) {
+            return err;
+        }
+        if (xTaskCreate(robot_arm_player_task, "pose_play", PLAYER_TASK_STACK, NULL,
+                        PLAYER_TASK_PRIORITY, &player_task_handle) != pdPASS) {
+            ESP_LOGE(POSE_TAG, "Failed to create pose player task");
+            player_task_handle = NULL;
+            return ESP_FAIL;
+        }
+    }
+
+    err = pose_load(path, &play_buffer, &play_len);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    play_speed = speed;
+    play_loop = loop;
+    atomic_store(&player_busy, true);
+    atomic_store(&playing, true);
+    xTaskNotifyGive(player_task_handle);
+
+    ESP_LOGI(POSE_TAG, "Playing %s at %.2fx%s", path, speed, loop ? ", looping" : "");
+    return ESP_OK;
+}
+
+void robot_arm_pose_play_stop(void)
+{
+    if (atomic_exchange(&playing, false) && player_timer) {
+        // Wake the player early; it frees the log and goes idle
+        esp_timer_stop(player_timer);
+        xTaskNotifyGive(player_task_handle);
+    }
+}
+
+bool robot_arm_pose_is_playing(void)
+{
+    return atomic_load(&playing);
+}
@@ -0,0 +1,27 @@
+#ifndef ROBOT_ARM_POSE_H
+#define ROBOT_ARM_POSE_H
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Teach-and-repeat: record joint angles into a pose log on the "storage" SPIFFS partition and
+// play it back through the command path at the recorded cadence.
+typedef enum {
+    ROBOT_ARM_POSE_SOURCE_COMMANDED,   // Angles the robot last accepted (what the panel sent)
+    ROBOT_ARM_POSE_SOURCE_FEEDBACK     // Angles the robot reported (hand-guided teaching with torque off)
+} robot_arm_pose_source_t;
+
+// Function declarations
+esp_err_t robot_arm_pose_storage_mount(void);   // Called on first use; safe to call again
+
+// Recording samples into RAM at rate_hz (esp_timer) and writes /storage/<name>.pose on stop
+esp_err_t robot_arm_pose_record_start(const char *name, robot_arm_pose_source_t source, int rate_hz);
+esp_err_t robot_arm_pose_record_stop(void);
+bool robot_arm_pose_is_recording(void);
+
+// Playback loads the whole log, then submits each pose at its recorded time divided by speed
+esp_err_t robot_arm_pose_play_start(const char *name, float speed, bool loop);
+void robot_arm_pose_play_stop(void);
+bool robot_arm_pose_is_playing(void);
+
+#endif // ROBOT_ARM_POSE_H
@@ -0,0 +1,122 @@
+#include <math.h>
+#include <string.h>
+#include "robot_arm_pose_log.h"
+
+static const uint8_t pose_log_magic[4] = { 'R', 'A', 'P', 'L' };
+
+static int put_varint(uint8_t *out, size_t size, size_t pos, uint32_t value)
+{
+    do {
+        if (pos >= size) {
+            return -1;
+        }
+        uint8_t byte = value & 0x7F;
+        value >>= 7;
+        out[pos++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return (int)pos;
+}
+
+static int get_varint(const uint8_t *in, size_t len, size_t pos, uint32_t *value)
+{
+    uint32_t result = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (pos >= len) {
+            return -1;
+        }
+        uint8_t byte = in[pos++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return (int)pos;
+        }
+    }
+    return -1;
+}
+
+static uint32_t zigzag(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value)
+{
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+void robot_arm_pose_codec_reset(robot_arm_pose_codec_t *codec)
+{
+    memset(codec, 0, sizeof(*codec));
+}
+
+int robot_arm_pose_write_header(uint8_t *out, size_t size)
+{
+    if (size < ROBOT_ARM_POSE_LOG_HEADER_SIZE) {
+        return -1;
+    }
+    memcpy(out, pose_log_magic, sizeof(pose_log_magic));
+    out[4] = ROBOT_ARM_POSE_LOG_VERSION;
+    out[5] = ROBOT_ARM_JOINT_COUNT;
+    out[6] = ROBOT_ARM_POSE_UNITS_PER_RAD & 0xFF;
+    out[7] = ROBOT_ARM_POSE_UNITS_PER_RAD >> 8;
+    return ROBOT_ARM_POSE_LOG_HEADER_SIZE;
+}
+
+bool robot_arm_pose_check_header(const uint8_t *in, size_t len)
+{
+    return len >= ROBOT_ARM_POSE_LOG_HEADER_SIZE &&
+           memcmp(in, pose_log_magic, sizeof(pose_log_magic)) == 0 &&
+           in[4] == ROBOT_ARM_POSE_LOG_VERSION &&
+           in[5] == ROBOT_ARM_JOINT_COUNT &&
+           (in[6] | (in[7] << 8)) == ROBOT_ARM_POSE_UNITS_PER_RAD;
+}
+
+int robot_arm_pose_encode(robot_arm_pose_codec_t *codec, const robot_arm_pose_t *pose, uint8_t *out, size_t size)
+{
+    int pos = put_varint(out, size, 0, pose->time_ms - codec->time_ms);
+    int32_t units[ROBOT_ARM_JOINT_COUNT];
+
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT && pos >= 0; i++) {
+        units[i] = (int32_t)lroundf(pose->radians[i] * ROBOT_ARM_POSE_UNITS_PER_RAD);
+        pos = put_varint(out, size, pos, zigzag(units[i] - codec->units[i]));
+    }
+    if (pos < 0) {
+        return -1;
+    }
+
+    // Commit the delta state only once the whole record fitted
+    codec->time_ms = pose->time_ms;
+    memcpy(codec->units, units, sizeof(units));
+    return pos;
+}
+
+int robot_arm_pose_decode(robot_arm_pose_codec_t *codec, const uint8_t *in, size_t len, robot_arm_pose_t *pose)
+{
+    if (len == 0) {
+        return 0;
+    }
+
+    uint32_t value;
+    int pos = get_varint(in, len, 0, &value);
+    if (pos < 0) {
+        return -1;
+    }
+    uint32_t time_ms = codec->time_ms + value;
+
+    int32_t units[ROBOT_ARM_JOINT_COUNT];
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        pos = get_varint(in, len, pos, &value);
+        if (pos < 0) {
+            return -1;
+        }
+        units[i] = codec->units[i] + unzigzag(value);
+    }
+
+    codec->time_ms = time_ms;
+    memcpy(codec->units, units, sizeof(units));
+    pose->time_ms = time_ms;
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        pose->radians[i] = (float)units[i] / ROBOT_ARM_POSE_UNITS_PER_RAD;
+    }
+    return pos;
+}
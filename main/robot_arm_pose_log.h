@@ -0,0 +1,37 @@
+#ifndef ROBOT_ARM_POSE_LOG_H
+#define ROBOT_ARM_POSE_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "robot_arm_comm.h"
+
+// Compact binary pose log. After an 8-byte header ("RAPL", version, joint count, fixed-point
+// units per radian as u16 LE) each sample is a varint time delta in ms followed by one
+// zigzag varint per joint holding the change in fixed-point angle since the previous sample.
+// A slow move costs about 5-7 bytes per sample. Pure C so it can be exercised on the host.
+#define ROBOT_ARM_POSE_LOG_HEADER_SIZE  8
+#define ROBOT_ARM_POSE_LOG_VERSION      1
+#define ROBOT_ARM_POSE_UNITS_PER_RAD    10000   // 0.1 mrad resolution
+#define ROBOT_ARM_POSE_MAX_RECORD_SIZE  (5 + 5 * ROBOT_ARM_JOINT_COUNT)
+
+typedef struct {
+    uint32_t time_ms;                              // Since the start of the recording
+    float radians[ROBOT_ARM_JOINT_COUNT];          // Indexed by joint - ROBOT_ARM_JOINT_BASE
+} robot_arm_pose_t;
+
+// Delta state shared by the encoder and decoder
+typedef struct {
+    uint32_t time_ms;
+    int32_t units[ROBOT_ARM_JOINT_COUNT];
+} robot_arm_pose_codec_t;
+
+// Function declarations
+void robot_arm_pose_codec_reset(robot_arm_pose_codec_t *codec);
+int robot_arm_pose_write_header(uint8_t *out, size_t size);          // Bytes written or -1
+bool robot_arm_pose_check_header(const uint8_t *in, size_t len);
+int robot_arm_pose_encode(robot_arm_pose_codec_t *codec, const robot_arm_pose_t *pose, uint8_t *out, size_t size);
+// Bytes consumed, 0 at a clean end of data, -1 on a truncated or corrupt record
+int robot_arm_pose_decode(robot_arm_pose_codec_t *codec, const uint8_t *in, size_t len, robot_arm_pose_t *pose);
+
+#endif // ROBOT_ARM_POSE_LOG_H
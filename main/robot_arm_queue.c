@@ -0,0 +1,61 @@
+#include "robot_arm_queue.h"
+
+bool robot_arm_queue_init(robot_arm_queue_t *queue, robot_arm_queue_slot_t *slots, uint32_t capacity)
+{
+    // Capacity must be a non-zero power of two so positions can be masked
+    if (!queue || !slots || capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < capacity; i++) {
+        atomic_init(&slots[i].seq, i);
+    }
+    queue->slots = slots;
+    queue->mask = capacity - 1;
+    atomic_init(&queue->enqueue_pos, 0);
+    queue->dequeue_pos = 0;
+    return true;
+}
+
+bool robot_arm_queue_push(robot_arm_queue_t *queue, const robot_arm_request_t *request)
+{
+    robot_arm_queue_slot_t *slot;
+    unsigned int pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+
+    // Claim a slot whose sequence says it is free for this lap of the ring
+    for (;;) {
+        slot = &queue->slots[pos & queue->mask];
+        unsigned int seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Full: the consumer has not released this slot yet
+        } else {
+            pos = atomic_load_explicit(&queue->enqueue_pos, memory_order_relaxed);
+        }
+    }
+
+    slot->request = *request;
+    atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+bool robot_arm_queue_pop(robot_arm_queue_t *queue, robot_arm_request_t *request)
+{
+    uint32_t pos = queue->dequeue_pos;
+    robot_arm_queue_slot_t *slot = &queue->slots[pos & queue->mask];
+    unsigned int seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+
+    if ((int)(seq - (pos + 1)) < 0) {
+        return false; // Empty, or a producer is still filling this slot
+    }
+
+    *request = slot->request;
+    atomic_store_explicit(&slot->seq, pos + queue->mask + 1, memory_order_release);
+    queue->dequeue_pos = pos + 1;
+    return true;
+}
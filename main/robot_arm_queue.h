@@ -0,0 +1,41 @@
+#ifndef ROBOT_ARM_QUEUE_H
+#define ROBOT_ARM_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "robot_arm_comm.h"
+
+// A queued command together with its completion callback
+typedef struct {
+    robot_arm_cmd_t cmd;
+    robot_arm_done_cb_t done_cb;
+    void *user_data;
+    int64_t submit_us;             // esp_timer time of robot_arm_submit(), for queue latency
+    uint32_t epoch;                // Safety epoch at submit; a later stop or home supersedes it
+    int64_t release_us;            // Fleet broadcast: send no earlier than this (0 = at once)
+    uint32_t generation;           // Coalesced commands: store count of its pending slot
+    bool timed;                    // Caller-timed move: queued in order, never coalesced or paced
+} robot_arm_request_t;
+
+// Bounded lock-free multi-producer / single-consumer ring of requests.
+// Each slot carries a sequence number that tells producers and the consumer
+// whether it is free or filled, so no lock is taken on either side.
+typedef struct {
+    atomic_uint seq;
+    robot_arm_request_t request;
+} robot_arm_queue_slot_t;
+
+typedef struct {
+    robot_arm_queue_slot_t *slots;
+    uint32_t mask;                 // Capacity - 1 (capacity is a power of two)
+    atomic_uint enqueue_pos;
+    uint32_t dequeue_pos;          // Only touched by the consumer
+} robot_arm_queue_t;
+
+// Function declarations
+bool robot_arm_queue_init(robot_arm_queue_t *queue, robot_arm_queue_slot_t *slots, uint32_t capacity);
+bool robot_arm_queue_push(robot_arm_queue_t *queue, const robot_arm_request_t *request); // Any task
+bool robot_arm_queue_pop(robot_arm_queue_t *queue, robot_arm_request_t *request);        // Consumer only
+
+#endif // ROBOT_ARM_QUEUE_H
@@ -0,0 +1,85 @@
+#include "robot_arm_rate.h"
+
+// Rate added per successful send (so the ramp is faster when the link is fast)
+#define RATE_INCREASE_HZ        0.5f
+// Factor applied on congestion
+#define RATE_DECREASE_FACTOR    0.5f
+// RTT above min_rtt * 2 + slack counts as queueing
+#define RTT_INFLATION_SLACK_US  20000
+// Refresh the baseline RTT this often so a route change is not penalized forever
+#define MIN_RTT_WINDOW          256
+
+void robot_arm_rate_init(robot_arm_rate_t *rate, float min_rate_hz, float max_rate_hz)
+{
+    rate->min_rate_hz = min_rate_hz;
+    rate->max_rate_hz = (max_rate_hz > min_rate_hz) ? max_rate_hz : min_rate_hz;
+    // Start in the middle and let the first round trips decide
+    rate->rate_hz = (rate->min_rate_hz + rate->max_rate_hz) / 2.0f;
+    rate->ceiling_hz = rate->max_rate_hz;
+    rate->srtt_us = 0;
+    rate->rttvar_us = 0;
+    rate->min_rtt_us = UINT32_MAX;
+    rate->min_rtt_age = 0;
+    rate->last_decrease_us = INT64_MIN / 2;
+    rate->congestion_events = 0;
+}
+
+void robot_arm_rate_on_result(robot_arm_rate_t *rate, int64_t now_us, uint32_t rtt_us, bool ok)
+{
+    bool congested = !ok;
+
+    if (ok) {
+        if (rate->srtt_us == 0) {
+            rate->rttvar_us = rtt_us / 2;
+        } else {
+            uint32_t deviation = (rtt_us > rate->srtt_us) ? rtt_us - rate->srtt_us : rate->srtt_us - rtt_us;
+            rate->rttvar_us = rate->rttvar_us - rate->rttvar_us / 4 + deviation / 4;
+        }
+        rate->srtt_us = (rate->srtt_us == 0) ? rtt_us : rate->srtt_us - rate->srtt_us / 8 + rtt_us / 8;
+        if (rtt_us < rate->min_rtt_us || ++rate->min_rtt_age >= MIN_RTT_WINDOW) {
+            rate->min_rtt_us = (rtt_us < rate->srtt_us) ? rtt_us : rate->srtt_us;
+            rate->min_rtt_age = 0;
+        }
+        uint64_t limit = (uint64_t)rate->min_rtt_us * 2 + RTT_INFLATION_SLACK_US;
+        congested = rtt_us > limit;
+    }
+
+    if (congested) {
+        // One decrease per round trip: the sends already in flight reflect the old rate
+        if (now_us - rate->last_decrease_us >= (int64_t)rate->srtt_us) {
+            rate->rate_hz *= RATE_DECREASE_FACTOR;
+            rate->last_decrease_us = now_us;
+            rate->congestion_events++;
+        }
+    } else {
+        rate->rate_hz += RATE_INCREASE_HZ;
+    }
+
+    if (rate->rate_hz < rate->min_rate_hz) rate->rate_hz = rate->min_rate_hz;
+    if (rate->rate_hz > rate->ceiling_hz) rate->rate_hz = rate->ceiling_hz;
+}
+
+void robot_arm_rate_set_ceiling(robot_arm_rate_t *rate, float ceiling_hz)
+{
+    if (ceiling_hz < rate->min_rate_hz) ceiling_hz = rate->min_rate_hz;
+    if (ceiling_hz > rate->max_rate_hz) ceiling_hz = rate->max_rate_hz;
+    rate->ceiling_hz = ceiling_hz;
+    if (rate->rate_hz > ceiling_hz) rate->rate_hz = ceiling_hz;
+}
+
+uint32_t robot_arm_rate_interval_us(const robot_arm_rate_t *rate)
+{
+    return (uint32_t)(1000000.0f / rate->rate_hz);
+}
+
+uint32_t robot_arm_rate_rto_us(const robot_arm_rate_t *rate, uint32_t min_us, uint32_t max_us)
+{
+    if (rate->srtt_us == 0) {
+        return max_us;
+    }
+
+    uint64_t rto = (uint64_t)rate->srtt_us + 4 * (uint64_t)rate->rttvar_us;
+    if (rto < min_us) rto = min_us;
+    if (rto > max_us) rto = max_us;
+    return (uint32_t)rto;
+}
@@ -0,0 +1,36 @@
+#ifndef ROBOT_ARM_RATE_H
+#define ROBOT_ARM_RATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// AIMD send-rate controller for motion commands. Each completed send feeds back its round-trip
+// time and result: the rate creeps up additively while RTT stays near the best seen, and halves
+// (at most once per RTT) on an error or when RTT inflates, which means commands are queueing
+// somewhere between us and the servos. The same samples give the retransmission timeout a
+// lost reply is waited out for. Pure C so it can be exercised on the host.
+typedef struct {
+    float rate_hz;              // Current motion command rate
+    float min_rate_hz;
+    float max_rate_hz;
+    float ceiling_hz;           // Cap set from outside (link quality), max_rate_hz when unset
+    uint32_t srtt_us;           // Smoothed RTT (EWMA 1/8)
+    uint32_t rttvar_us;         // Smoothed mean deviation of the RTT (EWMA 1/4)
+    uint32_t min_rtt_us;        // Best recent RTT, the uncongested baseline
+    uint32_t min_rtt_age;       // Samples since min_rtt_us was last refreshed
+    int64_t last_decrease_us;
+    uint32_t congestion_events; // Multiplicative decreases so far
+} robot_arm_rate_t;
+
+// Function declarations
+void robot_arm_rate_init(robot_arm_rate_t *rate, float min_rate_hz, float max_rate_hz);
+void robot_arm_rate_on_result(robot_arm_rate_t *rate, int64_t now_us, uint32_t rtt_us, bool ok);
+// Cap the rate below max_rate_hz (clamped to [min_rate_hz, max_rate_hz]); a lower cap takes
+// effect at once, a higher one is climbed to additively like any other increase
+void robot_arm_rate_set_ceiling(robot_arm_rate_t *rate, float ceiling_hz);
+uint32_t robot_arm_rate_interval_us(const robot_arm_rate_t *rate);  // Spacing between motion commands
+// How long to wait for a reply before taking it as lost: srtt + 4 * rttvar, clamped to
+// [min_us, max_us]; max_us until the first sample
+uint32_t robot_arm_rate_rto_us(const robot_arm_rate_t *rate, uint32_t min_us, uint32_t max_us);
+
+#endif // ROBOT_ARM_RATE_H
@@ -0,0 +1,105 @@
+#include <math.h>
+#include "robot_arm_shadow.h"
+
+// Accepted means the robot took this value (commanded angles are stored unrounded)
+#define ACK_TOLERANCE_RAD        0.005f
+// Servos settle within this much of the target
+#define REACHED_TOLERANCE_RAD    0.05f
+// Feedback older than this says nothing about where the arm is now
+#define FEEDBACK_FRESH_US        (1000 * 1000)
+// Time from acceptance for the arm to get there, and for an edit to be accepted at all.
+// The second covers streamed moves and sends whose failure is not reported, and outlasts
+// the HTTP timeout.
+#define SETTLE_TIMEOUT_US        (3000 * 1000)
+#define ACK_TIMEOUT_US           (8000 * 1000)
+
+void robot_arm_shadow_init(robot_arm_shadow_t *shadow)
+{
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        robot_arm_joint_shadow_t *joint = &shadow->joints[i];
+        joint->commanded = NAN;
+        joint->acked = NAN;
+        joint->measured = NAN;
+        joint->commanded_us = 0;
+        joint->acked_us = 0;
+        joint->measured_us = 0;
+        joint->generation = 0;
+        joint->adopted = false;
+        joint->state = ROBOT_ARM_SHADOW_SETTLED;
+        atomic_init(&shadow->failed_generation[i], 0);
+    }
+    shadow->generation = 0;
+}
+
+uint32_t robot_arm_shadow_command(robot_arm_shadow_t *shadow, int index, float radians, int64_t now_us)
+{
+    robot_arm_joint_shadow_t *joint = &shadow->joints[index];
+    joint->commanded = radians;
+    joint->commanded_us = now_us;
+    joint->generation = ++shadow->generation;
+    joint->adopted = false;
+    return joint->generation;
+}
+
+uint32_t robot_arm_shadow_generation(const robot_arm_shadow_t *shadow)
+{
+    return shadow->generation;
+}
+
+void robot_arm_shadow_fail(robot_arm_shadow_t *shadow, uint32_t joint_mask, uint32_t generation)
+{
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        if (!(joint_mask & (1u << i))) {
+            continue;
+        }
+        unsigned int seen = atomic_load(&shadow->failed_generation[i]);
+        while (generation > seen && !atomic_compare_exchange_weak(&shadow->failed_generation[i], &seen, generation)) {
+        }
+    }
+}
+
+robot_arm_shadow_state_t robot_arm_shadow_update(robot_arm_shadow_t *shadow, int index, float acked,
+                                                 float measured, int64_t measured_us, int64_t now_us)
+{
+    robot_arm_joint_shadow_t *joint = &shadow->joints[index];
+    joint->acked = acked;
+    if (!isnan(measured)) {
+        joint->measured = measured;
+        joint->measured_us = measured_us;
+    }
+    bool fresh = !isnan(joint->measured) && now_us - joint->measured_us < FEEDBACK_FRESH_US;
+
+    if (isnan(joint->commanded)) {
+        // Nothing commanded yet: whatever the robot reports is the truth to show
+        joint->state = fresh ? ROBOT_ARM_SHADOW_DIVERGED : ROBOT_ARM_SHADOW_SETTLED;
+        return joint->state;
+    }
+
+    // A failure only counts if no newer edit of this joint was made after the failed send
+    bool failed = !joint->adopted && atomic_load(&shadow->failed_generation[index]) >= joint->generation;
+    bool accepted = joint->adopted || (!isnan(acked) && fabsf(acked - joint->commanded) <= ACK_TOLERANCE_RAD);
+    if (accepted && joint->acked_us < joint->commanded_us) {
+        joint->acked_us = now_us;
+    }
+
+    if (failed || (!accepted && now_us - joint->commanded_us > ACK_TIMEOUT_US)) {
+        joint->state = ROBOT_ARM_SHADOW_FAILED;
+    } else if (!accepted) {
+        joint->state = ROBOT_ARM_SHADOW_IN_FLIGHT;
+    } else if (fresh && fabsf(joint->measured - joint->commanded) > REACHED_TOLERANCE_RAD) {
+        joint->state = (now_us - joint->acked_us > SETTLE_TIMEOUT_US) ? ROBOT_ARM_SHADOW_DIVERGED
+                                                                       : ROBOT_ARM_SHADOW_MOVING;
+    } else {
+        joint->state = ROBOT_ARM_SHADOW_SETTLED;
+    }
+    return joint->state;
+}
+
+void robot_arm_shadow_reconcile(robot_arm_shadow_t *shadow, int index, float radians, int64_t now_us)
+{
+    robot_arm_shadow_command(shadow, index, radians, now_us);
+    robot_arm_joint_shadow_t *joint = &shadow->joints[index];
+    joint->adopted = true;
+    joint->acked_us = now_us;
+    joint->state = ROBOT_ARM_SHADOW_SETTLED;
+}
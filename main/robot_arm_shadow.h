@@ -0,0 +1,53 @@
+#ifndef ROBOT_ARM_SHADOW_H
+#define ROBOT_ARM_SHADOW_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "robot_arm_comm.h"
+
+// Shadow state of each joint as the UI sees it: what the operator commanded, what the robot
+// last accepted, and what it last reported. The UI shows the commanded value at once and
+// uses the other two to tell whether that value is true yet. Owned by the UI task, except
+// robot_arm_shadow_fail(), which the comm task may call. Pure C, checked on the host by
+// tools/host_bench/test_shadow.c.
+typedef enum {
+    ROBOT_ARM_SHADOW_SETTLED = 0,   // Accepted and, when feedback is fresh, reached
+    ROBOT_ARM_SHADOW_IN_FLIGHT,     // Commanded, not yet accepted by the robot
+    ROBOT_ARM_SHADOW_MOVING,        // Accepted, the arm is still on its way
+    ROBOT_ARM_SHADOW_FAILED,        // The send failed or was never acknowledged
+    ROBOT_ARM_SHADOW_DIVERGED       // The arm is somewhere else than commanded (or nothing was commanded yet)
+} robot_arm_shadow_state_t;
+
+typedef struct {
+    float commanded;          // Value the UI shows (NAN until an edit or reconcile)
+    float acked;              // Last angle the robot accepted (NAN if none)
+    float measured;           // Last angle the robot reported (NAN if none)
+    int64_t commanded_us;     // When commanded last changed
+    int64_t acked_us;         // When acked first matched commanded
+    int64_t measured_us;      // When measured was reported
+    uint32_t generation;      // Edit sequence of the commanded value
+    bool adopted;             // Commanded was taken from the robot, so there is nothing to acknowledge
+    robot_arm_shadow_state_t state;
+} robot_arm_joint_shadow_t;
+
+typedef struct {
+    robot_arm_joint_shadow_t joints[ROBOT_ARM_JOINT_COUNT];
+    uint32_t generation;                                  // Last edit sequence handed out
+    atomic_uint failed_generation[ROBOT_ARM_JOINT_COUNT]; // Newest edit a failed send carried
+} robot_arm_shadow_t;
+
+// Function declarations
+void robot_arm_shadow_init(robot_arm_shadow_t *shadow);
+// Record an edit; returns its edit sequence, to be passed back with a failure
+uint32_t robot_arm_shadow_command(robot_arm_shadow_t *shadow, int index, float radians, int64_t now_us);
+uint32_t robot_arm_shadow_generation(const robot_arm_shadow_t *shadow);
+// A send carrying edits up to generation failed for the joints in joint_mask (bit = index); any task
+void robot_arm_shadow_fail(robot_arm_shadow_t *shadow, uint32_t joint_mask, uint32_t generation);
+// Feed the latest acknowledged and measured angles (NAN if unknown) and classify the joint
+robot_arm_shadow_state_t robot_arm_shadow_update(robot_arm_shadow_t *shadow, int index, float acked,
+                                                 float measured, int64_t measured_us, int64_t now_us);
+// Adopt a value from the robot as the new commanded one (after a failure or divergence)
+void robot_arm_shadow_reconcile(robot_arm_shadow_t *shadow, int index, float radians, int64_t now_us);
+
+#endif // ROBOT_ARM_SHADOW_H
@@ -0,0 +1,206 @@
+#include <string.h>
+#include <stdatomic.h>
+#include "esp_timer.h"
+#include "robot_arm_stats.h"
+
+// Histograms and counters are plain atomics updated with relaxed increments: the comm task
+// never waits on a reader, and readers accept a snapshot that is a few samples out of step.
+typedef struct {
+    robot_arm_latency_hist_t latency[ROBOT_ARM_STATS_STAGE_COUNT];
+    atomic_uint sent;
+    atomic_uint failures;
+    atomic_uint timeouts;
+} type_stats_t;
+
+static type_stats_t type_stats[ROBOT_ARM_CMD_TYPE_COUNT];
+static robot_arm_latency_hist_t radio_latency[ROBOT_ARM_RADIO_MODE_COUNT];
+static atomic_uint radio_sent[ROBOT_ARM_RADIO_MODE_COUNT];
+
+static const int type_codes[ROBOT_ARM_CMD_TYPE_COUNT] = {
+    [ROBOT_ARM_CMD_MOVE_JOINT] = 101,
+    [ROBOT_ARM_CMD_MOVE_JOINTS] = 102,
+    [ROBOT_ARM_CMD_LED] = 114,
+    [ROBOT_ARM_CMD_TORQUE] = 210,
+    [ROBOT_ARM_CMD_HOME] = 100,
+    [ROBOT_ARM_CMD_FEEDBACK] = 105,
+};
+
+// Bucket of a latency: magnitude from the highest set bit, then two bits below it
+static int bucket_index(uint32_t us)
+{
+    if (us < ROBOT_ARM_STATS_SUB_BUCKETS) {
+        return (int)us;
+    }
+    int magnitude = 31 - __builtin_clz(us);                      // >= 2
+    int sub = (int)((us >> (magnitude - 2)) & (ROBOT_ARM_STATS_SUB_BUCKETS - 1));
+    int index = (magnitude - 1) * ROBOT_ARM_STATS_SUB_BUCKETS + sub;
+    return (index < ROBOT_ARM_STATS_BUCKETS) ? index : ROBOT_ARM_STATS_BUCKETS - 1;
+}
+
+// Upper bound (us) of the values that land in a bucket
+static uint32_t bucket_upper_us(int index)
+{
+    if (index < ROBOT_ARM_STATS_SUB_BUCKETS) {
+        return (uint32_t)index;
+    }
+    int magnitude = index / ROBOT_ARM_STATS_SUB_BUCKETS + 1;
+    uint32_t sub = (uint32_t)(index % ROBOT_ARM_STATS_SUB_BUCKETS);
+    return ((ROBOT_ARM_STATS_SUB_BUCKETS + sub + 1) << (magnitude - 2)) - 1;
+}
+
+static uint32_t clamp_us(int64_t us)
+{
+    if (us < 0) return 0;
+    if (us > UINT32_MAX) return UINT32_MAX;
+    return (uint32_t)us;
+}
+
+void robot_arm_latency_record(robot_arm_latency_hist_t *hist, int64_t us)
+{
+    uint32_t value = clamp_us(us);
+    atomic_fetch_add_explicit(&hist->buckets[bucket_index(value)], 1, memory_order_relaxed);
+
+    unsigned int max = atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+    while (value > max &&
+           !atomic_compare_exchange_weak_explicit(&hist->max_us, &max, value,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+uint32_t robot_arm_latency_percentile(robot_arm_latency_hist_t *hist, float percentile)
+{
+    // Copy the buckets once so the count and the walk agree
+    uint32_t counts[ROBOT_ARM_STATS_BUCKETS];
+    uint64_t total = 0;
+    for (int i = 0; i < ROBOT_ARM_STATS_BUCKETS; i++) {
+        counts[i] = atomic_load_explicit(&hist->buckets[i], memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // The top bucket's upper bound can lie well above anything recorded
+    uint32_t max = robot_arm_latency_max(hist);
+
+    uint64_t target = (uint64_t)((double)total * percentile / 100.0 + 0.5);
+    if (target == 0) {
+        target = 1;
+    }
+    uint64_t seen = 0;
+    for (int i = 0; i < ROBOT_ARM_STATS_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= target) {
+            uint32_t upper = bucket_upper_us(i);
+            return (upper < max) ? upper : max;
+        }
+    }
+    return max;
+}
+
+uint32_t robot_arm_latency_max(robot_arm_latency_hist_t *hist)
+{
+    return atomic_load_explicit(&hist->max_us, memory_order_relaxed);
+}
+
+void robot_arm_latency_reset(robot_arm_latency_hist_t *hist)
+{
+    for (int i = 0; i < ROBOT_ARM_STATS_BUCKETS; i++) {
+        atomic_store_explicit(&hist->buckets[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&hist->max_us, 0, memory_order_relaxed);
+}
+
+void robot_arm_stats_record(robot_arm_cmd_type_t type, int64_t queue_us, int64_t wire_us, robot_arm_comm_status_t result)
+{
+    if (type < 0 || type >= ROBOT_ARM_CMD_TYPE_COUNT) {
+        return;
+    }
+
+    type_stats_t *stats = &type_stats[type];
+    robot_arm_latency_record(&stats->latency[ROBOT_ARM_STATS_QUEUE], queue_us);
+    robot_arm_latency_record(&stats->latency[ROBOT_ARM_STATS_WIRE], wire_us);
+
+    atomic_fetch_add_explicit(&stats->sent, 1, memory_order_relaxed);
+    if (result != ROBOT_ARM_COMM_OK) {
+        atomic_fetch_add_explicit(&stats->failures, 1, memory_order_relaxed);
+    }
+    if (result == ROBOT_ARM_COMM_TIMEOUT) {
+        atomic_fetch_add_explicit(&stats->timeouts, 1, memory_order_relaxed);
+    }
+}
+
+void robot_arm_stats_record_radio(robot_arm_radio_mode_t mode, int64_t wire_us)
+{
+    if (mode < 0 || mode >= ROBOT_ARM_RADIO_MODE_COUNT) {
+        return;
+    }
+    robot_arm_latency_record(&radio_latency[mode], wire_us);
+    atomic_fetch_add_explicit(&radio_sent[mode], 1, memory_order_relaxed);
+}
+
+uint32_t robot_arm_stats_percentile_us(robot_arm_cmd_type_t type, robot_arm_stats_stage_t stage, float percentile)
+{
+    if (type < 0 || type >= ROBOT_ARM_CMD_TYPE_COUNT || stage < 0 || stage >= ROBOT_ARM_STATS_STAGE_COUNT) {
+        return 0;
+    }
+    return robot_arm_latency_percentile(&type_stats[type].latency[stage], percentile);
+}
+
+void robot_arm_stats_get(robot_arm_stats_t *stats)
+{
+    if (!stats) {
+        return;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    stats->timestamp_us = esp_timer_get_time();
+    for (int type = 0; type < ROBOT_ARM_CMD_TYPE_COUNT; type++) {
+        robot_arm_cmd_stats_t *out = &stats->per_type[type];
+        out->sent = atomic_load_explicit(&type_stats[type].sent, memory_order_relaxed);
+        out->failures = atomic_load_explicit(&type_stats[type].failures, memory_order_relaxed);
+        out->timeouts = atomic_load_explicit(&type_stats[type].timeouts, memory_order_relaxed);
+        for (int stage = 0; stage < ROBOT_ARM_STATS_STAGE_COUNT; stage++) {
+            out->p50_us[stage] = robot_arm_stats_percentile_us(type, stage, 50.0f);
+            out->p99_us[stage] = robot_arm_stats_percentile_us(type, stage, 99.0f);
+            out->max_us[stage] = robot_arm_latency_max(&type_stats[type].latency[stage]);
+        }
+        stats->total_sent += out->sent;
+        stats->total_failures += out->failures;
+        stats->total_timeouts += out->timeouts;
+    }
+    for (int mode = 0; mode < ROBOT_ARM_RADIO_MODE_COUNT; mode++) {
+        stats->radio_sent[mode] = atomic_load_explicit(&radio_sent[mode], memory_order_relaxed);
+        stats->radio_p50_us[mode] = robot_arm_latency_percentile(&radio_latency[mode], 50.0f);
+        stats->radio_p99_us[mode] = robot_arm_latency_percentile(&radio_latency[mode], 99.0f);
+    }
+}
+
+float robot_arm_stats_rate(const robot_arm_stats_t *previous, const robot_arm_stats_t *current)
+{
+    int64_t elapsed_us = current->timestamp_us - previous->timestamp_us;
+    if (elapsed_us <= 0) {
+        return 0.0f;
+    }
+    return (float)(current->total_sent - previous->total_sent) * 1000000.0f / (float)elapsed_us;
+}
+
+void robot_arm_stats_reset(void)
+{
+    for (int type = 0; type < ROBOT_ARM_CMD_TYPE_COUNT; type++) {
+        for (int stage = 0; stage < ROBOT_ARM_STATS_STAGE_COUNT; stage++) {
+            robot_arm_latency_reset(&type_stats[type].latency[stage]);
+        }
+        atomic_store_explicit(&type_stats[type].sent, 0, memory_order_relaxed);
+        atomic_store_explicit(&type_stats[type].failures, 0, memory_order_relaxed);
+        atomic_store_explicit(&type_stats[type].timeouts, 0, memory_order_relaxed);
+    }
+    for (int mode = 0; mode < ROBOT_ARM_RADIO_MODE_COUNT; mode++) {
+        robot_arm_latency_reset(&radio_latency[mode]);
+        atomic_store_explicit(&radio_sent[mode], 0, memory_order_relaxed);
+    }
+}
+
+int robot_arm_stats_type_code(robot_arm_cmd_type_t type)
+{
+    return (type >= 0 && type < ROBOT_ARM_CMD_TYPE_COUNT) ? type_codes[type] : 0;
+}
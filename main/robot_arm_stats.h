@@ -0,0 +1,80 @@
+#ifndef ROBOT_ARM_STATS_H
+#define ROBOT_ARM_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "robot_arm_comm.h"
+
+// Log-bucketed (HDR-style) latency histogram: each power-of-two range of microseconds is split
+// into ROBOT_ARM_STATS_SUB_BUCKETS linear sub-buckets, so relative error stays under 25%
+// from 1 us up to ~16 s.
+#define ROBOT_ARM_STATS_SUB_BUCKETS   4
+#define ROBOT_ARM_STATS_MAGNITUDES    24
+#define ROBOT_ARM_STATS_BUCKETS       (ROBOT_ARM_STATS_MAGNITUDES * ROBOT_ARM_STATS_SUB_BUCKETS)
+
+// One lock-free latency histogram; zero-initialized storage is an empty histogram
+typedef struct {
+    atomic_uint buckets[ROBOT_ARM_STATS_BUCKETS];
+    atomic_uint max_us;
+} robot_arm_latency_hist_t;
+
+// Where the time of a command went
+typedef enum {
+    ROBOT_ARM_STATS_QUEUE,    // From robot_arm_submit() until the comm task picked it up
+    ROBOT_ARM_STATS_WIRE,     // Encoding plus transport send (HTTP round trip, frame write, ...)
+    ROBOT_ARM_STATS_STAGE_COUNT
+} robot_arm_stats_stage_t;
+
+// Counters for one command type
+typedef struct {
+    uint32_t sent;            // Commands dispatched (any result)
+    uint32_t failures;        // Dispatched commands that did not succeed (timeouts included)
+    uint32_t timeouts;
+    uint32_t p50_us[ROBOT_ARM_STATS_STAGE_COUNT];
+    uint32_t p99_us[ROBOT_ARM_STATS_STAGE_COUNT];
+    uint32_t max_us[ROBOT_ARM_STATS_STAGE_COUNT];
+} robot_arm_cmd_stats_t;
+
+// Radio power mode a command went out in, to show what WiFi modem sleep costs on the wire
+typedef enum {
+    ROBOT_ARM_RADIO_AWAKE,          // No power save
+    ROBOT_ARM_RADIO_POWER_SAVE,     // Modem sleep: replies can wait for the next DTIM beacon
+    ROBOT_ARM_RADIO_MODE_COUNT
+} robot_arm_radio_mode_t;
+
+// Snapshot of all comm statistics
+typedef struct {
+    int64_t timestamp_us;                                  // When the snapshot was taken
+    uint32_t total_sent;
+    uint32_t total_failures;
+    uint32_t total_timeouts;
+    robot_arm_cmd_stats_t per_type[ROBOT_ARM_CMD_TYPE_COUNT];
+    // Wire latency of WiFi sends (every command type) by radio power mode
+    uint32_t radio_sent[ROBOT_ARM_RADIO_MODE_COUNT];
+    uint32_t radio_p50_us[ROBOT_ARM_RADIO_MODE_COUNT];
+    uint32_t radio_p99_us[ROBOT_ARM_RADIO_MODE_COUNT];
+} robot_arm_stats_t;
+
+// Histogram primitives, safe from any task
+void robot_arm_latency_record(robot_arm_latency_hist_t *hist, int64_t us);
+// Upper bound of the bucket the percentile falls in, never above the largest value recorded
+uint32_t robot_arm_latency_percentile(robot_arm_latency_hist_t *hist, float percentile);
+uint32_t robot_arm_latency_max(robot_arm_latency_hist_t *hist);
+void robot_arm_latency_reset(robot_arm_latency_hist_t *hist);
+
+// Record one dispatched command (comm task; lock-free)
+void robot_arm_stats_record(robot_arm_cmd_type_t type, int64_t queue_us, int64_t wire_us, robot_arm_comm_status_t result);
+// Record the wire time of one WiFi send under the radio power mode it went out in
+void robot_arm_stats_record_radio(robot_arm_radio_mode_t mode, int64_t wire_us);
+
+// Query
+void robot_arm_stats_get(robot_arm_stats_t *stats);
+uint32_t robot_arm_stats_percentile_us(robot_arm_cmd_type_t type, robot_arm_stats_stage_t stage, float percentile);
+float robot_arm_stats_rate(const robot_arm_stats_t *previous, const robot_arm_stats_t *current); // Commands/s between two snapshots
+void robot_arm_stats_reset(void);
+
+// Robot protocol code ("T") of a command type, e.g. 101 for ROBOT_ARM_CMD_MOVE_JOINT
+int robot_arm_stats_type_code(robot_arm_cmd_type_t type);
+
+#endif // ROBOT_ARM_STATS_H
@@ -0,0 +1,147 @@
+#include <string.h>
+#include <math.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "robot_arm_stream.h"
+
+static const char *STREAM_TAG = "ROBOT_STREAM";
+
+static esp_timer_handle_t stream_timer = NULL;
+static robot_arm_traj_limits_t stream_limits[ROBOT_ARM_JOINT_COUNT];
+static robot_arm_traj_state_t stream_joints[ROBOT_ARM_JOINT_COUNT];  // Timer task only
+static int stream_speed = 0;
+static int stream_acceleration = 0;
+
+// Targets are written by the UI and read by the timer task. An adopted angle (NAN if none)
+// re-seats a joint where the robot reported it, without moving it.
+static float stream_targets[ROBOT_ARM_JOINT_COUNT];
+static float stream_adopted[ROBOT_ARM_JOINT_COUNT] = { NAN, NAN, NAN, NAN };
+static portMUX_TYPE stream_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// One streaming period: step every joint and send the new setpoints together
+static void stream_timer_cb(void *arg)
+{
+    float targets[ROBOT_ARM_JOINT_COUNT];
+    float adopted[ROBOT_ARM_JOINT_COUNT];
+    portENTER_CRITICAL(&stream_lock);
+    memcpy(targets, stream_targets, sizeof(targets));
+    memcpy(adopted, stream_adopted, sizeof(adopted));
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        stream_adopted[i] = NAN;
+    }
+    portEXIT_CRITICAL(&stream_lock);
+
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        if (!isnan(adopted[i])) {
+            robot_arm_traj_reset(&stream_joints[i], &stream_limits[i], adopted[i], stream_joints[i].dt);
+        }
+    }
+
+    // Step a copy so the commanded angles only advance when the command was accepted
+    robot_arm_traj_state_t next[ROBOT_ARM_JOINT_COUNT];
+    memcpy(next, stream_joints, sizeof(next));
+
+    bool moving = false;
+    robot_arm_cmd_t cmd = {
+        .type = ROBOT_ARM_CMD_MOVE_JOINTS,
+        .joints = { .speed = stream_speed, .acceleration = stream_acceleration },
+    };
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        moving |= robot_arm_traj_step(&next[i], &stream_limits[i], targets[i]);
+        cmd.joints.radians[i] = next[i].position;
+    }
+    if (!moving) {
+        memcpy(stream_joints, next, sizeof(next));
+        return;
+    }
+
+    // The tick already paces the setpoints: each one goes out in order instead of being merged
+    // with the next in the paced all-joint slot, which would thin out the trajectory
+    if (robot_arm_submit_timed(&cmd, NULL, NULL) == ROBOT_ARM_COMM_OK) {
+        memcpy(stream_joints, next, sizeof(next));
+    }
+}
+
+esp_err_t robot_arm_stream_start(const robot_arm_traj_limits_t limits[ROBOT_ARM_JOINT_COUNT],
+                                 const float initial_radians[ROBOT_ARM_JOINT_COUNT],
+                                 int rate_hz, int speed, int acceleration)
+{
+    if (!limits || !initial_radians || rate_hz <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    robot_arm_stream_stop();
+
+    float dt = 1.0f / (float)rate_hz;
+    memcpy(stream_limits, limits, sizeof(stream_limits));
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        robot_arm_traj_reset(&stream_joints[i], &stream_limits[i], initial_radians[i], dt);
+    }
+    portENTER_CRITICAL(&stream_lock);
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        stream_targets[i] = stream_joints[i].position;
+        stream_adopted[i] = NAN;
+    }
+    portEXIT_CRITICAL(&stream_lock);
+    stream_speed = speed;
+    stream_acceleration = acceleration;
+
+    if (!stream_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = stream_timer_cb,
+            .name = "robot_stream",
+            .skip_unhandled_events = true,   // After a stall, resume the rate instead of bursting
+        };
+        esp_err_t err = esp_timer_create(&timer_args, &stream_timer);
+        if (err != ESP_OK) {
+            ESP_LOGE(STREAM_TAG, "Failed to create stream timer: %s", esp_err_to_name(err));
+            return err;
+        }
+    }
+
+    esp_err_t err = esp_timer_start_periodic(stream_timer, 1000000 / rate_hz);
+    if (err != ESP_OK) {
+        ESP_LOGE(STREAM_TAG, "Failed to start stream timer: %s", esp_err_to_name(err));
+        return err;
+    }
+
+    ESP_LOGI(STREAM_TAG, "Trajectory streaming at %d Hz", rate_hz);
+    return ESP_OK;
+}
+
+void robot_arm_stream_stop(void)
+{
+    if (stream_timer && esp_timer_is_active(stream_timer)) {
+        esp_timer_stop(stream_timer);
+        ESP_LOGI(STREAM_TAG, "Trajectory streaming stopped");
+    }
+}
+
+bool robot_arm_stream_is_running(void)
+{
+    return stream_timer && esp_timer_is_active(stream_timer);
+}
+
+void robot_arm_stream_set_target(robot_arm_joint_t joint, float radians)
+{
+    if (joint < ROBOT_ARM_JOINT_BASE || joint > ROBOT_ARM_JOINT_GRIPPER) {
+        return;
+    }
+
+    portENTER_CRITICAL(&stream_lock);
+    stream_targets[joint - ROBOT_ARM_JOINT_BASE] = radians;
+    portEXIT_CRITICAL(&stream_lock);
+}
+
+void robot_arm_stream_adopt(robot_arm_joint_t joint, float radians)
+{
+    if (joint < ROBOT_ARM_JOINT_BASE || joint > ROBOT_ARM_JOINT_GRIPPER) {
+        return;
+    }
+
+    portENTER_CRITICAL(&stream_lock);
+    stream_targets[joint - ROBOT_ARM_JOINT_BASE] = radians;
+    stream_adopted[joint - ROBOT_ARM_JOINT_BASE] = radians;
+    portEXIT_CRITICAL(&stream_lock);
+}
@@ -0,0 +1,24 @@
+#ifndef ROBOT_ARM_STREAM_H
+#define ROBOT_ARM_STREAM_H
+
+#include <stdbool.h>
+#include "esp_err.h"
+#include "robot_arm_comm.h"
+#include "robot_arm_traj.h"
+
+// Fixed-rate trajectory streamer. An esp_timer ticks at rate_hz; each tick moves every joint
+// one jerk-limited step from its commanded angle toward its latest target and submits one
+// all-joint command (T:102) while any joint is moving, unmerged and unpaced, so the robot gets
+// every setpoint. Idle ticks send nothing.
+esp_err_t robot_arm_stream_start(const robot_arm_traj_limits_t limits[ROBOT_ARM_JOINT_COUNT],
+                                 const float initial_radians[ROBOT_ARM_JOINT_COUNT],
+                                 int rate_hz, int speed, int acceleration);
+void robot_arm_stream_stop(void);
+bool robot_arm_stream_is_running(void);
+
+// Set the target of a joint; safe from any task
+void robot_arm_stream_set_target(robot_arm_joint_t joint, float radians);
+// Take a joint to be at radians already (where the robot reports it) and hold it there
+void robot_arm_stream_adopt(robot_arm_joint_t joint, float radians);
+
+#endif // ROBOT_ARM_STREAM_H
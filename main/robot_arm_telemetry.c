@@ -0,0 +1,133 @@
+#include <math.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "robot_arm_telemetry.h"
+#include "robot_arm_feedback.h"
+
+static const char *TELEMETRY_TAG = "ROBOT_TELEMETRY";
+
+// About a second of samples at 50 Hz, so a busy LVGL frame or two never loses any
+#define TELEMETRY_RING_LENGTH 64
+
+// The timer task writes at head, the consumer reads at tail; each index is only advanced by
+// its owner, so neither side takes a lock
+static robot_arm_telemetry_sample_t ring[TELEMETRY_RING_LENGTH];
+static atomic_uint ring_head = 0;
+static atomic_uint ring_tail = 0;
+static atomic_uint ring_overruns = 0;
+
+static esp_timer_handle_t sample_timer = NULL;
+
+// Take one sample (esp_timer task)
+static void sample_timer_cb(void *arg)
+{
+    (void)arg;
+    unsigned int head = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_acquire);
+    if (head - tail >= TELEMETRY_RING_LENGTH) {
+        atomic_fetch_add_explicit(&ring_overruns, 1, memory_order_relaxed);
+        return;
+    }
+
+    robot_arm_telemetry_sample_t *sample = &ring[head % TELEMETRY_RING_LENGTH];
+    sample->time_us = esp_timer_get_time();
+    robot_arm_get_commanded_joints(sample->commanded);
+
+    robot_arm_feedback_t feedback;
+    bool measured = robot_arm_get_feedback(&feedback);
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        sample->measured[i] = measured ? feedback.joint_rad[i] : NAN;
+    }
+
+    atomic_store_explicit(&ring_head, head + 1, memory_order_release);
+}
+
+esp_err_t robot_arm_telemetry_start(int rate_hz)
+{
+    if (rate_hz <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (!sample_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = sample_timer_cb,
+            .name = "telemetry",
+        };
+        esp_err_t err = esp_timer_create(&timer_args, &sample_timer);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    esp_timer_stop(sample_timer);
+    esp_err_t err = esp_timer_start_periodic(sample_timer, 1000000 / rate_hz);
+    if (err == ESP_OK) {
+        ESP_LOGI(TELEMETRY_TAG, "Sampling joints at %d Hz", rate_hz);
+    }
+    return err;
+}
+
+void robot_arm_telemetry_stop(void)
+{
+    if (sample_timer) {
+        esp_timer_stop(sample_timer);
+    }
+}
+
+bool robot_arm_telemetry_pop(robot_arm_telemetry_sample_t *sample)
+{
+    unsigned int tail = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&ring_head, memory_order_acquire);
+    if (tail == head) {
+        return false;
+    }
+
+    *sample = ring[tail % TELEMETRY_RING_LENGTH];
+    atomic_store_explicit(&ring_tail, tail + 1, memory_order_release);
+    return true;
+}
+
+uint32_t robot_arm_telemetry_get_overruns(void)
+{
+    return atomic_load(&ring_overruns);
+}
+
+void robot_arm_minmax_reset(robot_arm_minmax_t *bucket)
+{
+    bucket->min = 0.0f;
+    bucket->max = 0.0f;
+    bucket->min_first = true;
+    bucket->empty = true;
+}
+
+void robot_arm_minmax_add(robot_arm_minmax_t *bucket, float value)
+{
+    if (isnan(value)) {
+        return;
+    }
+
+    if (bucket->empty) {
+        bucket->min = value;
+        bucket->max = value;
+        bucket->min_first = true;
+        bucket->empty = false;
+    } else if (value < bucket->min) {
+        bucket->min = value;
+        bucket->min_first = false;   // The new minimum comes after the maximum
+    } else if (value > bucket->max) {
+        bucket->max = value;
+        bucket->min_first = true;
+    }
+}
+
+bool robot_arm_minmax_get(const robot_arm_minmax_t *bucket, float *first, float *second)
+{
+    if (bucket->empty) {
+        return false;
+    }
+
+    *first = bucket->min_first ? bucket->min : bucket->max;
+    *second = bucket->min_first ? bucket->max : bucket->min;
+    return true;
+}
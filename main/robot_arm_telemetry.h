@@ -0,0 +1,40 @@
+#ifndef ROBOT_ARM_TELEMETRY_H
+#define ROBOT_ARM_TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "robot_arm_comm.h"
+
+// Joint telemetry: an esp_timer samples the commanded and measured angles of every joint into a
+// lock-free single-producer / single-consumer ring, which the UI drains at its own pace. When
+// the consumer falls behind, new samples are dropped and counted rather than blocking the timer.
+typedef struct {
+    int64_t time_us;                                // esp_timer time of the sample
+    float commanded[ROBOT_ARM_JOINT_COUNT];         // Angles the robot last accepted (NAN if never)
+    float measured[ROBOT_ARM_JOINT_COUNT];          // Angles the robot last reported (NAN if none yet)
+} robot_arm_telemetry_sample_t;
+
+// Min/max decimation of one signal: many samples fold into one bucket, which is drawn as its
+// extremes in the order they occurred, so spikes survive at any zoom. The ring and the buckets
+// are checked on the host by tools/host_bench/test_telemetry.c.
+typedef struct {
+    float min;
+    float max;
+    bool min_first;   // The minimum came before the maximum
+    bool empty;
+} robot_arm_minmax_t;
+
+// Function declarations
+esp_err_t robot_arm_telemetry_start(int rate_hz);   // Safe to call again (restarts at the new rate)
+void robot_arm_telemetry_stop(void);
+// Take the oldest unread sample (one consumer task only). Returns false when the ring is empty.
+bool robot_arm_telemetry_pop(robot_arm_telemetry_sample_t *sample);
+uint32_t robot_arm_telemetry_get_overruns(void);    // Samples dropped because the ring was full
+
+void robot_arm_minmax_reset(robot_arm_minmax_t *bucket);
+void robot_arm_minmax_add(robot_arm_minmax_t *bucket, float value);   // NAN values are skipped
+// The bucket's extremes in time order; false if no value was added
+bool robot_arm_minmax_get(const robot_arm_minmax_t *bucket, float *first, float *second);
+
+#endif // ROBOT_ARM_TELEMETRY_H
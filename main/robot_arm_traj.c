@@ -0,0 +1,78 @@
+#include <math.h>
+#include "robot_arm_traj.h"
+
+// Within this distance of the target the output snaps onto it
+#define SETTLE_POSITION_RAD  0.0005f
+
+static float clampf(float value, float low, float high)
+{
+    return (value < low) ? low : (value > high) ? high : value;
+}
+
+void robot_arm_traj_reset(robot_arm_traj_state_t *state, const robot_arm_traj_limits_t *limits, float position, float dt)
+{
+    position = clampf(position, limits->min_rad, limits->max_rad);
+    state->position = position;
+    state->velocity = 0.0f;
+    state->dt = dt;
+    state->ramp_position = position;
+    state->ramp_velocity = 0.0f;
+
+    // A window of T seconds spreads each acceleration change of the trapezoid (up to
+    // 2 * a_max when it flips from speeding up to braking) over T, so jerk <= 2 * a_max / T
+    int taps = (int)ceilf(2.0f * limits->max_acceleration / (limits->max_jerk * dt));
+    state->taps = (taps < 1) ? 1 : (taps > ROBOT_ARM_TRAJ_MAX_TAPS) ? ROBOT_ARM_TRAJ_MAX_TAPS : taps;
+    for (int i = 0; i < state->taps; i++) {
+        state->history[i] = position;
+    }
+    state->history_sum = position * state->taps;
+    state->head = 0;
+}
+
+bool robot_arm_traj_step(robot_arm_traj_state_t *state, const robot_arm_traj_limits_t *limits, float target)
+{
+    float dt = state->dt;
+    target = clampf(target, limits->min_rad, limits->max_rad);
+
+    if (state->ramp_position == target && state->ramp_velocity == 0.0f &&
+        fabsf(state->position - target) <= SETTLE_POSITION_RAD) {
+        // Settled: drop the averaging residue so the output lands exactly on the target
+        if (state->position != target || state->velocity != 0.0f) {
+            robot_arm_traj_reset(state, limits, target, dt);
+        }
+        return false;
+    }
+
+    // Trapezoidal stage: fastest speed from which a discrete brake stops exactly on the target.
+    // Braking n whole steps of a_max covers a_dt * dt * n(n+1)/2; the rest is spread over the
+    // n + 1 steps, so the last one ends below a_dt and the stop stays within a_max.
+    float error = target - state->ramp_position;
+    float a_dt = limits->max_acceleration * dt;
+    float distance = fabsf(error);
+    float steps = floorf(sqrtf(0.25f + 2.0f * distance / (a_dt * dt)) - 0.5f);
+    float rest = fmaxf(distance - a_dt * dt * steps * (steps + 1.0f) * 0.5f, 0.0f);
+    float v_stop = a_dt * steps + rest / ((steps + 1.0f) * dt);
+    v_stop = fminf(fminf(v_stop, distance / dt), limits->max_velocity);
+    float v_target = copysignf(v_stop, error);
+
+    state->ramp_velocity += clampf(v_target - state->ramp_velocity, -a_dt, a_dt);
+    state->ramp_position += state->ramp_velocity * dt;
+    if ((error > 0.0f && state->ramp_position >= target) || (error < 0.0f && state->ramp_position <= target) ||
+        error == 0.0f) {
+        if (fabsf(state->ramp_velocity) <= a_dt) {
+            state->ramp_position = target;
+            state->ramp_velocity = 0.0f;
+        }
+    }
+    state->ramp_position = clampf(state->ramp_position, limits->min_rad, limits->max_rad);
+
+    // Smoothing stage
+    state->history_sum += state->ramp_position - state->history[state->head];
+    state->history[state->head] = state->ramp_position;
+    state->head = (state->head + 1) % state->taps;
+
+    float previous = state->position;
+    state->position = clampf(state->history_sum / state->taps, limits->min_rad, limits->max_rad);
+    state->velocity = (state->position - previous) / dt;
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef ROBOT_ARM_TRAJ_H
+#define ROBOT_ARM_TRAJ_H
+
+#include <stdbool.h>
+
+// Jerk-limited online interpolation of one joint toward a moving target, in two stages:
+// an acceleration-limited (trapezoidal) tracker that brakes in time to stop on the target,
+// followed by a moving average over 2 * a_max / j_max seconds (the trapezoid's acceleration can
+// flip from +a_max to -a_max in one step), which turns it into an S-curve whose jerk stays within
+// the limit. Pure C; tools/host_bench/test_traj.c checks the limits on the host.
+#define ROBOT_ARM_TRAJ_MAX_TAPS 32
+
+typedef struct {
+    float min_rad;
+    float max_rad;
+    float max_velocity;       // rad/s
+    float max_acceleration;   // rad/s^2
+    float max_jerk;           // rad/s^3
+} robot_arm_traj_limits_t;
+
+typedef struct {
+    float position;           // Commanded angle (rad), the smoothed output
+    float velocity;           // rad/s of the output
+    float dt;                 // Step period (s)
+    // Trapezoidal stage
+    float ramp_position;
+    float ramp_velocity;
+    // Moving average over the last taps ramp positions
+    float history[ROBOT_ARM_TRAJ_MAX_TAPS];
+    float history_sum;
+    int taps;
+    int head;
+} robot_arm_traj_state_t;
+
+// Function declarations
+void robot_arm_traj_reset(robot_arm_traj_state_t *state, const robot_arm_traj_limits_t *limits, float position, float dt);
+// Advance one step toward target. Returns true while the joint is still moving.
+bool robot_arm_traj_step(robot_arm_traj_state_t *state, const robot_arm_traj_limits_t *limits, float target);
+
+#endif // ROBOT_ARM_TRAJ_H
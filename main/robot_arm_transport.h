@@ -0,0 +1,45 @@
+#ifndef ROBOT_ARM_TRANSPORT_H
+#define ROBOT_ARM_TRANSPORT_H
+
+#include <stdbool.h>
+#include "robot_arm_comm.h"
+
+// Wire form a transport expects its commands in
+typedef enum {
+    ROBOT_ARM_PAYLOAD_JSON,         // Raw JSON text: {"T":101,...}
+    ROBOT_ARM_PAYLOAD_HTTP_PATH     // Request path with URL-encoded JSON: /js?json=%7B%22T%22...
+} robot_arm_payload_t;
+
+// How long one send may take, set per command class by the comm layer. A lost reply is taken as
+// lost after timeout_ms and the command resent with twice the wait, until budget_ms is spent.
+// superseded(context), if set, is asked before every resend: once a newer command made this one
+// pointless it is given up at once instead of waited out.
+typedef struct {
+    uint32_t timeout_ms;                        // Wait for the first reply
+    uint32_t budget_ms;                         // Total time across resends
+    bool (*superseded)(const void *context);
+    const void *context;
+    uint32_t attempts;                          // Out: times the command went on the wire
+} robot_arm_send_limits_t;
+
+// A way of getting JSON commands to the robot. All functions are called from the comm task only,
+// except that the priority task owns robot_arm_transport_http_priority and may also call
+// robot_arm_transport_uart.send(), which writes each command as one atomic driver write.
+typedef struct {
+    const char *name;
+    bool needs_wifi;                                        // Commands can only flow with WiFi up
+    robot_arm_payload_t payload;                            // Form send() expects
+    bool (*open)(const char *robot_ip);                     // Prepare a session to the robot
+    void (*close)(void);                                    // Tear the session down
+    // Send one encoded command; limits may be NULL for the transport's own timeouts
+    robot_arm_comm_status_t (*send)(const char *payload, robot_arm_send_limits_t *limits);
+    void (*get_stats)(robot_arm_session_stats_t *stats);    // Session counters since boot
+} robot_arm_transport_t;
+
+// Available backends
+extern const robot_arm_transport_t robot_arm_transport_http;  // HTTP GET /js?json=<url-encoded json>
+extern const robot_arm_transport_t robot_arm_transport_http_priority;  // Same, on a second connection for safety commands
+extern const robot_arm_transport_t robot_arm_transport_ws;    // JSON text frames on one WebSocket
+extern const robot_arm_transport_t robot_arm_transport_uart;  // Newline-delimited JSON on a UART
+
+#endif // ROBOT_ARM_TRANSPORT_H
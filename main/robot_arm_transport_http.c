@@ -0,0 +1,284 @@
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_http_client.h"
+#include "robot_arm_transport.h"
+#include "robot_arm_http_session.h"
+#include "robot_arm_feedback.h"
+
+static const char *HTTP_TAG = "ROBOT_HTTP";
+
+// Reply waits for sends without limits; the comm layer passes its own per command class
+#define HTTP_TIMEOUT_MS 5000
+// The priority session gives up sooner: a stop that cannot get through must fail fast
+#define HTTP_PRIORITY_TIMEOUT_MS 1000
+// Resends of one command, and the shortest wait worth another one
+#define HTTP_MAX_ATTEMPTS 4
+#define HTTP_MIN_WAIT_MS  10
+#define HTTP_BUFFER_SIZE ROBOT_ARM_HTTP_BUFFER_SIZE
+
+// Each transport owns a session, so the priority lane never waits behind a command in flight
+// on the main one
+static robot_arm_http_session_t command_session = {
+    .name = "command", .timeout_ms = HTTP_TIMEOUT_MS, .ingest_feedback = true,
+};
+static robot_arm_http_session_t priority_session = {
+    .name = "priority", .timeout_ms = HTTP_PRIORITY_TIMEOUT_MS, .ingest_feedback = true,
+};
+
+// HTTP event handler
+static esp_err_t http_event_handler(esp_http_client_event_t *evt)
+{
+    robot_arm_http_session_t *session = (robot_arm_http_session_t *)evt->user_data;
+
+    switch (evt->event_id) {
+        case HTTP_EVENT_ERROR:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_ERROR");
+            break;
+        case HTTP_EVENT_ON_CONNECTED:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_ON_CONNECTED");
+            session->connected = true;
+            break;
+        case HTTP_EVENT_HEADER_SENT:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_HEADER_SENT");
+            break;
+        case HTTP_EVENT_ON_HEADER:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_ON_HEADER, key=%s, value=%s", evt->header_key, evt->header_value);
+            break;
+        case HTTP_EVENT_ON_HEADERS_COMPLETE:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_ON_HEADERS_COMPLETE");
+            break;
+        case HTTP_EVENT_ON_DATA:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_ON_DATA, len=%d", evt->data_len);
+            if (evt->data_len < HTTP_BUFFER_SIZE - session->response_len) {
+                memcpy(session->response + session->response_len, evt->data, evt->data_len);
+                session->response_len += evt->data_len;
+                session->response[session->response_len] = '\0';
+            }
+            break;
+        case HTTP_EVENT_ON_FINISH:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_ON_FINISH");
+            break;
+        case HTTP_EVENT_DISCONNECTED:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_DISCONNECTED");
+            break;
+        case HTTP_EVENT_REDIRECT:
+            ESP_LOGD(HTTP_TAG, "HTTP_EVENT_REDIRECT");
+            break;
+    }
+    return ESP_OK;
+}
+
+// Open the persistent HTTP session (the TCP connection itself is made lazily on first perform)
+static bool http_session_open(robot_arm_http_session_t *session)
+{
+    char base_url[40];
+    snprintf(base_url, sizeof(base_url), "http://%s/js", session->robot_ip);
+
+    esp_http_client_config_t config = {
+        .url = base_url,
+        .event_handler = http_event_handler,
+        .user_data = session,
+        .timeout_ms = session->timeout_ms,
+        .buffer_size = HTTP_BUFFER_SIZE,
+        .keep_alive_enable = true,
+    };
+
+    session->client = esp_http_client_init(&config);
+    if (!session->client) {
+        ESP_LOGE(HTTP_TAG, "Failed to initialize HTTP %s session", session->name);
+        return false;
+    }
+    session->applied_timeout_ms = session->timeout_ms;
+    return true;
+}
+
+// Wait at most timeout_ms for the next reply; applies to an open socket as well
+static void http_session_set_timeout(robot_arm_http_session_t *session, int timeout_ms)
+{
+    if (session->applied_timeout_ms != timeout_ms) {
+        esp_http_client_set_timeout_ms(session->client, timeout_ms);
+        session->applied_timeout_ms = timeout_ms;
+    }
+}
+
+// Tear down the persistent HTTP session and its socket
+void robot_arm_http_session_close(robot_arm_http_session_t *session)
+{
+    if (session->client) {
+        esp_http_client_close(session->client);
+        esp_http_client_cleanup(session->client);
+        session->client = NULL;
+    }
+}
+
+// Perform one GET on the persistent session, returning the transport error and HTTP status
+static esp_err_t http_session_perform(robot_arm_http_session_t *session, const char* path, int* status_code)
+{
+    // Reset response buffer
+    session->response_len = 0;
+    session->response[0] = '\0';
+    session->connected = false;
+
+    esp_err_t err = esp_http_client_set_url(session->client, path);
+    if (err == ESP_OK) {
+        err = esp_http_client_perform(session->client);
+    }
+    *status_code = esp_http_client_get_status_code(session->client);
+    return err;
+}
+
+bool robot_arm_http_session_start(robot_arm_http_session_t *session, const char *ip)
+{
+    strncpy(session->robot_ip, ip, sizeof(session->robot_ip) - 1);
+    session->robot_ip[sizeof(session->robot_ip) - 1] = '\0';
+    return http_session_open(session);
+}
+
+// The path is relative, so the client keeps the host and connection it already has. A failed
+// attempt leaves the socket in an unknown state (a late reply would answer the next request), so
+// it is closed and the command resent on a new one, waiting twice as long each time.
+robot_arm_comm_status_t robot_arm_http_session_send(robot_arm_http_session_t *session, const char *path,
+                                                    robot_arm_send_limits_t *limits)
+{
+    ESP_LOGD(HTTP_TAG, "Request path: %s", path);
+
+    // The robot may drop an idle keep-alive socket, so even without limits one resend is allowed
+    robot_arm_send_limits_t defaults = {
+        .timeout_ms = (uint32_t)session->timeout_ms, .budget_ms = 2 * (uint32_t)session->timeout_ms,
+    };
+    if (!limits) {
+        limits = &defaults;
+    }
+    limits->attempts = 0;
+
+    if (!session->client && !http_session_open(session)) {
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    session->stats.requests++;
+
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)limits->budget_ms * 1000;
+    uint32_t wait_ms = limits->timeout_ms;
+    int status_code = 0;
+    bool timed_out = false;
+    esp_err_t err;
+    while (1) {
+        int64_t left_ms = (deadline_us - esp_timer_get_time()) / 1000;
+        http_session_set_timeout(session, (int)((left_ms > HTTP_MIN_WAIT_MS && left_ms < wait_ms) ? left_ms : wait_ms));
+        limits->attempts++;
+        err = http_session_perform(session, path, &status_code);
+        if (err == ESP_OK) {
+            break;
+        }
+
+        // A socket timeout surfaces as EAGAIN; report it separately so latency stats can count it
+        int sock_errno = esp_http_client_get_errno(session->client);
+        timed_out = (err == ESP_ERR_HTTP_EAGAIN || sock_errno == EAGAIN || sock_errno == ETIMEDOUT);
+        robot_arm_http_session_close(session);
+
+        if (limits->superseded && limits->superseded(limits->context)) {
+            ESP_LOGD(HTTP_TAG, "HTTP %s request superseded after %lu attempts", session->name, (unsigned long)limits->attempts);
+            session->stats.cancelled++;
+            return timed_out ? ROBOT_ARM_COMM_TIMEOUT : ROBOT_ARM_COMM_ERROR;
+        }
+        left_ms = (deadline_us - esp_timer_get_time()) / 1000;
+        if (limits->attempts >= HTTP_MAX_ATTEMPTS || left_ms < HTTP_MIN_WAIT_MS) {
+            break;
+        }
+
+        ESP_LOGW(HTTP_TAG, "HTTP %s session error (%s), reconnecting", session->name, esp_err_to_name(err));
+        session->stats.reconnects++;
+        if (!http_session_open(session)) {
+            session->stats.failures++;
+            return ROBOT_ARM_COMM_ERROR;
+        }
+        wait_ms *= 2;
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGE(HTTP_TAG, "HTTP request failed: %s", esp_err_to_name(err));
+        session->stats.failures++;
+        return timed_out ? ROBOT_ARM_COMM_TIMEOUT : ROBOT_ARM_COMM_ERROR;
+    }
+
+    if (!session->connected) {
+        session->stats.reused++;
+    }
+
+    if (status_code != 200) {
+        ESP_LOGE(HTTP_TAG, "HTTP request failed with status code: %d", status_code);
+        session->stats.failures++;
+        return ROBOT_ARM_COMM_ERROR;
+    }
+
+    // Replies to status commands carry joint feedback
+    if (session->ingest_feedback && session->response_len > 0) {
+        robot_arm_feedback_ingest(session->response, session->response_len);
+    }
+
+    ESP_LOGD(HTTP_TAG, "Robot command sent successfully");
+    return ROBOT_ARM_COMM_OK;
+}
+
+static bool http_transport_open(const char *ip)
+{
+    return robot_arm_http_session_start(&command_session, ip);
+}
+
+static void http_transport_close(void)
+{
+    robot_arm_http_session_close(&command_session);
+}
+
+static robot_arm_comm_status_t http_transport_send(const char *path, robot_arm_send_limits_t *limits)
+{
+    return robot_arm_http_session_send(&command_session, path, limits);
+}
+
+static void http_transport_get_stats(robot_arm_session_stats_t *stats)
+{
+    *stats = command_session.stats;
+}
+
+static bool http_priority_open(const char *ip)
+{
+    return robot_arm_http_session_start(&priority_session, ip);
+}
+
+static void http_priority_close(void)
+{
+    robot_arm_http_session_close(&priority_session);
+}
+
+static robot_arm_comm_status_t http_priority_send(const char *path, robot_arm_send_limits_t *limits)
+{
+    return robot_arm_http_session_send(&priority_session, path, limits);
+}
+
+static void http_priority_get_stats(robot_arm_session_stats_t *stats)
+{
+    *stats = priority_session.stats;
+}
+
+const robot_arm_transport_t robot_arm_transport_http = {
+    .name = "HTTP",
+    .needs_wifi = true,
+    .payload = ROBOT_ARM_PAYLOAD_HTTP_PATH,
+    .open = http_transport_open,
+    .close = http_transport_close,
+    .send = http_transport_send,
+    .get_stats = http_transport_get_stats,
+};
+
+const robot_arm_transport_t robot_arm_transport_http_priority = {
+    .name = "HTTP priority",
+    .needs_wifi = true,
+    .payload = ROBOT_ARM_PAYLOAD_HTTP_PATH,
+    .open = http_priority_open,
+    .close = http_priority_close,
+    .send = http_priority_send,
+    .get_stats = http_priority_get_stats,
+};
@@ -0,0 +1,208 @@
+#include <string.h>
+#include <stdio.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/uart.h"
+#include "esp_log.h"
+#include "robot_arm_transport.h"
+#include "robot_arm_feedback.h"
+
+static const char *UART_TAG = "ROBOT_UART";
+
+// Wired link to the robot's serial port: newline-delimited JSON in both directions.
+// Commands are copied into the UART driver's TX ring buffer and drained by the driver's
+// interrupt handler, so send() returns without waiting for the bytes to leave the wire.
+#define UART_PORT             (CONFIG_ROBOT_ARM_UART_PORT)
+#define UART_TX_PIN           (CONFIG_ROBOT_ARM_UART_TX_PIN)
+#define UART_RX_PIN           (CONFIG_ROBOT_ARM_UART_RX_PIN)
+#define UART_BAUD_RATE        (CONFIG_ROBOT_ARM_UART_BAUD_RATE)
+#define UART_TX_BUFFER_SIZE   2048
+#define UART_RX_BUFFER_SIZE   1024
+#define UART_LINE_MAX         256
+#define UART_RX_TASK_STACK    3072
+#define UART_RX_TASK_PRIORITY 3
+#define UART_RX_POLL_MS       100
+
+// The priority task may send while the comm task closes the link: a sender counts itself in
+// uart_senders before it checks uart_ready, and close() waits for the count to drain after
+// clearing uart_ready, so the driver is never deleted under a write.
+static atomic_bool uart_ready = false;
+static atomic_uint uart_senders = 0;
+static atomic_bool rx_task_running = false;
+static atomic_bool rx_task_stop = false;
+static robot_arm_session_stats_t session_stats = {0};
+static volatile uint32_t rx_lines = 0;
+static volatile uint32_t rx_overflows = 0;
+
+// Handle one complete line received from the robot (feedback or command echo)
+static void uart_handle_line(const char *line, int len)
+{
+    rx_lines++;
+    ESP_LOGD(UART_TAG, "RX: %.*s", len, line);
+    robot_arm_feedback_ingest(line, len);
+}
+
+// Split the incoming byte stream into lines; overlong lines are dropped whole
+static void uart_rx_task(void *arg)
+{
+    (void)arg;
+    static char line[UART_LINE_MAX];
+    uint8_t chunk[64];
+    int line_len = 0;
+    bool discarding = false;
+
+    while (!atomic_load(&rx_task_stop)) {
+        int n = uart_read_bytes(UART_PORT, chunk, sizeof(chunk), pdMS_TO_TICKS(UART_RX_POLL_MS));
+        for (int i = 0; i < n; i++) {
+            char c = (char)chunk[i];
+            if (c == '\n') {
+                if (!discarding && line_len > 0) {
+                    if (line[line_len - 1] == '\r') {
+                        line_len--;
+                    }
+                    line[line_len] = '\0';
+                    uart_handle_line(line, line_len);
+                }
+                line_len = 0;
+                discarding = false;
+            } else if (!discarding) {
+                if (line_len < UART_LINE_MAX - 1) {
+                    line[line_len++] = c;
+                } else {
+                    rx_overflows++;
+                    discarding = true;
+                }
+            }
+        }
+    }
+
+    atomic_store(&rx_task_running, false);
+    vTaskDelete(NULL);
+}
+
+// Stop the RX task, which reads through the driver until it sees rx_task_stop
+static void uart_stop_rx_task(void)
+{
+    atomic_store(&rx_task_stop, true);
+    while (atomic_load(&rx_task_running)) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+}
+
+static bool uart_transport_open(const char *robot_ip)
+{
+    (void)robot_ip;  // Not addressed: the robot is on the other end of the cable
+
+    if (atomic_load(&uart_ready)) {
+        return true;
+    }
+
+    uart_config_t uart_config = {
+        .baud_rate = UART_BAUD_RATE,
+        .data_bits = UART_DATA_8_BITS,
+        .parity = UART_PARITY_DISABLE,
+        .stop_bits = UART_STOP_BITS_1,
+        .flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+        .source_clk = UART_SCLK_DEFAULT,
+    };
+
+    esp_err_t err = uart_driver_install(UART_PORT, UART_RX_BUFFER_SIZE, UART_TX_BUFFER_SIZE, 0, NULL, 0);
+    if (err != ESP_OK) {
+        ESP_LOGE(UART_TAG, "Failed to install UART%d driver: %s", UART_PORT, esp_err_to_name(err));
+        return false;
+    }
+    err = uart_param_config(UART_PORT, &uart_config);
+    if (err == ESP_OK) {
+        err = uart_set_pin(UART_PORT, UART_TX_PIN, UART_RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGE(UART_TAG, "Failed to set up UART%d: %s", UART_PORT, esp_err_to_name(err));
+        uart_driver_delete(UART_PORT);
+        return false;
+    }
+
+    atomic_store(&rx_task_stop, false);
+    atomic_store(&rx_task_running, true);
+    if (xTaskCreate(uart_rx_task, "robot_uart_rx", UART_RX_TASK_STACK, NULL,
+                    UART_RX_TASK_PRIORITY, NULL) != pdPASS) {
+        ESP_LOGE(UART_TAG, "Failed to create UART RX task");
+        atomic_store(&rx_task_running, false);
+        uart_driver_delete(UART_PORT);
+        return false;
+    }
+
+    atomic_store(&uart_ready, true);
+    session_stats.reconnects++;
+    ESP_LOGI(UART_TAG, "UART%d ready at %d baud (TX %d, RX %d)", UART_PORT, UART_BAUD_RATE, UART_TX_PIN, UART_RX_PIN);
+    return true;
+}
+
+static void uart_transport_close(void)
+{
+    if (!atomic_exchange(&uart_ready, false)) {
+        return;
+    }
+    while (atomic_load(&uart_senders) > 0) {
+        vTaskDelay(1);
+    }
+
+    // Give back the driver's buffers and interrupt while another transport carries commands
+    uart_stop_rx_task();
+    uart_driver_delete(UART_PORT);
+    ESP_LOGI(UART_TAG, "UART%d closed", UART_PORT);
+}
+
+// Writes never wait for a reply, so the limits have nothing to bound
+static robot_arm_comm_status_t uart_transport_send(const char *json, robot_arm_send_limits_t *limits)
+{
+    if (limits) {
+        limits->attempts = 1;
+    }
+
+    // One driver write per line, so a command from the priority task never lands inside another
+    char line[UART_LINE_MAX];
+    size_t len = strlen(json);
+    if (len + 1 > sizeof(line)) {
+        ESP_LOGE(UART_TAG, "Command too long for UART line");
+        session_stats.failures++;
+        return ROBOT_ARM_COMM_ERROR;
+    }
+    memcpy(line, json, len);
+    line[len++] = '\n';
+
+    robot_arm_comm_status_t status = ROBOT_ARM_COMM_OK;
+    atomic_fetch_add(&uart_senders, 1);
+    if (!atomic_load(&uart_ready)) {
+        status = ROBOT_ARM_COMM_NOT_CONNECTED;
+    } else {
+        session_stats.requests++;
+        if (uart_write_bytes(UART_PORT, line, len) != (int)len) {
+            ESP_LOGE(UART_TAG, "UART write failed");
+            status = ROBOT_ARM_COMM_ERROR;
+        }
+    }
+    atomic_fetch_sub(&uart_senders, 1);
+
+    if (status != ROBOT_ARM_COMM_OK) {
+        session_stats.failures++;
+        return status;
+    }
+    session_stats.reused++;
+    return ROBOT_ARM_COMM_OK;
+}
+
+static void uart_transport_get_stats(robot_arm_session_stats_t *stats)
+{
+    *stats = session_stats;
+}
+
+const robot_arm_transport_t robot_arm_transport_uart = {
+    .name = "UART",
+    .needs_wifi = false,
+    .payload = ROBOT_ARM_PAYLOAD_JSON,
+    .open = uart_transport_open,
+    .close = uart_transport_close,
+    .send = uart_transport_send,
+    .get_stats = uart_transport_get_stats,
+};
@@ -0,0 +1,156 @@
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_transport.h"
+#include "esp_transport_tcp.h"
+#include "esp_transport_ws.h"
+#include "robot_arm_transport.h"
+#include "robot_arm_feedback.h"
+
+static const char *WS_TAG = "ROBOT_WS";
+
+// One persistent WebSocket to the robot; each command is a single JSON text frame with no
+// URL encoding or HTTP headers. Point ROBOT_ARM_WS_PORT/PATH at a local stand-in to test.
+// Built on ESP-IDF's own tcp_transport WebSocket layer: the comm task sends synchronously
+// anyway, so frames are written and read on it directly and no client task is needed.
+#define WS_PORT               (CONFIG_ROBOT_ARM_WS_PORT)
+#define WS_PATH               (CONFIG_ROBOT_ARM_WS_PATH)
+#define WS_CONNECT_TIMEOUT_MS 3000
+#define WS_SEND_TIMEOUT_MS    1000
+#define WS_BUFFER_SIZE        1024
+
+// Only the status request is answered; its reply is waited for like an HTTP response
+#define WS_FEEDBACK_REQUEST   "{\"T\":105}"
+
+static esp_transport_handle_t tcp_transport = NULL;
+static esp_transport_handle_t ws_transport = NULL;
+static char rx_buffer[WS_BUFFER_SIZE];
+static robot_arm_session_stats_t session_stats = {0};
+
+static void ws_transport_close(void)
+{
+    if (ws_transport) {
+        esp_transport_close(ws_transport);
+        esp_transport_destroy(ws_transport);
+        ws_transport = NULL;
+    }
+    if (tcp_transport) {
+        esp_transport_destroy(tcp_transport);
+        tcp_transport = NULL;
+    }
+}
+
+static bool ws_transport_open(const char *robot_ip)
+{
+    tcp_transport = esp_transport_tcp_init();
+    ws_transport = tcp_transport ? esp_transport_ws_init(tcp_transport) : NULL;
+    if (!ws_transport) {
+        ESP_LOGE(WS_TAG, "Failed to initialize WebSocket transport");
+        ws_transport_close();
+        return false;
+    }
+    esp_transport_ws_set_path(ws_transport, WS_PATH);
+
+    // Connecting includes the upgrade handshake, so the first command does not race it
+    if (esp_transport_connect(ws_transport, robot_ip, WS_PORT, WS_CONNECT_TIMEOUT_MS) < 0) {
+        ESP_LOGW(WS_TAG, "WebSocket connect to ws://%s:%d%s failed", robot_ip, WS_PORT, WS_PATH);
+        ws_transport_close();
+        return false;
+    }
+
+    session_stats.reconnects++;
+    ESP_LOGI(WS_TAG, "Streaming commands to ws://%s:%d%s", robot_ip, WS_PORT, WS_PATH);
+    return true;
+}
+
+// Outcome of waiting for one incoming frame
+#define WS_RX_ERROR       -1   // Socket failed
+#define WS_RX_NONE         0   // Nothing arrived in time
+#define WS_RX_FRAME        1   // A frame that was not a feedback reply
+#define WS_RX_FEEDBACK     2   // A feedback reply, now published
+
+// Read one frame if one arrives within timeout_ms and pass whole text frames to the feedback
+// parser. The robot's replies are small enough to never fragment; anything that does is skipped.
+static int ws_receive(int timeout_ms)
+{
+    int ready = esp_transport_poll_read(ws_transport, timeout_ms);
+    if (ready <= 0) {
+        return (ready < 0) ? WS_RX_ERROR : WS_RX_NONE;
+    }
+
+    int len = esp_transport_read(ws_transport, rx_buffer, sizeof(rx_buffer), timeout_ms);
+    if (len < 0) {
+        return WS_RX_ERROR;
+    }
+    if (esp_transport_ws_get_read_opcode(ws_transport) != WS_TRANSPORT_OPCODES_TEXT ||
+        esp_transport_ws_get_read_payload_len(ws_transport) != len) {
+        return WS_RX_FRAME;
+    }
+    return robot_arm_feedback_ingest(rx_buffer, len) ? WS_RX_FEEDBACK : WS_RX_FRAME;
+}
+
+static robot_arm_comm_status_t ws_transport_send(const char *json, robot_arm_send_limits_t *limits)
+{
+    if (!ws_transport) {
+        session_stats.failures++;
+        return ROBOT_ARM_COMM_NOT_CONNECTED;
+    }
+
+    uint32_t timeout_ms = (limits && limits->budget_ms) ? limits->budget_ms : WS_SEND_TIMEOUT_MS;
+    if (limits) {
+        limits->attempts = 1;
+    }
+
+    session_stats.requests++;
+    int len = (int)strlen(json);
+    int sent = esp_transport_ws_send_raw(ws_transport, WS_TRANSPORT_OPCODES_TEXT | WS_TRANSPORT_OPCODES_FIN,
+                                         json, len, (int)timeout_ms);
+    if (sent != len) {
+        ESP_LOGE(WS_TAG, "WebSocket send failed (%d/%d bytes)", sent, len);
+        session_stats.failures++;
+        return (sent < 0) ? ROBOT_ARM_COMM_ERROR : ROBOT_ARM_COMM_TIMEOUT;
+    }
+
+    // Moves are not answered: only drain what already arrived. A status request waits for its
+    // reply within the first-reply timeout.
+    bool wants_reply = strcmp(json, WS_FEEDBACK_REQUEST) == 0;
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)(limits ? limits->timeout_ms : WS_SEND_TIMEOUT_MS) * 1000;
+    int received;
+    do {
+        int wait_ms = 0;
+        if (wants_reply) {
+            int64_t left_us = deadline_us - esp_timer_get_time();
+            wait_ms = (left_us > 0) ? (int)((left_us + 999) / 1000) : 0;
+        }
+        received = ws_receive(wait_ms);
+    } while (received == WS_RX_FRAME);
+
+    if (received == WS_RX_ERROR) {
+        ESP_LOGE(WS_TAG, "WebSocket read failed");
+        session_stats.failures++;
+        return ROBOT_ARM_COMM_ERROR;
+    }
+    if (wants_reply && received != WS_RX_FEEDBACK) {
+        session_stats.failures++;
+        return ROBOT_ARM_COMM_TIMEOUT;
+    }
+
+    // Every frame after the handshake rides the same socket
+    session_stats.reused++;
+    return ROBOT_ARM_COMM_OK;
+}
+
+static void ws_transport_get_stats(robot_arm_session_stats_t *stats)
+{
+    *stats = session_stats;
+}
+
+const robot_arm_transport_t robot_arm_transport_ws = {
+    .name = "WebSocket",
+    .needs_wifi = true,
+    .payload = ROBOT_ARM_PAYLOAD_JSON,
+    .open = ws_transport_open,
+    .close = ws_transport_close,
+    .send = ws_transport_send,
+    .get_stats = ws_transport_get_stats,
+};
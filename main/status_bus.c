@@ -0,0 +1,113 @@
+#include <stdatomic.h>
+#include <stddef.h>
+#include "status_bus.h"
+
+typedef struct {
+    status_topic_t topic;
+    status_bus_cb_t cb;
+    void *user_data;
+} status_subscriber_t;
+
+// Written by publishers. A topic nobody has published yet has no value to deliver.
+static atomic_int topic_values[STATUS_TOPIC_COUNT];
+static atomic_uint published_topics = 0;
+static atomic_uint pending_topics = 0;
+static void (*_Atomic notify_consumer)(void) = NULL;
+
+// Consumer task only
+static status_subscriber_t subscribers[STATUS_BUS_MAX_SUBSCRIBERS];
+static int subscriber_count = 0;
+static int delivered_values[STATUS_TOPIC_COUNT];
+static unsigned int delivered_topics = 0;
+
+void status_bus_publish(status_topic_t topic, int value)
+{
+    if (topic < 0 || topic >= STATUS_TOPIC_COUNT) {
+        return;
+    }
+    int previous = atomic_exchange(&topic_values[topic], value);
+    bool first = !(atomic_fetch_or(&published_topics, 1u << topic) & (1u << topic));
+    if (previous == value && !first) {
+        return;
+    }
+
+    // Only the publish that sets the pending bit has to wake the consumer
+    unsigned int was_pending = atomic_fetch_or(&pending_topics, 1u << topic);
+    void (*notify)(void) = atomic_load(&notify_consumer);
+    if (!(was_pending & (1u << topic)) && notify) {
+        notify();
+    }
+}
+
+bool status_bus_get(status_topic_t topic, int *value)
+{
+    if (topic < 0 || topic >= STATUS_TOPIC_COUNT || !(atomic_load(&published_topics) & (1u << topic))) {
+        return false;
+    }
+    *value = atomic_load(&topic_values[topic]);
+    return true;
+}
+
+void status_bus_set_notify(void (*notify)(void))
+{
+    atomic_store(&notify_consumer, notify);
+    // Deliver whatever was published before anyone listened
+    if (notify && atomic_load(&pending_topics)) {
+        notify();
+    }
+}
+
+static bool already_delivered(status_topic_t topic, int value)
+{
+    return (delivered_topics & (1u << topic)) && value == delivered_values[topic];
+}
+
+// Hand a new value to every subscriber of the topic and remember it as delivered
+static void deliver(status_topic_t topic, int value)
+{
+    delivered_values[topic] = value;
+    delivered_topics |= 1u << topic;
+
+    for (int i = 0; i < subscriber_count; i++) {
+        if (subscribers[i].topic == topic) {
+            subscribers[i].cb(topic, value, subscribers[i].user_data);
+        }
+    }
+}
+
+void status_bus_dispatch(void)
+{
+    unsigned int pending = atomic_exchange(&pending_topics, 0);
+    for (int topic = 0; pending && topic < STATUS_TOPIC_COUNT; topic++) {
+        if (!(pending & (1u << topic))) {
+            continue;
+        }
+        // A value that changed and changed back before this point is no transition at all
+        int value = atomic_load(&topic_values[topic]);
+        if (!already_delivered((status_topic_t)topic, value)) {
+            deliver((status_topic_t)topic, value);
+        }
+    }
+}
+
+bool status_bus_subscribe(status_topic_t topic, status_bus_cb_t cb, void *user_data)
+{
+    if (topic < 0 || topic >= STATUS_TOPIC_COUNT || !cb || subscriber_count >= STATUS_BUS_MAX_SUBSCRIBERS) {
+        return false;
+    }
+
+    subscribers[subscriber_count++] = (status_subscriber_t){ topic, cb, user_data };
+    int value;
+    if (!status_bus_get(topic, &value)) {
+        return true;
+    }
+    if (already_delivered(topic, value)) {
+        // The others have it already; only the newcomer needs it
+        cb(topic, value, user_data);
+    } else {
+        // A value still pending goes to everyone now and is recorded, so the next dispatch
+        // does not hand it to the newcomer a second time
+        deliver(topic, value);
+    }
+    return true;
+}
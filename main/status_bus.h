@@ -0,0 +1,32 @@
+#ifndef STATUS_BUS_H
+#define STATUS_BUS_H
+
+#include <stdbool.h>
+
+// Connection state bus: modules publish state transitions from any task, and subscribers are
+// called on one consumer task (the LVGL task) only when a topic's value actually changed.
+// Publishing is lock-free: the latest value per topic is kept and a pending bit wakes the
+// consumer, so a burst of transitions is delivered once, as its final value.
+typedef enum {
+    STATUS_TOPIC_WIFI,        // wifi_status_t
+    STATUS_TOPIC_ROBOT,       // robot_arm_comm_status_t of the last command sent
+    STATUS_TOPIC_TRANSPORT,   // robot_arm_transport_kind_t in use
+    STATUS_TOPIC_COUNT
+} status_topic_t;
+
+#define STATUS_BUS_MAX_SUBSCRIBERS 8
+
+typedef void (*status_bus_cb_t)(status_topic_t topic, int value, void *user_data);
+
+// Function declarations
+void status_bus_publish(status_topic_t topic, int value);   // Any task; unchanged values are ignored
+bool status_bus_get(status_topic_t topic, int *value);       // False until the topic is first published
+
+// Consumer side. notify is called (from the publishing task) whenever a delivery is pending and
+// should wake the consumer, which then calls status_bus_dispatch().
+void status_bus_set_notify(void (*notify)(void));
+void status_bus_dispatch(void);
+// Call cb with the topic's current value now (if published) and on every change (consumer task only)
+bool status_bus_subscribe(status_topic_t topic, status_bus_cb_t cb, void *user_data);
+
+#endif // STATUS_BUS_H
@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <lvgl.h>
+#include "ui_diagnostics.h"
+#include "robot_arm_comm.h"
+#include "robot_arm_stats.h"
+#include "screens.h"
+#include "wifi_manager.h"
+#include "wifi_supervisor.h"
+#include "esp_log.h"
+
+static const char *UI_DIAG_TAG = "UI_DIAG";
+
+#define DIAG_REFRESH_MS 1000
+
+static lv_obj_t *diag_label = NULL;
+static lv_timer_t *diag_timer = NULL;
+static robot_arm_stats_t last_stats;
+
+static const char *transport_names[] = { "HTTP", "WS", "UART" };
+
+// Rebuild the overlay text from a fresh stats snapshot
+static void ui_diagnostics_refresh(lv_timer_t *timer)
+{
+    robot_arm_stats_t stats;
+    robot_arm_stats_get(&stats);
+    float rate = robot_arm_stats_rate(&last_stats, &stats);
+    last_stats = stats;
+
+    robot_arm_session_stats_t session;
+    robot_arm_get_session_stats(&session);
+    robot_arm_rate_state_t pacing;
+    robot_arm_get_rate_state(&pacing);
+    robot_arm_priority_stats_t priority;
+    robot_arm_get_priority_stats(&priority);
+    wifi_connect_stats_t wifi;
+    wifi_get_connect_stats(&wifi);
+    wifi_power_stats_t power;
+    wifi_get_power_stats(&power);
+    wifi_link_stats_t link;
+    wifi_get_link_stats(&link);
+    char quality[8] = "--";
+    if (link.quality != WIFI_LINK_QUALITY_UNKNOWN) {
+        snprintf(quality, sizeof(quality), "%u%%", (unsigned)link.quality);
+    }
+
+    char text[896];
+    int len = snprintf(text, sizeof(text),
+                       "%s  %.1f cmd/s  sent %lu  fail %lu  t/o %lu\n"
+                       "dropped %lu  coalesced %lu  superseded %lu  reused %lu/%lu\n"
+                       "pacing %.1f/%.1f Hz  srtt %.1f ms  base %.1f ms  backoffs %lu\n"
+                       "priority %lu  worst %.2f ms  late %lu  flushed %lu\n"
+                       "wifi boot %lu ms  connect %lu ms  outage %lu ms  cached %lu/%lu\n"
+                       "radio %s  wake %lu  sleep %lu  awake p50/p99 %.1f/%.1f ms  ps %.1f/%.1f ms\n"
+                       "link %s  rssi %d dBm  drops %lu  recovered %lu/%lu  retry in %lu ms\n"
+                       "T     n     queue p50/p99   wire p50/p99/max (ms)",
+                       transport_names[robot_arm_get_transport()], rate,
+                       (unsigned long)stats.total_sent, (unsigned long)stats.total_failures,
+                       (unsigned long)stats.total_timeouts,
+                       (unsigned long)robot_arm_get_dropped_count(), (unsigned long)robot_arm_get_coalesced_count(),
+                       (unsigned long)session.cancelled, (unsigned long)session.reused, (unsigned long)session.requests,
+                       pacing.rate_hz, pacing.ceiling_hz, pacing.srtt_us / 1000.0f, pacing.min_rtt_us / 1000.0f,
+                       (unsigned long)pacing.congestion_events,
+                       (unsigned long)priority.sent, priority.max_dispatch_us / 1000.0f,
+                       (unsigned long)priority.deadline_misses, (unsigned long)priority.flushed,
+                       (unsigned long)wifi.boot_to_connected_ms, (unsigned long)wifi.last_connect_ms,
+                       (unsigned long)wifi.last_outage_ms, (unsigned long)wifi.fast_connects,
+                       (unsigned long)(wifi.fast_connects + wifi.full_connects),
+                       power.power_save ? "ps" : "awake", (unsigned long)power.wakeups, (unsigned long)power.sleeps,
+                       stats.radio_p50_us[ROBOT_ARM_RADIO_AWAKE] / 1000.0f, stats.radio_p99_us[ROBOT_ARM_RADIO_AWAKE] / 1000.0f,
+                       stats.radio_p50_us[ROBOT_ARM_RADIO_POWER_SAVE] / 1000.0f,
+                       stats.radio_p99_us[ROBOT_ARM_RADIO_POWER_SAVE] / 1000.0f,
+                       quality, link.rssi, (unsigned long)wifi.disconnects,
+                       (unsigned long)link.recoveries, (unsigned long)link.recovery_attempts,
+                       (unsigned long)link.next_retry_ms);
+
+    for (int type = 0; type < ROBOT_ARM_CMD_TYPE_COUNT && len > 0 && len < (int)sizeof(text); type++) {
+        const robot_arm_cmd_stats_t *s = &stats.per_type[type];
+        if (s->sent == 0) {
+            continue;
+        }
+        len += snprintf(text + len, sizeof(text) - len,
+                        "\n%-4d %5lu   %5.1f/%5.1f   %6.1f/%6.1f/%6.1f",
+                        robot_arm_stats_type_code(type), (unsigned long)s->sent,
+                        s->p50_us[ROBOT_ARM_STATS_QUEUE] / 1000.0f, s->p99_us[ROBOT_ARM_STATS_QUEUE] / 1000.0f,
+                        s->p50_us[ROBOT_ARM_STATS_WIRE] / 1000.0f, s->p99_us[ROBOT_ARM_STATS_WIRE] / 1000.0f,
+                        s->max_us[ROBOT_ARM_STATS_WIRE] / 1000.0f);
+    }
+
+    lv_label_set_text(diag_label, text);
+}
+
+static void on_title_long_pressed(lv_event_t *e)
+{
+    ui_diagnostics_set_visible(lv_obj_has_flag(diag_label, LV_OBJ_FLAG_HIDDEN));
+}
+
+void ui_diagnostics_init(void)
+{
+    // The top layer keeps the overlay above the screen without touching the generated layout
+    diag_label = lv_label_create(lv_layer_top());
+    lv_obj_set_style_bg_color(diag_label, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(diag_label, LV_OPA_80, LV_PART_MAIN);
+    lv_obj_set_style_text_color(diag_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(diag_label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(diag_label, 8, LV_PART_MAIN);
+    lv_obj_align(diag_label, LV_ALIGN_BOTTOM_LEFT, 0, 0);
+    lv_obj_add_flag(diag_label, LV_OBJ_FLAG_HIDDEN);
+
+    diag_timer = lv_timer_create(ui_diagnostics_refresh, DIAG_REFRESH_MS, NULL);
+    lv_timer_pause(diag_timer);
+
+    lv_obj_add_flag(objects.title, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_event_cb(objects.title, on_title_long_pressed, LV_EVENT_LONG_PRESSED, NULL);
+}
+
+void ui_diagnostics_set_visible(bool visible)
+{
+    if (!diag_label) {
+        return;
+    }
+
+    if (visible) {
+        robot_arm_stats_get(&last_stats);
+        ui_diagnostics_refresh(diag_timer);
+        lv_obj_clear_flag(diag_label, LV_OBJ_FLAG_HIDDEN);
+        lv_timer_resume(diag_timer);
+    } else {
+        lv_timer_pause(diag_timer);
+        lv_obj_add_flag(diag_label, LV_OBJ_FLAG_HIDDEN);
+    }
+    ESP_LOGI(UI_DIAG_TAG, "Diagnostics overlay %s", visible ? "shown" : "hidden");
+}
@@ -0,0 +1,13 @@
+#ifndef UI_DIAGNOSTICS_H
+#define UI_DIAGNOSTICS_H
+
+#include <stdbool.h>
+
+// Create the comm diagnostics overlay (hidden; long-press the title to toggle it).
+// Must be called with the LVGL lock held.
+void ui_diagnostics_init(void);
+
+// Show or hide the overlay (LVGL lock held)
+void ui_diagnostics_set_visible(bool visible);
+
+#endif // UI_DIAGNOSTICS_H
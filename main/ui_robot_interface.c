@@ -1,8 +1,21 @@
 #include "ui_robot_interface.h"
+#include "ui_diagnostics.h"
+#include "ui_telemetry.h"
 #include "robot_arm_comm.h"
+#include "robot_arm_cmd_cache.h"
+#include "robot_arm_stream.h"
+#include "robot_arm_kinematics.h"
+#include "robot_arm_feedback.h"
+#include "robot_arm_shadow.h"
+#include "status_bus.h"
 #include "screens.h"
+#include "lvgl_port.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
 
 static const char *UI_ROBOT_TAG = "UI_ROBOT";
 
@@ -16,9 +29,327 @@ static const char *UI_ROBOT_TAG = "UI_ROBOT";
 #define GRIPPER_MIN_RAD  1.08f  // Open fully
 #define GRIPPER_MAX_RAD  3.14f  // Close fully
 
+// Motion limits of each joint for the trajectory streamer, indexed by joint - ROBOT_ARM_JOINT_BASE:
+// range, max velocity (rad/s), max acceleration (rad/s^2), max jerk (rad/s^3)
+static const robot_arm_traj_limits_t joint_limits[ROBOT_ARM_JOINT_COUNT] = {
+    { BASE_MIN_RAD,     BASE_MAX_RAD,     1.5f, 4.0f, 80.0f },
+    { SHOULDER_MIN_RAD, SHOULDER_MAX_RAD, 1.0f, 3.0f, 60.0f },
+    { ARM_MIN_RAD,      ARM_MAX_RAD,      1.2f, 3.0f, 60.0f },
+    { GRIPPER_MIN_RAD,  GRIPPER_MAX_RAD,  2.0f, 6.0f, 120.0f },
+};
+
 // Control parameters
 #define JOINT_SPEED     0       // 0 = use default speed
 #define JOINT_ACCELERATION 10   // Acceleration value
+#define STREAM_ACCELERATION 0   // Streamed setpoints are already smoothed; let the servos follow them
+
+// Trajectory mode: sliders only set targets, a fixed-rate streamer interpolates toward them
+#define TRAJECTORY_RATE_HZ (CONFIG_ROBOT_ARM_UI_TRAJECTORY_RATE_HZ)
+
+// Batch mode: slider edits within one send window go out as a single all-joint move
+#define BATCH_SEND_WINDOW_MS (CONFIG_ROBOT_ARM_UI_BATCH_WINDOW_MS)
+#ifdef CONFIG_ROBOT_ARM_UI_BATCH_MOVES
+static bool batch_mode = true;
+#else
+static bool batch_mode = false;
+#endif
+static lv_timer_t *batch_timer = NULL;
+static bool batch_armed = false;
+
+// Cartesian mode: base slider moves the tip along y, shoulder along x (reach), arm along z;
+// every edit is solved back to joint angles on the device
+#define CART_X_MIN_MM   100.0f
+#define CART_X_MAX_MM   450.0f
+#define CART_Y_MIN_MM  -300.0f
+#define CART_Y_MAX_MM   300.0f
+#define CART_Z_MIN_MM     0.0f
+#define CART_Z_MAX_MM   450.0f
+static bool cartesian_mode = false;
+
+// Optimistic sliders: a slider shows its new target at once, and the shadow state tracks
+// whether the robot accepted it and got there. The knob turns amber while a target is in flight
+// or the arm is on its way. If a send fails or the arm ends up elsewhere, the slider is put back
+// where the robot reports the joint and the knob flashes red.
+#define RECONCILE_PERIOD_MS   100
+#define ALERT_FLASH_US        (1500 * 1000)
+#define KNOB_COLOR_DEFAULT    0xFFFFFFFFu
+static robot_arm_shadow_t shadow;
+static int64_t alert_until_us[ROBOT_ARM_JOINT_COUNT];
+static uint32_t knob_color[ROBOT_ARM_JOINT_COUNT] = {
+    KNOB_COLOR_DEFAULT, KNOB_COLOR_DEFAULT, KNOB_COLOR_DEFAULT, KNOB_COLOR_DEFAULT,
+};
+
+// Failed commands are reported on the LVGL task. The comm task posts the latest failure into
+// this preallocated slot, packed as type/joint/status (never 0, since a failure's status is not
+// ROBOT_ARM_COMM_OK), and the reconcile timer drains it: no allocation, no LVGL lock.
+static atomic_uintptr_t failed_command = 0;
+static atomic_uint failures_unreported = 0;   // Failures overwritten before they were drained
+
+// Runs on the LVGL task: report the last failed command queued from a UI handler
+static void ui_report_command_failure(void)
+{
+    uintptr_t value = atomic_exchange(&failed_command, 0);
+    if (value == 0) {
+        return;
+    }
+    robot_arm_cmd_type_t type = (robot_arm_cmd_type_t)(value >> 16);
+    int joint = (int)((value >> 8) & 0xFF);
+    robot_arm_comm_status_t status = (robot_arm_comm_status_t)(value & 0xFF);
+
+    if (type == ROBOT_ARM_CMD_MOVE_JOINT) {
+        ESP_LOGE(UI_ROBOT_TAG, "Failed to move joint %d (status %d)", joint, status);
+    } else if (type == ROBOT_ARM_CMD_MOVE_JOINTS) {
+        ESP_LOGE(UI_ROBOT_TAG, "Failed to move joints (status %d)", status);
+    } else if (type == ROBOT_ARM_CMD_LED) {
+        ESP_LOGE(UI_ROBOT_TAG, "Failed to control LED (status %d)", status);
+    } else {
+        ESP_LOGE(UI_ROBOT_TAG, "Robot command type %d failed (status %d)", type, status);
+    }
+
+    unsigned int missed = atomic_exchange(&failures_unreported, 0);
+    if (missed) {
+        ESP_LOGE(UI_ROBOT_TAG, "%u more commands failed before that one", missed);
+    }
+}
+
+// Runs on the comm task: mark the shadow state of the joints (user_data is the newest edit the
+// command carried) and post failures for the LVGL task
+static void ui_command_done_cb(const robot_arm_cmd_t *cmd, robot_arm_comm_status_t status, void *user_data)
+{
+    if (status == ROBOT_ARM_COMM_OK) {
+        return;
+    }
+
+    int joint = (cmd->type == ROBOT_ARM_CMD_MOVE_JOINT) ? cmd->move.joint : 0;
+    if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINTS) {
+        robot_arm_shadow_fail(&shadow, (1u << ROBOT_ARM_JOINT_COUNT) - 1, (uint32_t)(uintptr_t)user_data);
+    } else if (cmd->type == ROBOT_ARM_CMD_MOVE_JOINT && joint >= ROBOT_ARM_JOINT_BASE && joint <= ROBOT_ARM_JOINT_GRIPPER) {
+        robot_arm_shadow_fail(&shadow, 1u << (joint - ROBOT_ARM_JOINT_BASE), (uint32_t)(uintptr_t)user_data);
+    }
+
+    uintptr_t packed = ((uintptr_t)cmd->type << 16) | ((uintptr_t)joint << 8) | (uintptr_t)status;
+    if (atomic_exchange(&failed_command, packed) != 0) {
+        atomic_fetch_add(&failures_unreported, 1);
+    }
+}
+
+// Tip position the sliders describe in Cartesian mode
+static void ui_read_cartesian_target(robot_arm_cartesian_t *pose)
+{
+    pose->y = map_slider_to_joint_range(lv_slider_get_value(objects.base_slider), CART_Y_MIN_MM, CART_Y_MAX_MM);
+    pose->x = map_slider_to_joint_range(lv_slider_get_value(objects.shoulder_slider), CART_X_MIN_MM, CART_X_MAX_MM);
+    pose->z = map_slider_to_joint_range(lv_slider_get_value(objects.arm_slider), CART_Z_MIN_MM, CART_Z_MAX_MM);
+    pose->gripper = map_slider_to_joint_range(lv_slider_get_value(objects.gripper_slider), GRIPPER_MIN_RAD, GRIPPER_MAX_RAD);
+}
+
+// Current target of every slider, indexed by joint - ROBOT_ARM_JOINT_BASE
+static void ui_read_slider_targets(float radians[ROBOT_ARM_JOINT_COUNT])
+{
+    if (cartesian_mode) {
+        robot_arm_cartesian_t pose;
+        ui_read_cartesian_target(&pose);
+        robot_arm_ik_status_t status = robot_arm_ik(&pose, joint_limits, radians);
+        if (status != ROBOT_ARM_IK_OK) {
+            ESP_LOGD(UI_ROBOT_TAG, "(%.0f, %.0f, %.0f) mm not reachable (%d), clamped",
+                     pose.x, pose.y, pose.z, status);
+        }
+        return;
+    }
+
+    radians[0] = map_slider_to_joint_range(lv_slider_get_value(objects.base_slider), BASE_MIN_RAD, BASE_MAX_RAD);
+    radians[1] = map_slider_to_joint_range(lv_slider_get_value(objects.shoulder_slider), SHOULDER_MIN_RAD, SHOULDER_MAX_RAD);
+    radians[2] = map_slider_to_joint_range(lv_slider_get_value(objects.arm_slider), ARM_MIN_RAD, ARM_MAX_RAD);
+    radians[3] = map_slider_to_joint_range(lv_slider_get_value(objects.gripper_slider), GRIPPER_MIN_RAD, GRIPPER_MAX_RAD);
+}
+
+static lv_obj_t *ui_joint_slider(int index)
+{
+    lv_obj_t *sliders[ROBOT_ARM_JOINT_COUNT] = {
+        objects.base_slider, objects.shoulder_slider, objects.arm_slider, objects.gripper_slider,
+    };
+    return sliders[index];
+}
+
+// Put joint angles on the sliders without raising change events
+static void ui_show_joints_on_sliders(const float radians[ROBOT_ARM_JOINT_COUNT])
+{
+    if (cartesian_mode) {
+        robot_arm_cartesian_t pose;
+        robot_arm_fk(radians, &pose);
+        lv_slider_set_value(objects.base_slider, map_joint_range_to_slider(pose.y, CART_Y_MIN_MM, CART_Y_MAX_MM), LV_ANIM_OFF);
+        lv_slider_set_value(objects.shoulder_slider, map_joint_range_to_slider(pose.x, CART_X_MIN_MM, CART_X_MAX_MM), LV_ANIM_OFF);
+        lv_slider_set_value(objects.arm_slider, map_joint_range_to_slider(pose.z, CART_Z_MIN_MM, CART_Z_MAX_MM), LV_ANIM_OFF);
+    } else {
+        for (int i = 0; i < ROBOT_ARM_JOINT_COUNT - 1; i++) {
+            lv_slider_set_value(ui_joint_slider(i), map_joint_range_to_slider(radians[i], joint_limits[i].min_rad, joint_limits[i].max_rad), LV_ANIM_OFF);
+        }
+    }
+    lv_slider_set_value(objects.gripper_slider, map_joint_range_to_slider(radians[3], GRIPPER_MIN_RAD, GRIPPER_MAX_RAD), LV_ANIM_OFF);
+}
+
+// Record the targets of an all-joint command; returns the edit sequence to tag it with
+static uint32_t ui_shadow_command_all(const float radians[ROBOT_ARM_JOINT_COUNT])
+{
+    int64_t now_us = esp_timer_get_time();
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        robot_arm_shadow_command(&shadow, i, radians[i], now_us);
+    }
+    return robot_arm_shadow_generation(&shadow);
+}
+
+static void ui_set_knob_color(int index, uint32_t color)
+{
+    if (knob_color[index] == color) {
+        return;
+    }
+    knob_color[index] = color;
+
+    lv_obj_t *slider = ui_joint_slider(index);
+    if (color == KNOB_COLOR_DEFAULT) {
+        lv_obj_remove_local_style_prop(slider, LV_STYLE_BG_COLOR, LV_PART_KNOB);
+    } else {
+        lv_obj_set_style_bg_color(slider, lv_color_hex(color), LV_PART_KNOB);
+    }
+}
+
+// Runs on the LVGL task: report failed commands, compare each joint's shadow state with what the
+// robot accepted and reported, put diverged or failed joints back where the arm is, and colour
+// the knobs
+static void ui_reconcile_timer_cb(lv_timer_t *timer)
+{
+    ui_report_command_failure();
+
+    float acked[ROBOT_ARM_JOINT_COUNT];
+    robot_arm_get_commanded_joints(acked);
+    robot_arm_feedback_t feedback;
+    bool have_feedback = robot_arm_get_feedback(&feedback);
+    int64_t now_us = esp_timer_get_time();
+
+    robot_arm_shadow_state_t states[ROBOT_ARM_JOINT_COUNT];
+    bool adopted = false;
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        float measured = have_feedback ? feedback.joint_rad[i] : NAN;
+        states[i] = robot_arm_shadow_update(&shadow, i, acked[i], measured, have_feedback ? feedback.timestamp_us : 0, now_us);
+        if (states[i] != ROBOT_ARM_SHADOW_FAILED && states[i] != ROBOT_ARM_SHADOW_DIVERGED) {
+            continue;
+        }
+
+        // Never pull a slider out from under the operator's finger; with nothing known about
+        // the joint, keep showing the failure instead of guessing
+        const robot_arm_joint_shadow_t *joint = &shadow.joints[i];
+        float truth = !isnan(joint->measured) ? joint->measured : joint->acked;
+        if (isnan(truth) || lv_obj_has_state(ui_joint_slider(i), LV_STATE_PRESSED)) {
+            continue;
+        }
+        if (!isnan(joint->commanded)) {
+            ESP_LOGW(UI_ROBOT_TAG, "Joint %d %s: showing %.3f rad instead of %.3f", ROBOT_ARM_JOINT_BASE + i,
+                     states[i] == ROBOT_ARM_SHADOW_FAILED ? "command failed" : "diverged", truth, joint->commanded);
+            alert_until_us[i] = now_us + ALERT_FLASH_US;
+        }
+        robot_arm_shadow_reconcile(&shadow, i, truth, now_us);
+        robot_arm_stream_adopt((robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + i), truth);
+        states[i] = ROBOT_ARM_SHADOW_SETTLED;
+        adopted = true;
+    }
+
+    if (adopted) {
+        // Joints nothing is known about keep their slider targets
+        float radians[ROBOT_ARM_JOINT_COUNT];
+        ui_read_slider_targets(radians);
+        for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+            if (!isnan(shadow.joints[i].commanded)) {
+                radians[i] = shadow.joints[i].commanded;
+            }
+        }
+        ui_show_joints_on_sliders(radians);
+    }
+
+    // In Cartesian mode each position slider moves the first three joints together
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        int first = (cartesian_mode && i < 3) ? 0 : i;
+        int last = (cartesian_mode && i < 3) ? 2 : i;
+        bool alert = false, busy = false;
+        for (int j = first; j <= last; j++) {
+            alert |= now_us < alert_until_us[j] || states[j] == ROBOT_ARM_SHADOW_FAILED;
+            busy |= states[j] == ROBOT_ARM_SHADOW_IN_FLIGHT || states[j] == ROBOT_ARM_SHADOW_MOVING;
+        }
+        uint32_t color = alert ? lv_color_to32(lv_palette_main(LV_PALETTE_RED))
+                       : busy ? lv_color_to32(lv_palette_main(LV_PALETTE_AMBER)) : KNOB_COLOR_DEFAULT;
+        ui_set_knob_color(i, color);
+    }
+}
+
+// Batch window expired: send every slider's current target in one all-joint command
+static void ui_batch_timer_cb(lv_timer_t *timer)
+{
+    lv_timer_pause(timer);
+    batch_armed = false;
+
+    robot_arm_cmd_t cmd = {
+        .type = ROBOT_ARM_CMD_MOVE_JOINTS,
+        .joints = { .speed = JOINT_SPEED, .acceleration = JOINT_ACCELERATION },
+    };
+    ui_read_slider_targets(cmd.joints.radians);
+    uint32_t generation = ui_shadow_command_all(cmd.joints.radians);
+    if (robot_arm_submit(&cmd, ui_command_done_cb, (void *)(uintptr_t)generation) != ROBOT_ARM_COMM_OK) {
+        ESP_LOGW(UI_ROBOT_TAG, "Could not queue all-joint move");
+    }
+}
+
+// Queue a joint move for the comm task; never blocks the LVGL task on the network
+static void ui_submit_joint_move(robot_arm_joint_t joint, float joint_angle)
+{
+    // In Cartesian mode one axis edit moves several joints; solve and send them together.
+    // Batch mode falls through: the send window solves the sliders when it closes.
+    bool streaming = robot_arm_stream_is_running();
+    if (cartesian_mode && (streaming || !batch_mode || !batch_timer)) {
+        float radians[ROBOT_ARM_JOINT_COUNT];
+        ui_read_slider_targets(radians);
+        uint32_t generation = ui_shadow_command_all(radians);
+        if (streaming) {
+            for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+                robot_arm_stream_set_target((robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + i), radians[i]);
+            }
+            return;
+        }
+
+        robot_arm_cmd_t cmd = {
+            .type = ROBOT_ARM_CMD_MOVE_JOINTS,
+            .joints = { .speed = JOINT_SPEED, .acceleration = JOINT_ACCELERATION },
+        };
+        memcpy(cmd.joints.radians, radians, sizeof(radians));
+        if (robot_arm_submit(&cmd, ui_command_done_cb, (void *)(uintptr_t)generation) != ROBOT_ARM_COMM_OK) {
+            ESP_LOGW(UI_ROBOT_TAG, "Could not queue Cartesian move");
+        }
+        return;
+    }
+
+    // The slider already shows the target; the shadow state follows it until the robot confirms
+    uint32_t generation = robot_arm_shadow_command(&shadow, joint - ROBOT_ARM_JOINT_BASE, joint_angle, esp_timer_get_time());
+    if (streaming) {
+        // The streamer picks the new target up on its next tick
+        robot_arm_stream_set_target(joint, joint_angle);
+        return;
+    }
+
+    if (batch_mode && batch_timer) {
+        // Open a send window on the first edit; later edits in the window ride along
+        if (!batch_armed) {
+            batch_armed = true;
+            lv_timer_reset(batch_timer);
+            lv_timer_resume(batch_timer);
+        }
+        return;
+    }
+
+    robot_arm_cmd_t cmd = {
+        .type = ROBOT_ARM_CMD_MOVE_JOINT,
+        .move = { .joint = joint, .radians = joint_angle, .speed = JOINT_SPEED, .acceleration = JOINT_ACCELERATION },
+    };
+    if (robot_arm_submit(&cmd, ui_command_done_cb, (void *)(uintptr_t)generation) != ROBOT_ARM_COMM_OK) {
+        ESP_LOGW(UI_ROBOT_TAG, "Could not queue move for joint %d", joint);
+    }
+}
 
 // Utility function to map slider value (0-100) to joint range in radians
 float map_slider_to_joint_range(int slider_value, float min_rad, float max_rad)
@@ -54,10 +385,7 @@ void on_base_slider_changed(lv_event_t *e)
              slider_value, joint_angle, joint_angle * 180.0f / M_PI);
     
     if (robot_arm_is_connected()) {
-        robot_arm_comm_status_t result = robot_arm_move_base(joint_angle, JOINT_SPEED, JOINT_ACCELERATION);
-        if (result != ROBOT_ARM_COMM_OK) {
-            ESP_LOGE(UI_ROBOT_TAG, "Failed to move base joint");
-        }
+        ui_submit_joint_move(ROBOT_ARM_JOINT_BASE, joint_angle);
     }
 }
 
@@ -73,10 +401,7 @@ void on_shoulder_slider_changed(lv_event_t *e)
              slider_value, joint_angle, joint_angle * 180.0f / M_PI);
     
     if (robot_arm_is_connected()) {
-        robot_arm_comm_status_t result = robot_arm_move_shoulder(joint_angle, JOINT_SPEED, JOINT_ACCELERATION);
-        if (result != ROBOT_ARM_COMM_OK) {
-            ESP_LOGE(UI_ROBOT_TAG, "Failed to move shoulder joint");
-        }
+        ui_submit_joint_move(ROBOT_ARM_JOINT_SHOULDER, joint_angle);
     }
 }
 
@@ -92,10 +417,7 @@ void on_arm_slider_changed(lv_event_t *e)
              slider_value, joint_angle, joint_angle * 180.0f / M_PI);
     
     if (robot_arm_is_connected()) {
-        robot_arm_comm_status_t result = robot_arm_move_elbow(joint_angle, JOINT_SPEED, JOINT_ACCELERATION);
-        if (result != ROBOT_ARM_COMM_OK) {
-            ESP_LOGE(UI_ROBOT_TAG, "Failed to move elbow joint");
-        }
+        ui_submit_joint_move(ROBOT_ARM_JOINT_ELBOW, joint_angle);
     }
 }
 
@@ -114,10 +436,7 @@ void on_gripper_slider_changed(lv_event_t *e)
              slider_value, joint_angle, joint_angle * 180.0f / M_PI, openness);
     
     if (robot_arm_is_connected()) {
-        robot_arm_comm_status_t result = robot_arm_move_gripper(joint_angle, JOINT_SPEED, JOINT_ACCELERATION);
-        if (result != ROBOT_ARM_COMM_OK) {
-            ESP_LOGE(UI_ROBOT_TAG, "Failed to move gripper joint");
-        }
+        ui_submit_joint_move(ROBOT_ARM_JOINT_GRIPPER, joint_angle);
     }
 }
 
@@ -130,23 +449,31 @@ void on_light_switch_changed(lv_event_t *e)
     ESP_LOGI(UI_ROBOT_TAG, "Light switch changed: %s", is_on ? "ON" : "OFF");
     
     if (robot_arm_is_connected()) {
-        robot_arm_comm_status_t result;
-        if (is_on) {
-            result = robot_arm_led_on();
-        } else {
-            result = robot_arm_led_off();
-        }
-        
-        if (result != ROBOT_ARM_COMM_OK) {
-            ESP_LOGE(UI_ROBOT_TAG, "Failed to control LED");
+        robot_arm_cmd_t cmd = { .type = ROBOT_ARM_CMD_LED, .led = is_on ? 255 : 0 };
+        if (robot_arm_submit(&cmd, ui_command_done_cb, NULL) != ROBOT_ARM_COMM_OK) {
+            ESP_LOGW(UI_ROBOT_TAG, "Could not queue LED command");
         }
     }
 }
 
+// Connection state changed: re-evaluate whether the controls can be used
+static void ui_on_link_changed(status_topic_t topic, int value, void *user_data)
+{
+    update_robot_status_display();
+}
+
 // Initialize the UI robot interface
 void ui_robot_interface_init(void)
 {
     ESP_LOGI(UI_ROBOT_TAG, "Initializing UI robot interface...");
+
+    // Pre-encode every position the sliders can send so the comm task only does a table lookup
+    robot_arm_cmd_cache_build(ROBOT_ARM_JOINT_BASE, BASE_MIN_RAD, BASE_MAX_RAD, JOINT_SPEED, JOINT_ACCELERATION);
+    robot_arm_cmd_cache_build(ROBOT_ARM_JOINT_SHOULDER, SHOULDER_MIN_RAD, SHOULDER_MAX_RAD, JOINT_SPEED, JOINT_ACCELERATION);
+    robot_arm_cmd_cache_build(ROBOT_ARM_JOINT_ELBOW, ARM_MIN_RAD, ARM_MAX_RAD, JOINT_SPEED, JOINT_ACCELERATION);
+    robot_arm_cmd_cache_build(ROBOT_ARM_JOINT_GRIPPER, GRIPPER_MIN_RAD, GRIPPER_MAX_RAD, JOINT_SPEED, JOINT_ACCELERATION);
+    // Trig tables of the Cartesian jog solver, filled before any handler can use them
+    robot_arm_kinematics_init();
     
     // Add event handlers to sliders
     lv_obj_add_event_cb(objects.base_slider, on_base_slider_changed, LV_EVENT_VALUE_CHANGED, NULL);
@@ -156,6 +483,32 @@ void ui_robot_interface_init(void)
     
     // Add event handler to light switch
     lv_obj_add_event_cb(objects.light_switch_obj, on_light_switch_changed, LV_EVENT_VALUE_CHANGED, NULL);
+
+    // Shadow state of every joint, reconciled against what the robot accepts and reports
+    robot_arm_shadow_init(&shadow);
+    lv_timer_create(ui_reconcile_timer_cb, RECONCILE_PERIOD_MS, NULL);
+
+    // Send window timer for batch mode, started by the first slider edit
+    batch_timer = lv_timer_create(ui_batch_timer_cb, BATCH_SEND_WINDOW_MS, NULL);
+    lv_timer_pause(batch_timer);
+
+#ifdef CONFIG_ROBOT_ARM_UI_CARTESIAN
+    ui_robot_set_cartesian_mode(true);
+#endif
+#ifdef CONFIG_ROBOT_ARM_UI_TRAJECTORY
+    ui_robot_set_trajectory_mode(true);
+#endif
+
+    // Controls are enabled only while the robot is reachable, as soon as that changes
+    update_robot_status_display();
+    status_bus_subscribe(STATUS_TOPIC_WIFI, ui_on_link_changed, NULL);
+    status_bus_subscribe(STATUS_TOPIC_ROBOT, ui_on_link_changed, NULL);
+    status_bus_subscribe(STATUS_TOPIC_TRANSPORT, ui_on_link_changed, NULL);
+
+    // Comm latency / throughput overlay, toggled by long-pressing the title
+    ui_diagnostics_init();
+    // Commanded vs measured chart of one joint, opened by long-pressing its label
+    ui_telemetry_init(joint_limits);
     
     ESP_LOGI(UI_ROBOT_TAG, "UI robot interface initialized successfully");
 }
@@ -163,9 +516,15 @@ void ui_robot_interface_init(void)
 // Update UI with robot arm status
 void update_robot_status_display(void)
 {
-    // You can add status indicators here later
-    // For example, change slider colors based on connection status
-    if (robot_arm_is_connected()) {
+    // Only touch the widgets on a change: every state change invalidates them
+    static int controls_enabled = -1;
+    bool connected = robot_arm_is_connected();
+    if (connected == controls_enabled) {
+        return;
+    }
+    controls_enabled = connected;
+
+    if (connected) {
         // Enable sliders
         lv_obj_clear_state(objects.base_slider, LV_STATE_DISABLED);
         lv_obj_clear_state(objects.shoulder_slider, LV_STATE_DISABLED);
@@ -180,4 +539,42 @@ void update_robot_status_display(void)
         lv_obj_add_state(objects.gripper_slider, LV_STATE_DISABLED);
         lv_obj_add_state(objects.light_switch_obj, LV_STATE_DISABLED);
     }
-} 
\ No newline at end of file
+}
+
+// Switch between per-joint commands and merged all-joint commands
+void ui_robot_set_batch_mode(bool enabled)
+{
+    batch_mode = enabled;
+    ESP_LOGI(UI_ROBOT_TAG, "Batch mode %s", enabled ? "enabled" : "disabled");
+}
+
+// Switch between trajectory streaming and sending slider edits directly (LVGL lock held)
+void ui_robot_set_trajectory_mode(bool enabled)
+{
+    if (!enabled) {
+        robot_arm_stream_stop();
+        return;
+    }
+
+    // Start from where the sliders are, so enabling it does not move the arm
+    float radians[ROBOT_ARM_JOINT_COUNT];
+    ui_read_slider_targets(radians);
+    if (robot_arm_stream_start(joint_limits, radians, TRAJECTORY_RATE_HZ, JOINT_SPEED, STREAM_ACCELERATION) != ESP_OK) {
+        ESP_LOGE(UI_ROBOT_TAG, "Could not start trajectory streaming");
+    }
+}
+
+// Switch the sliders between joint angles and tip position (LVGL lock held). The sliders are
+// re-seeded from the current pose so switching does not move the arm.
+void ui_robot_set_cartesian_mode(bool enabled)
+{
+    if (enabled == cartesian_mode) {
+        return;
+    }
+
+    float radians[ROBOT_ARM_JOINT_COUNT];
+    ui_read_slider_targets(radians);
+    cartesian_mode = enabled;
+    ui_show_joints_on_sliders(radians);
+    ESP_LOGI(UI_ROBOT_TAG, "Cartesian mode %s", enabled ? "enabled" : "disabled");
+}
@@ -18,7 +18,16 @@ void on_light_switch_changed(lv_event_t *e);
 float map_slider_to_joint_range(int slider_value, float min_rad, float max_rad);
 int map_joint_range_to_slider(float radian_value, float min_rad, float max_rad);
 
-// Update UI with robot arm status
+// Enable or disable the controls to match the robot link (touches widgets only on a change)
 void update_robot_status_display(void);
 
+// Merge slider edits within one send window into a single all-joint command
+void ui_robot_set_batch_mode(bool enabled);
+
+// Stream jerk-limited interpolated moves toward the slider targets at a fixed rate
+void ui_robot_set_trajectory_mode(bool enabled);
+
+// Drive the tip in x/y/z (mm) instead of individual joints, solved on the device
+void ui_robot_set_cartesian_mode(bool enabled);
+
 #endif // UI_ROBOT_INTERFACE_H 
\ No newline at end of file
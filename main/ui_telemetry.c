@@ -0,0 +1,243 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <lvgl.h>
+#include "ui_telemetry.h"
+#include "robot_arm_telemetry.h"
+#include "screens.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+
+static const char *UI_TELEMETRY_TAG = "UI_TELEMETRY";
+
+// The chart shows the last TELEMETRY_WINDOW_S seconds as CHART_COLUMNS columns. Every sample
+// folds into the min/max bucket of its column, and a finished column is appended as two points
+// (its extremes in time order) in circular mode. Each refresh therefore touches a bounded number
+// of points and LVGL only redraws the strip around them, however long the window is.
+#define TELEMETRY_RATE_HZ     (CONFIG_ROBOT_ARM_TELEMETRY_RATE_HZ)
+#define TELEMETRY_WINDOW_S    (CONFIG_ROBOT_ARM_TELEMETRY_WINDOW_S)
+#define CHART_COLUMNS         300
+#define CHART_POINTS          (2 * CHART_COLUMNS)
+#define COLUMN_US             ((int64_t)TELEMETRY_WINDOW_S * 1000000 / CHART_COLUMNS)
+#define REFRESH_MS            100
+#define DRAW_REPORT_US        (1000 * 1000)
+#define PANEL_HEIGHT          330
+
+static lv_obj_t *panel = NULL;
+static lv_obj_t *chart = NULL;
+static lv_obj_t *info_label = NULL;
+static lv_chart_series_t *commanded_series[ROBOT_ARM_JOINT_COUNT];
+static lv_chart_series_t *measured_series[ROBOT_ARM_JOINT_COUNT];
+static lv_coord_t range_min[ROBOT_ARM_JOINT_COUNT];
+static lv_coord_t range_max[ROBOT_ARM_JOINT_COUNT];
+
+// Column being filled
+static robot_arm_minmax_t commanded_bucket[ROBOT_ARM_JOINT_COUNT];
+static robot_arm_minmax_t measured_bucket[ROBOT_ARM_JOINT_COUNT];
+static int64_t column_start_us = 0;
+
+// Shown joint (-1 while hidden), its latest and worst tracking error since it was shown
+static int selected = -1;
+static float latest_error = NAN;
+static float peak_error = 0.0f;
+
+// Time LVGL spends drawing the chart, reported as a share of wall time
+static int64_t draw_begin_us = 0;
+static int64_t draw_total_us = 0;
+static int64_t draw_window_start_us = 0;
+static float draw_share = 0.0f;
+
+static const char *joint_names[ROBOT_ARM_JOINT_COUNT] = { "Base", "Shoulder", "Arm", "Gripper" };
+
+// Chart values are milliradians
+static lv_coord_t to_chart_value(float radians)
+{
+    return (lv_coord_t)lroundf(radians * 1000.0f);
+}
+
+// Append a finished bucket as its two extremes, then break the trace just ahead of the write
+// position so the newest point is not joined to the oldest
+static void ui_telemetry_append(lv_chart_series_t *series, const robot_arm_minmax_t *bucket)
+{
+    float first, second;
+    bool known = robot_arm_minmax_get(bucket, &first, &second);
+    lv_chart_set_next_value(chart, series, known ? to_chart_value(first) : LV_CHART_POINT_NONE);
+    lv_chart_set_next_value(chart, series, known ? to_chart_value(second) : LV_CHART_POINT_NONE);
+    lv_chart_set_value_by_id(chart, series, series->start_point, LV_CHART_POINT_NONE);
+}
+
+static void ui_telemetry_close_column(void)
+{
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        ui_telemetry_append(commanded_series[i], &commanded_bucket[i]);
+        ui_telemetry_append(measured_series[i], &measured_bucket[i]);
+        robot_arm_minmax_reset(&commanded_bucket[i]);
+        robot_arm_minmax_reset(&measured_bucket[i]);
+    }
+}
+
+static void ui_telemetry_update_label(void)
+{
+    char error_text[24] = "--";
+    if (!isnan(latest_error)) {
+        snprintf(error_text, sizeof(error_text), "%.3f rad", latest_error);
+    }
+    lv_label_set_text_fmt(info_label,
+                          "%s  #2196F3 commanded#  #FFC107 measured#   error %s  peak %.3f rad   "
+                          "%d s window   draw %.1f%%  lost %lu",
+                          joint_names[selected], error_text, peak_error, TELEMETRY_WINDOW_S, draw_share,
+                          (unsigned long)robot_arm_telemetry_get_overruns());
+}
+
+// Drain the sample ring into the column buckets, closing every column the samples have passed.
+// Runs while hidden too, so the chart already holds the full window when it is opened.
+static void ui_telemetry_refresh(lv_timer_t *timer)
+{
+    robot_arm_telemetry_sample_t sample;
+    bool sampled = false;
+
+    while (robot_arm_telemetry_pop(&sample)) {
+        if (column_start_us == 0) {
+            column_start_us = sample.time_us;
+        }
+        // A gap in sampling leaves empty columns; one longer than the window clears the chart once
+        int64_t passed = (sample.time_us - column_start_us) / COLUMN_US;
+        for (int64_t n = 0; n < passed && n < CHART_COLUMNS; n++) {
+            ui_telemetry_close_column();
+        }
+        column_start_us += passed * COLUMN_US;
+
+        for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+            robot_arm_minmax_add(&commanded_bucket[i], sample.commanded[i]);
+            robot_arm_minmax_add(&measured_bucket[i], sample.measured[i]);
+        }
+        if (selected >= 0) {
+            latest_error = fabsf(sample.commanded[selected] - sample.measured[selected]);
+            if (latest_error > peak_error) {
+                peak_error = latest_error;
+            }
+        }
+        sampled = true;
+    }
+
+    int64_t now_us = esp_timer_get_time();
+    if (now_us - draw_window_start_us >= DRAW_REPORT_US) {
+        draw_share = 100.0f * (float)draw_total_us / (float)(now_us - draw_window_start_us);
+        draw_total_us = 0;
+        draw_window_start_us = now_us;
+    }
+
+    if (sampled && selected >= 0) {
+        ui_telemetry_update_label();
+    }
+}
+
+static void on_chart_draw(lv_event_t *e)
+{
+    if (lv_event_get_code(e) == LV_EVENT_DRAW_MAIN_BEGIN) {
+        draw_begin_us = esp_timer_get_time();
+    } else {
+        draw_total_us += esp_timer_get_time() - draw_begin_us;
+    }
+}
+
+static void on_panel_clicked(lv_event_t *e)
+{
+    ui_telemetry_show(-1);
+}
+
+static void on_joint_label_long_pressed(lv_event_t *e)
+{
+    ui_telemetry_show((int)(intptr_t)lv_event_get_user_data(e));
+}
+
+void ui_telemetry_init(const robot_arm_traj_limits_t limits[ROBOT_ARM_JOINT_COUNT])
+{
+    // The top layer keeps the chart above the screen without touching the generated layout
+    panel = lv_obj_create(lv_layer_top());
+    lv_obj_set_size(panel, LV_PCT(100), PANEL_HEIGHT);
+    lv_obj_align(panel, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_obj_set_style_bg_color(panel, lv_color_black(), LV_PART_MAIN);
+    lv_obj_set_style_bg_opa(panel, LV_OPA_90, LV_PART_MAIN);
+    lv_obj_set_style_border_width(panel, 0, LV_PART_MAIN);
+    lv_obj_set_style_radius(panel, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(panel, 8, LV_PART_MAIN);
+    lv_obj_clear_flag(panel, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_add_event_cb(panel, on_panel_clicked, LV_EVENT_CLICKED, NULL);
+
+    info_label = lv_label_create(panel);
+    lv_label_set_recolor(info_label, true);
+    lv_obj_set_style_text_color(info_label, lv_color_white(), LV_PART_MAIN);
+    lv_obj_set_style_text_font(info_label, &lv_font_montserrat_14, LV_PART_MAIN);
+    lv_obj_set_width(info_label, LV_PCT(100));
+    lv_label_set_long_mode(info_label, LV_LABEL_LONG_DOT);
+    lv_obj_align(info_label, LV_ALIGN_TOP_LEFT, 0, 0);
+
+    chart = lv_chart_create(panel);
+    lv_obj_set_size(chart, LV_PCT(100), PANEL_HEIGHT - 44);
+    lv_obj_align(chart, LV_ALIGN_BOTTOM_MID, 0, 0);
+    lv_chart_set_type(chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_update_mode(chart, LV_CHART_UPDATE_MODE_CIRCULAR);
+    lv_chart_set_point_count(chart, CHART_POINTS);
+    lv_chart_set_div_line_count(chart, 5, TELEMETRY_WINDOW_S / 10 - 1);
+    lv_obj_set_style_size(chart, 0, LV_PART_INDICATOR);   // Lines only, no point markers
+    lv_obj_set_style_line_width(chart, 2, LV_PART_ITEMS);
+    lv_obj_add_flag(chart, LV_OBJ_FLAG_EVENT_BUBBLE);
+    lv_obj_add_event_cb(chart, on_chart_draw, LV_EVENT_DRAW_MAIN_BEGIN, NULL);
+    lv_obj_add_event_cb(chart, on_chart_draw, LV_EVENT_DRAW_MAIN_END, NULL);
+
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        commanded_series[i] = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_BLUE), LV_CHART_AXIS_PRIMARY_Y);
+        measured_series[i] = lv_chart_add_series(chart, lv_palette_main(LV_PALETTE_AMBER), LV_CHART_AXIS_PRIMARY_Y);
+        lv_chart_set_all_value(chart, commanded_series[i], LV_CHART_POINT_NONE);
+        lv_chart_set_all_value(chart, measured_series[i], LV_CHART_POINT_NONE);
+        robot_arm_minmax_reset(&commanded_bucket[i]);
+        robot_arm_minmax_reset(&measured_bucket[i]);
+
+        // A little headroom so overshoot past the joint limits stays on the chart
+        lv_coord_t margin = (to_chart_value(limits[i].max_rad) - to_chart_value(limits[i].min_rad)) / 20;
+        range_min[i] = to_chart_value(limits[i].min_rad) - margin;
+        range_max[i] = to_chart_value(limits[i].max_rad) + margin;
+    }
+    lv_obj_add_flag(panel, LV_OBJ_FLAG_HIDDEN);
+
+    lv_obj_t *joint_labels[ROBOT_ARM_JOINT_COUNT] = {
+        objects.base_motor, objects.shoulder_motor, objects.arm_motor, objects.gripper_motor,
+    };
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        lv_obj_add_flag(joint_labels[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_event_cb(joint_labels[i], on_joint_label_long_pressed, LV_EVENT_LONG_PRESSED, (void *)(intptr_t)i);
+    }
+
+    draw_window_start_us = esp_timer_get_time();
+    lv_timer_create(ui_telemetry_refresh, REFRESH_MS, NULL);
+    if (robot_arm_telemetry_start(TELEMETRY_RATE_HZ) != ESP_OK) {
+        ESP_LOGE(UI_TELEMETRY_TAG, "Could not start joint telemetry");
+    }
+}
+
+void ui_telemetry_show(int joint_index)
+{
+    if (!panel) {
+        return;
+    }
+
+    if (joint_index < 0 || joint_index >= ROBOT_ARM_JOINT_COUNT) {
+        selected = -1;
+        lv_obj_add_flag(panel, LV_OBJ_FLAG_HIDDEN);
+        ESP_LOGI(UI_TELEMETRY_TAG, "Telemetry chart hidden");
+        return;
+    }
+
+    selected = joint_index;
+    latest_error = NAN;
+    peak_error = 0.0f;
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        lv_chart_hide_series(chart, commanded_series[i], i != selected);
+        lv_chart_hide_series(chart, measured_series[i], i != selected);
+    }
+    lv_chart_set_range(chart, LV_CHART_AXIS_PRIMARY_Y, range_min[selected], range_max[selected]);
+    ui_telemetry_update_label();
+    lv_obj_clear_flag(panel, LV_OBJ_FLAG_HIDDEN);
+    ESP_LOGI(UI_TELEMETRY_TAG, "Charting %s joint", joint_names[selected]);
+}
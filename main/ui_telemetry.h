@@ -0,0 +1,16 @@
+#ifndef UI_TELEMETRY_H
+#define UI_TELEMETRY_H
+
+#include <stdbool.h>
+#include "robot_arm_comm.h"
+#include "robot_arm_traj.h"
+
+// Create the joint telemetry chart and start sampling (hidden; long-press a joint's label to
+// chart that joint, tap the chart to hide it). limits give each joint's chart range.
+// Must be called with the LVGL lock held.
+void ui_telemetry_init(const robot_arm_traj_limits_t limits[ROBOT_ARM_JOINT_COUNT]);
+
+// Chart one joint (0 = base .. 3 = gripper), or hide the chart with -1 (LVGL lock held)
+void ui_telemetry_show(int joint_index);
+
+#endif // UI_TELEMETRY_H
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: CC0-1.0
  */
 
+#include "esp_check.h"
 #include "waveshare_rgb_lcd_port.h"
 
 static const char *TAG = "waveshare_rgb_lcd";
@@ -62,18 +63,19 @@ void waveshare_esp32_s3_touch_reset()
     // Reset the touch screen. It is recommended to reset the touch screen before using it.
     write_buf = 0x2C;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    esp_rom_delay_us(100 * 1000);
+    // Sleep rather than spin through the reset timing so the core stays free for other boot work
+    vTaskDelay(pdMS_TO_TICKS(100));
     gpio_set_level(GPIO_INPUT_IO_4, 0);
-    esp_rom_delay_us(100 * 1000);
+    vTaskDelay(pdMS_TO_TICKS(100));
     write_buf = 0x2E;
     i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    esp_rom_delay_us(200 * 1000);
+    vTaskDelay(pdMS_TO_TICKS(200));
 }
 
 #endif
 
-// Initialize RGB LCD
-esp_err_t waveshare_esp32_s3_rgb_lcd_init()
+// Install and initialize the RGB panel
+esp_err_t waveshare_rgb_lcd_panel_init(esp_lcd_panel_handle_t *panel_out)
 {
     ESP_LOGI(TAG, "Install RGB LCD panel driver"); // Log the start of the RGB LCD panel driver installation
     esp_lcd_panel_handle_t panel_handle = NULL; // Declare a handle for the LCD panel
@@ -128,15 +130,29 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
     };
 
     // Create a new RGB panel with the specified configuration
-    ESP_ERROR_CHECK(esp_lcd_new_rgb_panel(&panel_config, &panel_handle));
+    ESP_RETURN_ON_ERROR(esp_lcd_new_rgb_panel(&panel_config, &panel_handle), TAG, "RGB panel install failed");
 
     ESP_LOGI(TAG, "Initialize RGB LCD panel"); // Log the initialization of the RGB LCD panel
-    ESP_ERROR_CHECK(esp_lcd_panel_init(panel_handle)); // Initialize the LCD panel
+    esp_err_t err = esp_lcd_panel_init(panel_handle); // Initialize the LCD panel
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "RGB panel init failed: %s", esp_err_to_name(err));
+        esp_lcd_panel_del(panel_handle);
+        return err;
+    }
+
+    *panel_out = panel_handle;
+    return ESP_OK;
+}
 
+// Bring up the I2C bus and the touch controller (the bus is also used by the backlight).
+// Touch is NULL when the touch controller is disabled or failed to come up.
+esp_err_t waveshare_rgb_lcd_touch_init(esp_lcd_touch_handle_t *touch_out)
+{
+    *touch_out = NULL;
     esp_lcd_touch_handle_t tp_handle = NULL; // Declare a handle for the touch panel
 #if CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
     ESP_LOGI(TAG, "Initialize I2C bus"); // Log the initialization of the I2C bus
-    i2c_master_init(); // Initialize the I2C master
+    ESP_RETURN_ON_ERROR(i2c_master_init(), TAG, "I2C bus init failed"); // Initialize the I2C master
     ESP_LOGI(TAG, "Initialize GPIO"); // Log GPIO initialization
     gpio_init(); // Initialize GPIO pins
     ESP_LOGI(TAG, "Initialize Touch LCD"); // Log touch LCD initialization
@@ -146,7 +162,8 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
     const esp_lcd_panel_io_i2c_config_t tp_io_config = ESP_LCD_TOUCH_IO_I2C_GT911_CONFIG(); // Configure I2C for GT911 touch controller
 
     ESP_LOGI(TAG, "Initialize I2C panel IO"); // Log I2C panel I/O initialization
-    ESP_ERROR_CHECK(esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle)); // Create new I2C panel I/O
+    ESP_RETURN_ON_ERROR(esp_lcd_new_panel_io_i2c((esp_lcd_i2c_bus_handle_t)I2C_MASTER_NUM, &tp_io_config, &tp_io_handle),
+                        TAG, "Touch panel IO init failed"); // Create new I2C panel I/O
 
     ESP_LOGI(TAG, "Initialize touch controller GT911"); // Log touch controller initialization
     const esp_lcd_touch_config_t tp_cfg = {
@@ -164,10 +181,18 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
             .mirror_y = 0, // No mirroring of Y
         },
     };
-    ESP_ERROR_CHECK(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp_handle)); // Create new I2C GT911 touch controller
+    ESP_RETURN_ON_ERROR(esp_lcd_touch_new_i2c_gt911(tp_io_handle, &tp_cfg, &tp_handle),
+                        TAG, "GT911 touch controller not found"); // Create new I2C GT911 touch controller
 #endif // CONFIG_EXAMPLE_LCD_TOUCH_CONTROLLER_GT911
 
-    ESP_ERROR_CHECK(lvgl_port_init(panel_handle, tp_handle)); // Initialize LVGL with the panel and touch handles
+    *touch_out = tp_handle;
+    return ESP_OK;
+}
+
+// Start LVGL on the panel and touch controller
+esp_err_t waveshare_rgb_lcd_lvgl_init(esp_lcd_panel_handle_t panel_handle, esp_lcd_touch_handle_t tp_handle)
+{
+    ESP_RETURN_ON_ERROR(lvgl_port_init(panel_handle, tp_handle), TAG, "LVGL init failed"); // Initialize LVGL with the panel and touch handles
 
     // Register callbacks for RGB panel events
     esp_lcd_rgb_panel_event_callbacks_t cbs = {
@@ -177,22 +202,33 @@ esp_err_t waveshare_esp32_s3_rgb_lcd_init()
         .on_vsync = rgb_lcd_on_vsync_event, // Callback for vertical sync
 #endif
     };
-    ESP_ERROR_CHECK(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, NULL)); // Register event callbacks
+    ESP_RETURN_ON_ERROR(esp_lcd_rgb_panel_register_event_callbacks(panel_handle, &cbs, NULL),
+                        TAG, "RGB panel callbacks failed"); // Register event callbacks
 
     return ESP_OK; // Return success 
 }
 
+// Initialize RGB LCD
+esp_err_t waveshare_esp32_s3_rgb_lcd_init()
+{
+    esp_lcd_panel_handle_t panel_handle = NULL;
+    esp_lcd_touch_handle_t tp_handle = NULL;
+    ESP_RETURN_ON_ERROR(waveshare_rgb_lcd_panel_init(&panel_handle), TAG, "Panel init failed");
+    ESP_RETURN_ON_ERROR(waveshare_rgb_lcd_touch_init(&tp_handle), TAG, "Touch init failed");
+    return waveshare_rgb_lcd_lvgl_init(panel_handle, tp_handle);
+}
+
 /******************************* Turn on the screen backlight **************************************/
 esp_err_t waveshare_rgb_lcd_bl_on()
 {
     //Configure CH422G to output mode 
     uint8_t write_buf = 0x01;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
+    ESP_RETURN_ON_ERROR(i2c_master_write_to_device(I2C_MASTER_NUM, 0x24, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS),
+                        TAG, "IO expander not responding");
 
     //Pull the backlight pin high to light the screen backlight 
     write_buf = 0x1E;
-    i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
-    return ESP_OK;
+    return i2c_master_write_to_device(I2C_MASTER_NUM, 0x38, &write_buf, 1, I2C_MASTER_TIMEOUT_MS / portTICK_PERIOD_MS);
 }
 
 /******************************* Turn off the screen backlight **************************************/
@@ -71,6 +71,10 @@ bool example_lvgl_lock(int timeout_ms);
 void example_lvgl_unlock(void);
 
 esp_err_t waveshare_esp32_s3_rgb_lcd_init();
+// The same bring-up in separate steps, for running panel and touch init concurrently
+esp_err_t waveshare_rgb_lcd_panel_init(esp_lcd_panel_handle_t *panel_out);
+esp_err_t waveshare_rgb_lcd_touch_init(esp_lcd_touch_handle_t *touch_out);
+esp_err_t waveshare_rgb_lcd_lvgl_init(esp_lcd_panel_handle_t panel_handle, esp_lcd_touch_handle_t tp_handle);
 
 esp_err_t waveshare_rgb_lcd_bl_on();
 esp_err_t waveshare_rgb_lcd_bl_off();
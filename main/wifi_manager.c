@@ -1,4 +1,5 @@
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/event_groups.h"
@@ -6,11 +7,14 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
+#include "nvs.h"
 #include "esp_netif.h"
 #include "lwip/err.h"
 #include "lwip/sys.h"
 #include "wifi_manager.h"
+#include "status_bus.h"
 
 static const char *WIFI_TAG = "WIFI";
 
@@ -26,52 +30,365 @@ static wifi_status_t current_wifi_status = WIFI_STATUS_DISCONNECTED;
 static int s_retry_num = 0;
 static char ip_address[16] = {0};
 
+// Radio power save follows use of the panel: modem sleep while idle, no power save from the first
+// touch or command until the idle period has passed. In modem sleep the AP holds replies until
+// the next DTIM beacon, which shows up as 100+ ms command latency spikes. Both power save
+// timers run on the esp_timer task, so switches never race each other.
+#ifdef CONFIG_ROBOT_ARM_WIFI_POWER_SAVE
+#define WIFI_PS_IDLE_MS      (CONFIG_ROBOT_ARM_WIFI_PS_IDLE_MS)
+#define WIFI_PS_CHECK_MS     250
+static atomic_bool power_wake_pending = false;
+static atomic_uint last_activity_ms = 0;
+static esp_timer_handle_t power_wake_timer = NULL;
+static esp_timer_handle_t power_idle_timer = NULL;
+#endif
+
+static atomic_bool power_save_on = false;
+static int64_t power_mode_since_us = 0;
+static wifi_power_stats_t power_stats;
+
+// Record a status change and publish it on the status bus
+static void wifi_set_status(wifi_status_t status)
+{
+    current_wifi_status = status;
+    status_bus_publish(STATUS_TOPIC_WIFI, status);
+}
+
+// Fast connect: the last AP's BSSID and channel and the lease it gave are kept in NVS, so a warm
+// boot or a reconnect goes straight to that AP without scanning and, with the lease reused as a
+// static address, without DHCP. After a few failed directed attempts the full scan and DHCP path
+// takes over, and the cache is rewritten from whatever AP that finds.
+#define WIFI_NVS_NAMESPACE   "wifi"
+#define WIFI_NVS_KEY_AP      "fast_ap"
+#define WIFI_CACHE_VERSION   1
+#define WIFI_FAST_ATTEMPTS   3
+
+typedef struct {
+    uint32_t version;
+    char ssid[33];
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint32_t ip;
+    uint32_t netmask;
+    uint32_t gateway;
+} wifi_ap_cache_t;
+
+static wifi_ap_cache_t ap_cache;
+static bool ap_cache_valid = false;
+static bool fast_mode = false;          // The STA config is directed at the cached AP
+static int fast_failures = 0;
+static esp_netif_t *sta_netif = NULL;
+
+// Connect timing
+static int64_t connect_start_us = 0;    // Start of the current connect attempt
+static int64_t link_lost_us = 0;        // When the link went down (0 while up)
+static wifi_connect_stats_t connect_stats;
+
+static void wifi_cache_load(void)
+{
+    nvs_handle_t handle;
+    if (nvs_open(WIFI_NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        return;
+    }
+
+    size_t length = sizeof(ap_cache);
+    esp_err_t err = nvs_get_blob(handle, WIFI_NVS_KEY_AP, &ap_cache, &length);
+    nvs_close(handle);
+
+    ap_cache_valid = err == ESP_OK && length == sizeof(ap_cache) &&
+                     ap_cache.version == WIFI_CACHE_VERSION &&
+                     strncmp(ap_cache.ssid, WIFI_SSID, sizeof(ap_cache.ssid)) == 0 &&
+                     ap_cache.channel != 0;
+    if (ap_cache_valid) {
+        ESP_LOGI(WIFI_TAG, "Cached AP " MACSTR " on channel %d", MAC2STR(ap_cache.bssid), ap_cache.channel);
+    }
+}
+
+// Remember the AP and lease of a successful connect. Flash is only written when they changed.
+static void wifi_cache_store(const esp_netif_ip_info_t *ip_info)
+{
+    wifi_ap_record_t ap_info;
+    if (esp_wifi_sta_get_ap_info(&ap_info) != ESP_OK) {
+        return;
+    }
+
+    wifi_ap_cache_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.version = WIFI_CACHE_VERSION;
+    strncpy(entry.ssid, WIFI_SSID, sizeof(entry.ssid) - 1);
+    memcpy(entry.bssid, ap_info.bssid, sizeof(entry.bssid));
+    entry.channel = ap_info.primary;
+    entry.ip = ip_info->ip.addr;
+    entry.netmask = ip_info->netmask.addr;
+    entry.gateway = ip_info->gw.addr;
+
+    if (ap_cache_valid && memcmp(&entry, &ap_cache, sizeof(entry)) == 0) {
+        return;
+    }
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(WIFI_NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err == ESP_OK) {
+        err = nvs_set_blob(handle, WIFI_NVS_KEY_AP, &entry, sizeof(entry));
+        if (err == ESP_OK) {
+            err = nvs_commit(handle);
+        }
+        nvs_close(handle);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(WIFI_TAG, "Failed to cache AP: %s", esp_err_to_name(err));
+        return;
+    }
+
+    ap_cache = entry;
+    ap_cache_valid = true;
+    ESP_LOGI(WIFI_TAG, "Cached AP " MACSTR " on channel %d", MAC2STR(entry.bssid), entry.channel);
+}
+
+// Point the STA config at the cached AP (directed) or back at any AP with this SSID (full scan)
+static void wifi_set_directed(wifi_config_t *wifi_config, bool directed)
+{
+    wifi_config->sta.bssid_set = directed;
+    if (directed) {
+        memcpy(wifi_config->sta.bssid, ap_cache.bssid, sizeof(ap_cache.bssid));
+        wifi_config->sta.channel = ap_cache.channel;
+        wifi_config->sta.scan_method = WIFI_FAST_SCAN;
+    } else {
+        memset(wifi_config->sta.bssid, 0, sizeof(wifi_config->sta.bssid));
+        wifi_config->sta.channel = 0;
+        wifi_config->sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+    }
+    fast_mode = directed;
+    fast_failures = 0;
+}
+
+static void wifi_use_directed(bool directed)
+{
+    wifi_config_t wifi_config;
+    if (esp_wifi_get_config(WIFI_IF_STA, &wifi_config) != ESP_OK) {
+        return;
+    }
+    wifi_set_directed(&wifi_config, directed);
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_config);
+
+#ifdef CONFIG_ROBOT_ARM_WIFI_REUSE_LEASE
+    if (!directed) {
+        // The cached lease may be what failed; ask for a fresh one
+        esp_netif_dhcpc_start(sta_netif);
+    }
+#endif
+}
+
+// Once associated: skip DHCP by reusing the cached lease. Setting the address on the connected
+// interface raises IP_EVENT_STA_GOT_IP like a DHCP reply would.
+static void wifi_apply_lease(void)
+{
+#ifdef CONFIG_ROBOT_ARM_WIFI_REUSE_LEASE
+    if (!fast_mode || !ap_cache_valid) {
+        return;
+    }
+
+    esp_netif_ip_info_t ip_info = {
+        .ip.addr = ap_cache.ip,
+        .netmask.addr = ap_cache.netmask,
+        .gw.addr = ap_cache.gateway,
+    };
+    esp_err_t err = esp_netif_dhcpc_stop(sta_netif);
+    if (err == ESP_OK || err == ESP_ERR_ESP_NETIF_DHCP_ALREADY_STOPPED) {
+        err = esp_netif_set_ip_info(sta_netif, &ip_info);
+    }
+    if (err != ESP_OK) {
+        ESP_LOGW(WIFI_TAG, "Reusing lease failed (%s), using DHCP", esp_err_to_name(err));
+        esp_netif_dhcpc_start(sta_netif);
+    }
+#endif
+}
+
+#ifdef CONFIG_ROBOT_ARM_WIFI_POWER_SAVE
+static uint32_t wifi_now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+// Switch the radio power mode and account for the time spent in the previous one (esp_timer task)
+static void wifi_apply_power_save(bool on)
+{
+    int64_t start_us = esp_timer_get_time();
+    // Flag first: activity from here on sees power save on and schedules a wake behind this
+    atomic_store(&power_save_on, on);
+    esp_err_t err = esp_wifi_set_ps(on ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE);
+    int64_t now_us = esp_timer_get_time();
+
+    uint32_t spent_ms = (uint32_t)((now_us - power_mode_since_us) / 1000);
+    if (on) {
+        power_stats.awake_ms += spent_ms;
+        power_stats.sleeps++;
+    } else {
+        power_stats.power_save_ms += spent_ms;
+        power_stats.wakeups++;
+    }
+    power_mode_since_us = now_us;
+    power_stats.last_switch_us = (uint32_t)(now_us - start_us);
+
+    if (err != ESP_OK) {
+        ESP_LOGW(WIFI_TAG, "Setting power save %s failed: %s", on ? "on" : "off", esp_err_to_name(err));
+    } else {
+        ESP_LOGD(WIFI_TAG, "Power save %s (%lu us)", on ? "on" : "off", (unsigned long)power_stats.last_switch_us);
+    }
+}
+
+static void power_wake_timer_cb(void *arg)
+{
+    atomic_store(&power_wake_pending, false);
+    if (!atomic_load(&power_save_on)) {
+        return;
+    }
+    wifi_apply_power_save(false);
+    esp_timer_start_periodic(power_idle_timer, WIFI_PS_CHECK_MS * 1000);
+}
+
+static void power_idle_timer_cb(void *arg)
+{
+    if (wifi_now_ms() - atomic_load(&last_activity_ms) < WIFI_PS_IDLE_MS) {
+        return;
+    }
+    esp_timer_stop(power_idle_timer);
+    wifi_apply_power_save(true);
+}
+#endif
+
+// Start the power save policy once the radio is up
+static void wifi_power_init(void)
+{
+    power_mode_since_us = esp_timer_get_time();
+#ifdef CONFIG_ROBOT_ARM_WIFI_POWER_SAVE
+    const esp_timer_create_args_t wake_args = {
+        .callback = power_wake_timer_cb,
+        .name = "wifi_wake",
+    };
+    const esp_timer_create_args_t idle_args = {
+        .callback = power_idle_timer_cb,
+        .name = "wifi_idle",
+    };
+    if (esp_timer_create(&wake_args, &power_wake_timer) != ESP_OK ||
+        esp_timer_create(&idle_args, &power_idle_timer) != ESP_OK) {
+        ESP_LOGE(WIFI_TAG, "Failed to create power save timers, keeping power save off");
+        esp_wifi_set_ps(WIFI_PS_NONE);
+        return;
+    }
+
+    // Boot counts as activity: the panel is about to be used
+    atomic_store(&last_activity_ms, wifi_now_ms());
+    esp_wifi_set_ps(WIFI_PS_NONE);
+    esp_timer_start_periodic(power_idle_timer, WIFI_PS_CHECK_MS * 1000);
+#else
+    esp_wifi_set_ps(WIFI_PS_NONE);
+#endif
+}
+
+static void wifi_record_connect(bool fast)
+{
+    int64_t now = esp_timer_get_time();
+    uint32_t connect_ms = (uint32_t)((now - connect_start_us) / 1000);
+
+    connect_stats.last_connect_ms = connect_ms;
+    if (connect_stats.boot_to_connected_ms == 0) {
+        connect_stats.boot_to_connected_ms = (uint32_t)(now / 1000);
+    }
+    if (link_lost_us != 0) {
+        connect_stats.last_outage_ms = (uint32_t)((now - link_lost_us) / 1000);
+        link_lost_us = 0;
+    }
+    if (fast) {
+        connect_stats.fast_connects++;
+    } else {
+        connect_stats.full_connects++;
+    }
+
+    ESP_LOGI(WIFI_TAG, "Connected in %lu ms (%s), %lu ms since boot", (unsigned long)connect_ms,
+             fast ? "cached AP" : "scan", (unsigned long)(now / 1000));
+}
+
 // WiFi event handler
 static void event_handler(void* arg, esp_event_base_t event_base,
                          int32_t event_id, void* event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        connect_start_us = esp_timer_get_time();
         esp_wifi_connect();
-        current_wifi_status = WIFI_STATUS_CONNECTING;
+        wifi_set_status(WIFI_STATUS_CONNECTING);
         ESP_LOGI(WIFI_TAG, "WiFi started, connecting to %s", WIFI_SSID);
+    } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        wifi_apply_lease();
     } else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < WIFI_MAXIMUM_RETRY) {
+        connect_stats.disconnects++;
+        if (current_wifi_status == WIFI_STATUS_CONNECTED) {
+            // Link lost: the AP most likely comes back where it was, so reconnect directed
+            link_lost_us = esp_timer_get_time();
+            connect_start_us = link_lost_us;
+#ifdef CONFIG_ROBOT_ARM_WIFI_FAST_CONNECT
+            if (ap_cache_valid && !fast_mode) {
+                wifi_use_directed(true);
+            }
+#endif
+        } else if (fast_mode && ++fast_failures >= WIFI_FAST_ATTEMPTS) {
+            ESP_LOGW(WIFI_TAG, "Cached AP not reachable, scanning for %s", WIFI_SSID);
+            wifi_use_directed(false);
+        }
+
+        if (fast_mode) {
+            // Directed attempts are cheap and do not count against the retry limit
+            esp_wifi_connect();
+            wifi_set_status(WIFI_STATUS_CONNECTING);
+        } else if (s_retry_num < WIFI_MAXIMUM_RETRY) {
             esp_wifi_connect();
             s_retry_num++;
-            current_wifi_status = WIFI_STATUS_CONNECTING;
+            wifi_set_status(WIFI_STATUS_CONNECTING);
             ESP_LOGI(WIFI_TAG, "Retry to connect to the AP (%d/%d)", s_retry_num, WIFI_MAXIMUM_RETRY);
         } else {
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
-            current_wifi_status = WIFI_STATUS_FAILED;
+            wifi_set_status(WIFI_STATUS_FAILED);
             ESP_LOGI(WIFI_TAG, "Failed to connect to %s", WIFI_SSID);
         }
     } else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t* event = (ip_event_got_ip_t*) event_data;
         snprintf(ip_address, sizeof(ip_address), IPSTR, IP2STR(&event->ip_info.ip));
         ESP_LOGI(WIFI_TAG, "Connected! Got IP: %s", ip_address);
+        // A reused lease can be reported twice (on association and when it is set)
+        if (current_wifi_status != WIFI_STATUS_CONNECTED) {
+            wifi_record_connect(fast_mode);
+            wifi_cache_store(&event->ip_info);
+        }
         s_retry_num = 0;
-        current_wifi_status = WIFI_STATUS_CONNECTED;
+        fast_failures = 0;
+        wifi_set_status(WIFI_STATUS_CONNECTED);
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
     }
 }
 
-void wifi_init_sta(void)
+esp_err_t wifi_storage_init(void)
 {
-    // Initialize NVS
     esp_err_t ret = nvs_flash_init();
     if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND) {
-        ESP_ERROR_CHECK(nvs_flash_erase());
-        ret = nvs_flash_init();
+        ret = nvs_flash_erase();
+        if (ret == ESP_OK) {
+            ret = nvs_flash_init();
+        }
     }
-    ESP_ERROR_CHECK(ret);
+    return ret;
+}
 
+void wifi_start_sta(void)
+{
     // Create event group
     s_wifi_event_group = xEventGroupCreate();
+    wifi_set_status(WIFI_STATUS_DISCONNECTED);
 
     // Initialize network interface
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
-    esp_netif_create_default_wifi_sta();
+    sta_netif = esp_netif_create_default_wifi_sta();
+    wifi_cache_load();
 
     // Initialize WiFi
     wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
@@ -104,11 +421,36 @@ void wifi_init_sta(void)
         },
     };
 
+#ifdef CONFIG_ROBOT_ARM_WIFI_FAST_CONNECT
+    if (ap_cache_valid) {
+        wifi_set_directed(&wifi_config, true);
+    }
+#endif
+
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
+    wifi_power_init();
 
     ESP_LOGI(WIFI_TAG, "WiFi initialization finished. Connecting to %s...", WIFI_SSID);
+}
+
+bool wifi_wait_connected(TickType_t timeout)
+{
+    EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
+                                          WIFI_CONNECTED_BIT | WIFI_FAIL_BIT,
+                                          pdFALSE,
+                                          pdFALSE,
+                                          timeout);
+    return (bits & WIFI_CONNECTED_BIT) != 0;
+}
+
+void wifi_init_sta(void)
+{
+    // Initialize NVS
+    ESP_ERROR_CHECK(wifi_storage_init());
+
+    wifi_start_sta();
 
     // Wait for connection result
     EventBits_t bits = xEventGroupWaitBits(s_wifi_event_group,
@@ -141,17 +483,53 @@ char* wifi_get_ip_address(void)
     return ip_address;
 }
 
+void wifi_get_connect_stats(wifi_connect_stats_t *stats)
+{
+    *stats = connect_stats;
+}
+
+void wifi_note_activity(void)
+{
+#ifdef CONFIG_ROBOT_ARM_WIFI_POWER_SAVE
+    atomic_store(&last_activity_ms, wifi_now_ms());
+    // Wake on the esp_timer task so callers (touch, command submission) never wait on the radio
+    if (atomic_load(&power_save_on) && power_wake_timer && !atomic_exchange(&power_wake_pending, true)) {
+        esp_timer_start_once(power_wake_timer, 0);
+    }
+#endif
+}
+
+bool wifi_power_save_active(void)
+{
+    return atomic_load(&power_save_on);
+}
+
+void wifi_get_power_stats(wifi_power_stats_t *stats)
+{
+    *stats = power_stats;
+    stats->power_save = atomic_load(&power_save_on);
+    // Include the time spent in the current mode so far
+    uint32_t current_ms = power_mode_since_us ? (uint32_t)((esp_timer_get_time() - power_mode_since_us) / 1000) : 0;
+    if (stats->power_save) {
+        stats->power_save_ms += current_ms;
+    } else {
+        stats->awake_ms += current_ms;
+    }
+}
+
 void wifi_disconnect(void)
 {
     ESP_LOGI(WIFI_TAG, "Disconnecting from WiFi...");
     esp_wifi_disconnect();
-    current_wifi_status = WIFI_STATUS_DISCONNECTED;
+    wifi_set_status(WIFI_STATUS_DISCONNECTED);
 }
 
 void wifi_reconnect(void)
 {
     ESP_LOGI(WIFI_TAG, "Reconnecting to WiFi...");
     s_retry_num = 0;
-    current_wifi_status = WIFI_STATUS_CONNECTING;
+    xEventGroupClearBits(s_wifi_event_group, WIFI_FAIL_BIT);
+    wifi_set_status(WIFI_STATUS_CONNECTING);
+    connect_start_us = esp_timer_get_time();
     esp_wifi_connect();
 } 
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include "esp_wifi.h"
 #include "esp_event.h"
+#include "freertos/FreeRTOS.h"
 
 // WiFi credentials for the robot arm
 #define WIFI_SSID "RoArm-M2"
@@ -17,12 +18,39 @@ typedef enum {
     WIFI_STATUS_FAILED
 } wifi_status_t;
 
+// Connect timing. Times are 0 until measured.
+typedef struct {
+    uint32_t boot_to_connected_ms;   // Power-on to the first IP address
+    uint32_t last_connect_ms;        // Start of the last successful connect attempt to its IP address
+    uint32_t last_outage_ms;         // Link loss to IP address again, for the last reconnect
+    uint32_t fast_connects;          // Connects straight to the cached AP
+    uint32_t full_connects;          // Connects that needed a scan
+    uint32_t disconnects;            // Link losses and failed connect attempts
+} wifi_connect_stats_t;
+
+// Radio power save activity policy. Times are totals since WiFi started.
+typedef struct {
+    bool power_save;                 // Modem sleep is on right now
+    uint32_t wakeups;                // Switches to no power save on touch or command activity
+    uint32_t sleeps;                 // Returns to modem sleep after the idle period
+    uint32_t last_switch_us;         // How long the last esp_wifi_set_ps() took
+    uint32_t awake_ms;               // Time without power save
+    uint32_t power_save_ms;          // Time in modem sleep
+} wifi_power_stats_t;
+
 // Function declarations
-void wifi_init_sta(void);
+void wifi_init_sta(void);                  // NVS, start, and block until connected or failed
+esp_err_t wifi_storage_init(void);         // NVS flash (WiFi calibration data and the AP cache)
+void wifi_start_sta(void);                 // Start connecting in the background; NVS must be up
+bool wifi_wait_connected(TickType_t timeout);   // True once connected, false on failure or timeout
 wifi_status_t wifi_get_status(void);
 bool wifi_is_connected(void);
 char* wifi_get_ip_address(void);
 void wifi_disconnect(void);
 void wifi_reconnect(void);
+void wifi_get_connect_stats(wifi_connect_stats_t *stats);
+void wifi_note_activity(void);             // Touch or command activity (any task, does not block)
+bool wifi_power_save_active(void);
+void wifi_get_power_stats(wifi_power_stats_t *stats);
 
 #endif // WIFI_MANAGER_H 
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
+#include "esp_wifi.h"
+#include "wifi_manager.h"
+#include "wifi_supervisor.h"
+
+static const char *SUPERVISOR_TAG = "WIFI_SUP";
+
+#define SUPERVISOR_PERIOD_MS      500
+#define SUPERVISOR_STACK_SIZE     (3 * 1024)
+#define SUPERVISOR_PRIORITY       2
+#define SUPERVISOR_CORE           0
+
+// Reconnect rounds wait BACKOFF_MIN_MS << round, capped at BACKOFF_MAX_MS, of which the upper
+// half is random so panels that lost the same AP do not all come back in the same instant
+#define BACKOFF_MIN_MS            (CONFIG_ROBOT_ARM_WIFI_BACKOFF_MIN_MS)
+#define BACKOFF_MAX_MS            (CONFIG_ROBOT_ARM_WIFI_BACKOFF_MAX_MS)
+
+// Link quality: RSSI at or below RSSI_FLOOR_DBM scores 0, at or above RSSI_GOOD_DBM scores 100.
+// Every disconnect takes DISCONNECT_PENALTY points off, which fade by 1/16 per sample (a
+// half-life of about 5 s), so a link that keeps dropping is trusted less after it comes back.
+#define RSSI_FLOOR_DBM            (-85)
+#define RSSI_GOOD_DBM             (-60)
+#define DISCONNECT_PENALTY        40
+
+static TaskHandle_t supervisor_task_handle = NULL;
+static atomic_uint link_quality = WIFI_LINK_QUALITY_UNKNOWN;
+
+// Supervisor task only
+static int penalty_x16 = 0;
+static uint32_t last_disconnects = 0;
+static uint32_t backoff_round = 0;
+
+// Written by the supervisor task, copied out together by wifi_get_link_stats()
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static int rssi_x16 = 0;          // Smoothed RSSI (EWMA 1/4) in 1/16 dBm, 0 until sampled
+static int64_t retry_at_us = 0;   // 0 while no round is scheduled
+static wifi_link_stats_t link_stats;
+
+static void wifi_set_retry_at(int64_t at_us)
+{
+    portENTER_CRITICAL(&stats_lock);
+    retry_at_us = at_us;
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+static uint32_t wifi_backoff_ms(uint32_t round)
+{
+    uint32_t limit = BACKOFF_MAX_MS;
+    if (round < 16 && ((uint32_t)BACKOFF_MIN_MS << round) < limit) {
+        limit = (uint32_t)BACKOFF_MIN_MS << round;
+    }
+    return limit / 2 + esp_random() % (limit / 2 + 1);
+}
+
+static void wifi_sample_link(bool connected)
+{
+    wifi_connect_stats_t connect;
+    wifi_get_connect_stats(&connect);
+    uint32_t drops = connect.disconnects - last_disconnects;
+    last_disconnects = connect.disconnects;
+    penalty_x16 += (int)drops * DISCONNECT_PENALTY * 16;
+    penalty_x16 -= penalty_x16 / 16;
+
+    // Without a link there is nothing to judge; the next connection is not held back by the
+    // last one until its own first sample
+    wifi_ap_record_t ap;
+    if (!connected || esp_wifi_sta_get_ap_info(&ap) != ESP_OK) {
+        atomic_store(&link_quality, WIFI_LINK_QUALITY_UNKNOWN);
+        return;
+    }
+
+    int rssi = (rssi_x16 == 0) ? ap.rssi * 16 : rssi_x16 + (ap.rssi * 16 - rssi_x16) / 4;
+    portENTER_CRITICAL(&stats_lock);
+    rssi_x16 = rssi;
+    portEXIT_CRITICAL(&stats_lock);
+    int score = (rssi - RSSI_FLOOR_DBM * 16) * 100 / ((RSSI_GOOD_DBM - RSSI_FLOOR_DBM) * 16);
+    score -= penalty_x16 / 16;
+    if (score < 0) score = 0;
+    if (score > 100) score = 100;
+    atomic_store(&link_quality, (unsigned int)score);
+}
+
+static void wifi_supervisor_task(void *arg)
+{
+    ESP_LOGI(SUPERVISOR_TAG, "Link supervisor started");
+
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(SUPERVISOR_PERIOD_MS));
+
+        wifi_status_t status = wifi_get_status();
+        wifi_sample_link(status == WIFI_STATUS_CONNECTED);
+
+        if (status == WIFI_STATUS_CONNECTED) {
+            if (backoff_round > 0) {
+                portENTER_CRITICAL(&stats_lock);
+                link_stats.recoveries++;
+                portEXIT_CRITICAL(&stats_lock);
+                ESP_LOGI(SUPERVISOR_TAG, "Link recovered after %lu reconnect rounds", (unsigned long)backoff_round);
+            }
+            backoff_round = 0;
+            wifi_set_retry_at(0);
+        } else if (status == WIFI_STATUS_FAILED) {
+            // The manager has used up its retries; nothing else will try again
+            int64_t now_us = esp_timer_get_time();
+            if (retry_at_us == 0) {
+                uint32_t wait_ms = wifi_backoff_ms(backoff_round);
+                wifi_set_retry_at(now_us + (int64_t)wait_ms * 1000);
+                ESP_LOGW(SUPERVISOR_TAG, "WiFi failed, next reconnect round in %lu ms", (unsigned long)wait_ms);
+            } else if (now_us >= retry_at_us) {
+                backoff_round++;
+                portENTER_CRITICAL(&stats_lock);
+                retry_at_us = 0;
+                link_stats.recovery_attempts++;
+                portEXIT_CRITICAL(&stats_lock);
+                wifi_reconnect();
+            }
+        } else {
+            // Connecting, or disconnected on purpose
+            wifi_set_retry_at(0);
+        }
+    }
+}
+
+esp_err_t wifi_supervisor_start(void)
+{
+    if (supervisor_task_handle) {
+        return ESP_OK;
+    }
+
+    BaseType_t ret = xTaskCreatePinnedToCore(wifi_supervisor_task, "wifi_sup", SUPERVISOR_STACK_SIZE, NULL,
+                                             SUPERVISOR_PRIORITY, &supervisor_task_handle, SUPERVISOR_CORE);
+    if (ret != pdPASS) {
+        ESP_LOGE(SUPERVISOR_TAG, "Failed to create link supervisor task");
+        supervisor_task_handle = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+uint8_t wifi_get_link_quality(void)
+{
+    return (uint8_t)atomic_load(&link_quality);
+}
+
+void wifi_get_link_stats(wifi_link_stats_t *stats)
+{
+    portENTER_CRITICAL(&stats_lock);
+    *stats = link_stats;
+    int rssi = rssi_x16;
+    int64_t at_us = retry_at_us;
+    portEXIT_CRITICAL(&stats_lock);
+
+    stats->rssi = (int8_t)(rssi / 16);
+    stats->quality = wifi_get_link_quality();
+    int64_t until_us = at_us ? at_us - esp_timer_get_time() : 0;
+    stats->next_retry_ms = (until_us > 0) ? (uint32_t)(until_us / 1000) : 0;
+}
@@ -0,0 +1,28 @@
+#ifndef WIFI_SUPERVISOR_H
+#define WIFI_SUPERVISOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+// Reconnect supervisor: once the WiFi manager gives up (WIFI_STATUS_FAILED) it retries forever,
+// waiting a jittered exponential backoff between rounds so a panel left running through an AP
+// outage comes back on its own without hammering the AP. While connected it samples RSSI and the
+// disconnect count and turns them into a 0..100 link quality score the command path paces by.
+// Until a connection has been sampled the score is WIFI_LINK_QUALITY_UNKNOWN, which caps nothing.
+#define WIFI_LINK_QUALITY_UNKNOWN 255
+
+typedef struct {
+    int8_t rssi;                  // Smoothed RSSI in dBm, 0 until sampled
+    uint8_t quality;              // Link quality 0..100, WIFI_LINK_QUALITY_UNKNOWN while not sampled
+    uint32_t recovery_attempts;   // Reconnect rounds started after the manager gave up
+    uint32_t recoveries;          // Rounds that ended connected
+    uint32_t next_retry_ms;       // Time until the next round, 0 if none is scheduled
+} wifi_link_stats_t;
+
+// Function declarations
+esp_err_t wifi_supervisor_start(void);     // After wifi_start_sta()
+uint8_t wifi_get_link_quality(void);       // Any task, does not block
+void wifi_get_link_stats(wifi_link_stats_t *stats);
+
+#endif // WIFI_SUPERVISOR_H
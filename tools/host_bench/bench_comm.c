@@ -0,0 +1,613 @@
+// Command-throughput benchmark for the comm stack. Links the firmware's robot_arm_comm.c and
+// transports against the host shims and drives them against mock_roarm (or anything else that
+// speaks /js?json=).
+//
+//   bench_comm [-p port] [-T http|ws|uart] [-U serial] [-m ordered|joints|joint|stop|timed|fleet] [-A ip,ip...] [-t seconds] [-w window] [-r rate_hz] [-W warmup]
+//
+// Modes:
+//   ordered  Closed loop: keep <window> T:105 requests queued, submitting one per completion.
+//            Measures raw round-trip throughput of the ordered queue.
+//   joints   Open loop: submit an all-joint move (T:102) at <rate> Hz, as the trajectory
+//            streamer does. Shows pacing, coalescing and delivered rate.
+//   joint    Open loop: single-joint slider steps (T:101) at <rate> Hz, cycling the joints,
+//            served from the pre-encoded command cache like the UI sliders.
+//   stop     The joints workload, with a torque-off (T:210) fired into it every STOP_PERIOD_MS
+//            and torque back on right after. Fails if any torque-off took longer than
+//            CONFIG_ROBOT_ARM_PRIORITY_DEADLINE_MS from submit to send.
+//   timed    The joints workload submitted timed, as pose playback does: every move is sent in
+//            order, bypassing the pacer and the latest-wins slot. Fails if any was coalesced.
+//   fleet    The fleet API instead of the single-arm one: adds one arm per -A address, all at
+//            once from separate threads, then broadcasts the joints workload at <rate> Hz. Each
+//            address needs its own mock (mock_roarm -a). Fails if the arms did not all land in
+//            their own slot, if moves of two joints submitted back to back were not both sent,
+//            or if any arm sent nothing or saw a failure.
+//
+// -T picks the transport; a run on WebSocket or UART fails if the comm task had to fall back to
+// HTTP. UART opens the serial device given with -U, e.g. the pty of mock_roarm -u. An ordered run
+// also fails if no feedback reply was parsed, which over UART is the RX task's only evidence.
+//
+// Prints a human-readable report and one "RESULT key=value ..." line for scripts and CI.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <sys/resource.h>
+#include "host_shim.h"
+#include "robot_arm_comm.h"
+#include "robot_arm_cmd_cache.h"
+#include "robot_arm_feedback.h"
+#include "robot_arm_stats.h"
+#include "robot_arm_fleet.h"
+#include "esp_timer.h"
+
+typedef enum {
+    BENCH_ORDERED,
+    BENCH_JOINTS,
+    BENCH_JOINT,
+    BENCH_STOP,
+    BENCH_TIMED,
+    BENCH_FLEET,
+} bench_mode_t;
+
+static const char *const mode_names[] = { "ordered", "joints", "joint", "stop", "timed", "fleet" };
+static const char *const transport_names[] = { "http", "ws", "uart" };
+
+// Longer than the HTTP transport's timeout, so a dropped request is counted as a timeout
+#define DRAIN_TIMEOUT_MS    6000
+
+// Stop mode: how often torque-off cuts into the stream
+#define STOP_PERIOD_MS      100
+
+// Slider range of the UI, so joint mode hits the same cache entries the panel does
+#define SLIDER_STEPS        100
+#define JOINT_SPEED         0
+#define JOINT_ACCELERATION  10
+static const float joint_range[ROBOT_ARM_JOINT_COUNT][2] = {
+    { -1.57f, 1.57f }, { -0.2f, 1.4f }, { -1.0f, 1.5f }, { 1.08f, 3.14f },
+};
+
+static struct {
+    int port;
+    robot_arm_transport_kind_t transport;
+    const char *serial;
+    const char *fleet_ips;
+    bench_mode_t mode;
+    int seconds;
+    int window;
+    int rate_hz;
+    int warmup;
+} options = { .port = 8080, .fleet_ips = "127.0.0.1,127.0.0.2", .transport = ROBOT_ARM_TRANSPORT_HTTP, .mode = BENCH_ORDERED, .seconds = 10, .window = 4, .rate_hz = 100, .warmup = 20 };
+
+// Completion accounting, updated from the comm task's callbacks
+static robot_arm_latency_hist_t e2e_hist;
+static atomic_uint completed_ok, completed_failed, completed_timeout;
+static atomic_bool measuring;
+static pthread_mutex_t window_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t window_cond = PTHREAD_COND_INITIALIZER;
+static int outstanding;
+
+// User and system CPU of the whole process: comm task, priority task, shims and this driver
+static void cpu_seconds(double *user, double *sys)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    *user = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6;
+    *sys = usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+static void sleep_until(struct timespec *when)
+{
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, when, NULL) != 0) {
+    }
+}
+
+// user_data carries the submit timestamp, so nothing is allocated per command
+static void on_done(const robot_arm_cmd_t *cmd, robot_arm_comm_status_t status, void *user_data)
+{
+    (void)cmd;
+    int64_t submit_us = (int64_t)(intptr_t)user_data;
+
+    if (atomic_load(&measuring)) {
+        if (status == ROBOT_ARM_COMM_OK) {
+            atomic_fetch_add(&completed_ok, 1);
+            robot_arm_latency_record(&e2e_hist, esp_timer_get_time() - submit_us);
+        } else {
+            atomic_fetch_add(status == ROBOT_ARM_COMM_TIMEOUT ? &completed_timeout : &completed_failed, 1);
+        }
+    }
+
+    pthread_mutex_lock(&window_lock);
+    outstanding--;
+    pthread_cond_signal(&window_cond);
+    pthread_mutex_unlock(&window_lock);
+}
+
+// Submit one command and count it as outstanding until its callback runs
+static bool submit(const robot_arm_cmd_t *cmd)
+{
+    pthread_mutex_lock(&window_lock);
+    outstanding++;
+    pthread_mutex_unlock(&window_lock);
+
+    void *stamp = (void *)(intptr_t)esp_timer_get_time();
+    robot_arm_comm_status_t queued = (options.mode == BENCH_TIMED) ? robot_arm_submit_timed(cmd, on_done, stamp)
+                                                                   : robot_arm_submit(cmd, on_done, stamp);
+    if (queued != ROBOT_ARM_COMM_OK) {
+        pthread_mutex_lock(&window_lock);
+        outstanding--;
+        pthread_mutex_unlock(&window_lock);
+        return false;
+    }
+    return true;
+}
+
+// Commands since the snapshot that will never get a callback. Flushed counts stale moves too,
+// which are called back, so this can let a wait end a few commands early, never hang it.
+static int uncalled(uint32_t coalesced_before, const robot_arm_priority_stats_t *priority_before)
+{
+    robot_arm_priority_stats_t priority;
+    robot_arm_get_priority_stats(&priority);
+    return (int)(robot_arm_get_coalesced_count() - coalesced_before + priority.flushed - priority_before->flushed);
+}
+
+// Wait until at most <limit> commands are outstanding, or the deadline passes
+static bool wait_outstanding(int limit, int64_t deadline_us)
+{
+    pthread_mutex_lock(&window_lock);
+    while (outstanding > limit && esp_timer_get_time() < deadline_us) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);  // window_cond uses the default clock
+        ts.tv_nsec += 10 * 1000000;
+        if (ts.tv_nsec >= 1000000000) {
+            ts.tv_sec++;
+            ts.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&window_cond, &window_lock, &ts);
+    }
+    bool drained = (outstanding <= limit);
+    pthread_mutex_unlock(&window_lock);
+    return drained;
+}
+
+static void build_command(uint32_t n, robot_arm_cmd_t *cmd)
+{
+    memset(cmd, 0, sizeof(*cmd));
+    switch (options.mode) {
+        case BENCH_ORDERED:
+            cmd->type = ROBOT_ARM_CMD_FEEDBACK;
+            break;
+        case BENCH_JOINTS:
+        case BENCH_STOP:
+        case BENCH_TIMED:
+        case BENCH_FLEET: {
+            // Slow sweep of every joint across its range
+            cmd->type = ROBOT_ARM_CMD_MOVE_JOINTS;
+            cmd->joints.speed = JOINT_SPEED;
+            cmd->joints.acceleration = JOINT_ACCELERATION;
+            float phase = (float)n / (float)options.rate_hz;
+            for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+                float mid = 0.5f * (joint_range[i][0] + joint_range[i][1]);
+                float half = 0.5f * (joint_range[i][1] - joint_range[i][0]);
+                cmd->joints.radians[i] = mid + half * sinf(phase + (float)i);
+            }
+            break;
+        }
+        case BENCH_JOINT: {
+            // The same quantized positions the sliders produce
+            int joint = (int)(n % ROBOT_ARM_JOINT_COUNT);
+            int step = (int)((n / ROBOT_ARM_JOINT_COUNT) % (2 * SLIDER_STEPS));
+            step = (step > SLIDER_STEPS) ? 2 * SLIDER_STEPS - step : step;
+            const float *range = joint_range[joint];
+            cmd->type = ROBOT_ARM_CMD_MOVE_JOINT;
+            cmd->move.joint = (robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + joint);
+            cmd->move.radians = range[0] + (float)step * (range[1] - range[0]) / (float)SLIDER_STEPS;
+            cmd->move.speed = JOINT_SPEED;
+            cmd->move.acceleration = JOINT_ACCELERATION;
+            break;
+        }
+    }
+}
+
+static uint32_t run_ordered(int64_t end_us)
+{
+    uint32_t submitted = 0;
+    robot_arm_cmd_t cmd;
+    while (esp_timer_get_time() < end_us) {
+        if (!wait_outstanding(options.window - 1, end_us)) {
+            break;
+        }
+        build_command(submitted, &cmd);
+        submitted += submit(&cmd);
+    }
+    return submitted;
+}
+
+static uint32_t run_open_loop(int64_t end_us)
+{
+    uint32_t submitted = 0;
+    long period_ns = 1000000000L / options.rate_hz;
+    uint32_t stop_every = (uint32_t)(options.rate_hz * STOP_PERIOD_MS / 1000);
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    robot_arm_cmd_t cmd;
+    for (uint32_t n = 0; esp_timer_get_time() < end_us; n++) {
+        if (options.mode == BENCH_STOP && n % (stop_every ? stop_every : 1) == 0) {
+            // Moves are rejected in between, so torque goes back on before the next one
+            robot_arm_cmd_t torque = { .type = ROBOT_ARM_CMD_TORQUE, .torque_on = false };
+            submitted += submit(&torque);
+            torque.torque_on = true;
+            submitted += submit(&torque);
+        }
+        build_command(n, &cmd);
+        submitted += submit(&cmd);
+        next.tv_nsec += period_ns;
+        while (next.tv_nsec >= 1000000000) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000;
+        }
+        sleep_until(&next);
+    }
+    return submitted;
+}
+
+static void *fleet_add_thread(void *ip)
+{
+    return robot_arm_fleet_add(ip);
+}
+
+// Per-joint latest-wins: moves of two joints submitted back to back are both sent
+static atomic_uint fleet_joint_moves_ok;
+
+static void on_fleet_joint_done(const robot_arm_cmd_t *cmd, robot_arm_comm_status_t status, void *user_data)
+{
+    (void)cmd;
+    (void)user_data;
+    if (status == ROBOT_ARM_COMM_OK) {
+        atomic_fetch_add(&fleet_joint_moves_ok, 1);
+    }
+}
+
+static bool fleet_check_joint_moves(robot_arm_t *const arms[], int count)
+{
+    for (int i = 0; i < count; i++) {
+        // A status request first keeps the worker on the wire while both moves wait
+        robot_arm_cmd_t status = { .type = ROBOT_ARM_CMD_FEEDBACK };
+        robot_arm_fleet_submit(arms[i], &status, NULL, NULL);
+        for (int joint = ROBOT_ARM_JOINT_BASE; joint <= ROBOT_ARM_JOINT_SHOULDER; joint++) {
+            robot_arm_cmd_t cmd = {
+                .type = ROBOT_ARM_CMD_MOVE_JOINT,
+                .move = { .joint = (robot_arm_joint_t)joint, .radians = 0.1f, .speed = JOINT_SPEED,
+                          .acceleration = JOINT_ACCELERATION },
+            };
+            robot_arm_fleet_submit(arms[i], &cmd, on_fleet_joint_done, NULL);
+        }
+    }
+
+    unsigned int expected = (unsigned int)count * 2;
+    int64_t deadline_us = esp_timer_get_time() + DRAIN_TIMEOUT_MS * 1000;
+    while (atomic_load(&fleet_joint_moves_ok) < expected && esp_timer_get_time() < deadline_us) {
+        usleep(1000);
+    }
+    unsigned int ok = atomic_load(&fleet_joint_moves_ok);
+    printf("  two joints moved back to back: %u/%u sent\n", ok, expected);
+    return ok == expected;
+}
+
+// Fleet mode: returns the exit status
+static int run_fleet(void)
+{
+    char list[256];
+    snprintf(list, sizeof(list), "%s", options.fleet_ips);
+    const char *ips[CONFIG_ROBOT_ARM_FLEET_MAX_ARMS];
+    int count = 0;
+    for (char *ip = strtok(list, ","); ip && count < CONFIG_ROBOT_ARM_FLEET_MAX_ARMS; ip = strtok(NULL, ",")) {
+        ips[count++] = ip;
+    }
+
+    // Add every arm at the same time, as tasks bringing up their own arm would
+    pthread_t threads[CONFIG_ROBOT_ARM_FLEET_MAX_ARMS];
+    robot_arm_t *arms[CONFIG_ROBOT_ARM_FLEET_MAX_ARMS];
+    for (int i = 0; i < count; i++) {
+        pthread_create(&threads[i], NULL, fleet_add_thread, (void *)ips[i]);
+    }
+    bool added = true;
+    for (int i = 0; i < count; i++) {
+        void *arm;
+        pthread_join(threads[i], &arm);
+        arms[i] = arm;
+        added = added && arms[i];
+        for (int j = 0; j < i && added; j++) {
+            added = (arms[j] != arms[i]);
+        }
+    }
+    added = added && robot_arm_fleet_count() == count;
+    // Slots are handed out in whatever order the adds got there; each must hold one of the arms
+    for (int i = 0; i < count && added; i++) {
+        robot_arm_t *arm = robot_arm_fleet_get(i);
+        added = false;
+        for (int j = 0; j < count; j++) {
+            added = added || (arm && arm == arms[j]);
+        }
+    }
+    printf("mode fleet, %d arms added concurrently: %s\n", robot_arm_fleet_count(), added ? "ok" : "FAILED");
+    if (!added || !fleet_check_joint_moves(arms, count)) {
+        return 1;
+    }
+
+    long period_ns = 1000000000L / options.rate_hz;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    int64_t start_us = esp_timer_get_time();
+    int64_t end_us = start_us + (int64_t)options.seconds * 1000000;
+    uint32_t broadcasts = 0;
+    uint32_t rejected = 0;
+    robot_arm_cmd_t cmd;
+    for (uint32_t n = 0; esp_timer_get_time() < end_us; n++) {
+        build_command(n, &cmd);
+        broadcasts++;
+        rejected += (robot_arm_fleet_broadcast(&cmd) != ROBOT_ARM_COMM_OK);
+        next.tv_nsec += period_ns;
+        while (next.tv_nsec >= 1000000000) {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000;
+        }
+        sleep_until(&next);
+    }
+
+    // Every broadcast ends up sent or coalesced on each arm
+    int64_t drain_deadline_us = esp_timer_get_time() + DRAIN_TIMEOUT_MS * 1000;
+    bool drained = false;
+    while (!drained && esp_timer_get_time() < drain_deadline_us) {
+        drained = true;
+        for (int i = 0; i < count; i++) {
+            robot_arm_fleet_arm_stats_t stats;
+            robot_arm_fleet_get_arm_stats(arms[i], &stats);
+            drained = drained && stats.sent + stats.coalesced + stats.dropped >= broadcasts;
+        }
+        usleep(10 * 1000);
+    }
+    double elapsed_s = (esp_timer_get_time() - start_us) / 1e6;
+
+    bool ok = drained && rejected == 0;
+    uint32_t late = 0;
+    for (int i = 0; i < count; i++) {
+        robot_arm_fleet_arm_stats_t stats;
+        robot_arm_fleet_get_arm_stats(arms[i], &stats);
+        printf("  %-15s sent %u (%.1f/s), %u failed, %u coalesced, %u late, wire us p50 %u p99 %u max %u\n",
+               robot_arm_fleet_get_ip(arms[i]), stats.sent, stats.sent / elapsed_s, stats.failures, stats.coalesced,
+               stats.late_broadcasts, stats.p50_us, stats.p99_us, stats.max_us);
+        ok = ok && stats.sent > 0 && stats.failures == 0;
+        late += stats.late_broadcasts;
+    }
+    robot_arm_fleet_stats_t fleet;
+    robot_arm_fleet_get_stats(&fleet);
+    printf("  broadcast skew  max %u us over %u broadcasts, %u rejected\n", fleet.max_skew_us, fleet.broadcasts, rejected);
+    printf("RESULT mode=fleet arms=%d seconds=%.2f broadcasts=%u rejected=%u late=%u max_skew_us=%u drained=%d\n",
+           count, elapsed_s, broadcasts, rejected, late, fleet.max_skew_us, drained);
+    return ok ? 0 : 1;
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [-p port] [-T http|ws|uart] [-U serial] [-m ordered|joints|joint|stop|timed|fleet] [-A ip,ip...] [-t seconds] [-w window] [-r rate_hz] [-W warmup]\n"
+            "  -p  mock server port on 127.0.0.1 (default 8080)\n"
+            "  -T  transport (default http)\n"
+            "  -U  serial device the UART transport opens (e.g. the link made by mock_roarm -u)\n"
+            "  -m  workload (default ordered)\n"
+            "  -A  fleet mode: robot addresses, one mock each (default 127.0.0.1,127.0.0.2)\n"
+            "  -t  measured duration in seconds (default 10)\n"
+            "  -w  ordered mode: commands kept queued (default 4)\n"
+            "  -r  joints/joint/stop/timed/fleet mode: submit rate in Hz (default 100)\n"
+            "  -W  ordered commands sent before measuring, to open the session (default 20)\n",
+            argv0);
+}
+
+static int find_name(const char *name, const char *const names[], size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static bool parse_options(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "p:T:U:m:A:t:w:r:W:h")) != -1) {
+        switch (opt) {
+            case 'p': options.port = atoi(optarg); break;
+            case 'U': options.serial = optarg; break;
+            case 'A': options.fleet_ips = optarg; break;
+            case 't': options.seconds = atoi(optarg); break;
+            case 'w': options.window = atoi(optarg); break;
+            case 'r': options.rate_hz = atoi(optarg); break;
+            case 'W': options.warmup = atoi(optarg); break;
+            case 'm': {
+                int found = find_name(optarg, mode_names, sizeof(mode_names) / sizeof(mode_names[0]));
+                if (found < 0) {
+                    usage(argv[0]);
+                    return false;
+                }
+                options.mode = (bench_mode_t)found;
+                break;
+            }
+            case 'T': {
+                int found = find_name(optarg, transport_names, sizeof(transport_names) / sizeof(transport_names[0]));
+                if (found < 0) {
+                    usage(argv[0]);
+                    return false;
+                }
+                options.transport = (robot_arm_transport_kind_t)found;
+                break;
+            }
+            default:
+                usage(argv[0]);
+                return false;
+        }
+    }
+    if (options.seconds <= 0 || options.window <= 0 || options.rate_hz <= 0 || options.warmup < 0) {
+        usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    if (!parse_options(argc, argv)) {
+        return 2;
+    }
+
+    host_shim_http_port = options.port;
+    host_shim_uart_path = options.serial;
+    if (options.mode == BENCH_FLEET) {
+        return run_fleet();
+    }
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        robot_arm_cmd_cache_build((robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + i), joint_range[i][0], joint_range[i][1],
+                                  JOINT_SPEED, JOINT_ACCELERATION);
+    }
+    if (robot_arm_init("127.0.0.1") != ROBOT_ARM_COMM_OK) {
+        fprintf(stderr, "bench_comm: robot_arm_init failed\n");
+        return 1;
+    }
+    robot_arm_set_transport(options.transport);
+
+    // Warm up: open the keep-alive session outside the measured window
+    robot_arm_cmd_t warm = { .type = ROBOT_ARM_CMD_FEEDBACK };
+    for (int i = 0; i < options.warmup; i++) {
+        submit(&warm);
+        wait_outstanding(0, esp_timer_get_time() + 10 * 1000000);
+    }
+    robot_arm_stats_reset();
+    uint32_t coalesced_before = robot_arm_get_coalesced_count();
+    robot_arm_priority_stats_t priority_before;
+    robot_arm_get_priority_stats(&priority_before);
+    uint32_t dropped_before = robot_arm_get_dropped_count();
+    robot_arm_session_stats_t session_before;
+    robot_arm_get_session_stats(&session_before);
+    robot_arm_feedback_t feedback_before = { 0 };
+    robot_arm_get_feedback(&feedback_before);
+
+    robot_arm_stats_t stats_before;
+    robot_arm_stats_get(&stats_before);
+    atomic_store(&measuring, true);
+    double user_start, sys_start;
+    cpu_seconds(&user_start, &sys_start);
+    int64_t start_us = esp_timer_get_time();
+    int64_t end_us = start_us + (int64_t)options.seconds * 1000000;
+
+    uint32_t submitted = (options.mode == BENCH_ORDERED) ? run_ordered(end_us) : run_open_loop(end_us);
+
+    // Let commands already queued or in flight finish (up to the HTTP timeout); a coalesced
+    // move, or one a torque-off flushed, never gets a callback, so it stays counted as outstanding
+    int64_t drain_deadline_us = esp_timer_get_time() + DRAIN_TIMEOUT_MS * 1000;
+    while (!wait_outstanding(uncalled(coalesced_before, &priority_before), esp_timer_get_time() + 10 * 1000) &&
+           esp_timer_get_time() < drain_deadline_us) {
+    }
+    int64_t elapsed_us = esp_timer_get_time() - start_us;
+    double user_end, sys_end;
+    cpu_seconds(&user_end, &sys_end);
+    double cpu_user = user_end - user_start;
+    double cpu_sys = sys_end - sys_start;
+    double cpu_used = cpu_user + cpu_sys;
+    atomic_store(&measuring, false);
+
+    robot_arm_stats_t stats;
+    robot_arm_stats_get(&stats);
+    robot_arm_session_stats_t session;
+    robot_arm_get_session_stats(&session);
+    robot_arm_rate_state_t rate;
+    robot_arm_get_rate_state(&rate);
+    uint32_t cache_hits, cache_misses;
+    robot_arm_cmd_cache_get_stats(&cache_hits, &cache_misses);
+    robot_arm_feedback_t feedback = { 0 };
+    robot_arm_get_feedback(&feedback);
+    robot_arm_priority_stats_t priority;
+    robot_arm_get_priority_stats(&priority);
+
+    double elapsed_s = elapsed_us / 1e6;
+    uint32_t ok = atomic_load(&completed_ok);
+    uint32_t failed = atomic_load(&completed_failed);
+    uint32_t timeouts = atomic_load(&completed_timeout);
+    uint32_t coalesced = robot_arm_get_coalesced_count() - coalesced_before;
+    uint32_t dropped = robot_arm_get_dropped_count() - dropped_before;
+    uint32_t wire_requests = stats.total_sent - stats_before.total_sent;
+    double cpu_per_cmd_us = wire_requests ? cpu_used * 1e6 / wire_requests : 0.0;
+
+    robot_arm_cmd_type_t type = (options.mode == BENCH_ORDERED) ? ROBOT_ARM_CMD_FEEDBACK
+                              : (options.mode == BENCH_JOINT) ? ROBOT_ARM_CMD_MOVE_JOINT : ROBOT_ARM_CMD_MOVE_JOINTS;
+    uint32_t p50 = robot_arm_latency_percentile(&e2e_hist, 50.0f);
+    uint32_t p90 = robot_arm_latency_percentile(&e2e_hist, 90.0f);
+    uint32_t p99 = robot_arm_latency_percentile(&e2e_hist, 99.0f);
+    uint32_t max = robot_arm_latency_max(&e2e_hist);
+
+    uint32_t fallbacks = robot_arm_get_transport_fallbacks();
+    uint32_t replies = feedback.sequence - feedback_before.sequence;
+    printf("mode %s over %s, %.2f s\n", mode_names[options.mode], transport_names[options.transport], elapsed_s);
+    printf("  submitted       %u (%.1f/s)\n", submitted, submitted / elapsed_s);
+    printf("  completed ok    %u (%.1f cmd/s)\n", ok, ok / elapsed_s);
+    printf("  failed          %u (%u timeouts)\n", failed + timeouts, timeouts);
+    printf("  coalesced       %u, dropped %u\n", coalesced, dropped);
+    printf("  on the wire     %u requests (%.1f/s, feedback polls included)\n", wire_requests, wire_requests / elapsed_s);
+    printf("  end to end us   p50 %u  p90 %u  p99 %u  max %u\n", p50, p90, p99, max);
+    printf("  queue us        p50 %u  p99 %u\n",
+           robot_arm_stats_percentile_us(type, ROBOT_ARM_STATS_QUEUE, 50.0f),
+           robot_arm_stats_percentile_us(type, ROBOT_ARM_STATS_QUEUE, 99.0f));
+    printf("  wire us         p50 %u  p99 %u\n",
+           robot_arm_stats_percentile_us(type, ROBOT_ARM_STATS_WIRE, 50.0f),
+           robot_arm_stats_percentile_us(type, ROBOT_ARM_STATS_WIRE, 99.0f));
+    printf("  cpu             %.3f s user + %.3f s sys, %.1f us per wire request\n", cpu_user, cpu_sys, cpu_per_cmd_us);
+    printf("  session         %u reconnects, %u failures, %u superseded in flight\n",
+           session.reconnects - session_before.reconnects, session.failures - session_before.failures,
+           session.cancelled - session_before.cancelled);
+    printf("  feedback        %u replies parsed\n", replies);
+    printf("  pacing          %.1f Hz (srtt %u us, min rtt %u us, %u congestion events)\n",
+           rate.rate_hz, rate.srtt_us, rate.min_rtt_us, rate.congestion_events);
+    if (options.mode == BENCH_JOINT) {
+        printf("  cmd cache       %u hits, %u misses\n", cache_hits, cache_misses);
+    }
+    uint32_t stops = priority.sent - priority_before.sent;
+    uint32_t deadline_misses = priority.deadline_misses - priority_before.deadline_misses;
+    if (options.mode == BENCH_STOP) {
+        printf("  priority lane   %u sent, max dispatch %u us (deadline %d us), %u late, %u moves flushed\n",
+               stops, priority.max_dispatch_us, CONFIG_ROBOT_ARM_PRIORITY_DEADLINE_MS * 1000, deadline_misses,
+               priority.flushed - priority_before.flushed);
+    }
+
+    if (fallbacks) {
+        printf("  transport       fell back to HTTP %u times\n", fallbacks);
+    }
+
+    printf("RESULT mode=%s transport=%s fallbacks=%u replies=%u stops=%u stop_max_us=%u seconds=%.2f submitted=%u ok=%u failed=%u timeouts=%u coalesced=%u dropped=%u "
+           "cmd_per_s=%.1f wire_per_s=%.1f p50_us=%u p90_us=%u p99_us=%u max_us=%u cpu_us_per_cmd=%.1f\n",
+           mode_names[options.mode], transport_names[options.transport], fallbacks, replies, stops, priority.max_dispatch_us, elapsed_s, submitted, ok, failed, timeouts, coalesced, dropped,
+           ok / elapsed_s, wire_requests / elapsed_s, p50, p90, p99, max, cpu_per_cmd_us);
+    // Hand the link back to HTTP, as the settings screen does, so the transport's close runs too
+    bool closed = true;
+    if (options.transport != ROBOT_ARM_TRANSPORT_HTTP) {
+        robot_arm_set_transport(ROBOT_ARM_TRANSPORT_HTTP);
+        submit(&warm);
+        closed = wait_outstanding(uncalled(coalesced_before, &priority_before), esp_timer_get_time() + 10 * 1000000) &&
+                 robot_arm_get_transport() == ROBOT_ARM_TRANSPORT_HTTP;
+        if (!closed) {
+            printf("  transport       switching back to HTTP did not complete\n");
+        }
+    }
+
+    bool replied = (options.mode != BENCH_ORDERED || replies > 0);
+    bool stopped = (options.mode != BENCH_STOP ||
+                    (stops > 0 && priority.max_dispatch_us <= CONFIG_ROBOT_ARM_PRIORITY_DEADLINE_MS * 1000));
+    bool in_order = (options.mode != BENCH_TIMED || coalesced == 0);
+    return (ok > 0 && fallbacks == 0 && replied && closed && stopped && in_order) ? 0 : 1;
+}
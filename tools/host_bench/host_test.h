@@ -0,0 +1,50 @@
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Checks for the host unit tests. A failed check prints where and what and the test carries on;
+// host_test_finish() turns the failure count into the exit status.
+static int host_test_checks;
+static int host_test_failures;
+
+#define CHECK(cond)                                                                         \
+    do {                                                                                    \
+        host_test_checks++;                                                                 \
+        if (!(cond)) {                                                                      \
+            host_test_failures++;                                                           \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);        \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                             \
+    do {                                                                                    \
+        double host_test_a = (actual), host_test_e = (expected);                            \
+        host_test_checks++;                                                                 \
+        if (!(fabs(host_test_a - host_test_e) <= (tolerance))) {                            \
+            host_test_failures++;                                                           \
+            fprintf(stderr, "%s:%d: %s = %g, expected %g +- %g\n", __FILE__, __LINE__,       \
+                    #actual, host_test_a, host_test_e, (double)(tolerance));                \
+        }                                                                                   \
+    } while (0)
+
+#define CHECK_STR(actual, expected)                                                         \
+    do {                                                                                    \
+        const char *host_test_a = (actual), *host_test_e = (expected);                      \
+        host_test_checks++;                                                                 \
+        if (!host_test_a || strcmp(host_test_a, host_test_e) != 0) {                        \
+            host_test_failures++;                                                           \
+            fprintf(stderr, "%s:%d: %s = \"%s\", expected \"%s\"\n", __FILE__, __LINE__,     \
+                    #actual, host_test_a ? host_test_a : "(null)", host_test_e);            \
+        }                                                                                   \
+    } while (0)
+
+static inline int host_test_finish(const char *name)
+{
+    printf("%s: %d checks, %d failed\n", name, host_test_checks, host_test_failures);
+    return host_test_failures ? 1 : 0;
+}
+
+#endif // HOST_TEST_H
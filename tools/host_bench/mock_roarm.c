@@ -0,0 +1,622 @@
+// Mock RoArm-M2 server: answers GET /js?json=<url-encoded command> like the arm's web server,
+// and streams JSON text frames on a WebSocket upgraded at the -w path, with injectable latency,
+// jitter and loss. One thread per connection, keep-alive. With -u it also plays the robot's serial
+// port: a pty whose other end is linked at the given path, carrying newline-delimited JSON.
+//
+//   mock_roarm [-a address] [-p port] [-w ws_path] [-u serial_link] [-l latency_ms] [-j jitter_ms] [-d drop_rate] [-c close_rate] [-v]
+//
+// Each request or frame is handled after latency + uniform(0, jitter) ms. A dropped one is read
+// and never answered (the client runs into its timeout); a closed one resets the connection
+// without a reply (the client sees the error at once). T:105 gets a T:1051 feedback reply that
+// reflects the last commanded joints; over HTTP every other command is echoed, over WebSocket
+// and serial it is not answered. SIGINT/SIGTERM print per-command counters and exit.
+#define _GNU_SOURCE  // strcasestr
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define REQUEST_BUFFER_SIZE 4096
+#define COUNTED_TYPES       6
+
+typedef struct {
+    const char *address;
+    int port;
+    const char *ws_path;
+    const char *serial_link;
+    int latency_ms;
+    int jitter_ms;
+    double drop_rate;
+    double close_rate;
+    bool verbose;
+} mock_config_t;
+
+static mock_config_t config = { .address = "127.0.0.1", .port = 8080, .ws_path = "/ws" };
+
+// Command codes tallied in the summary; anything else is counted as "other"
+static const int counted_codes[COUNTED_TYPES] = { 100, 101, 102, 105, 114, 210 };
+static atomic_uint counted[COUNTED_TYPES + 1];
+static atomic_uint requests_total, requests_dropped, requests_closed, connections_total, websockets_total, serial_lines;
+
+// Last commanded joints (b, s, e, t), echoed back in feedback
+static float joints[4] = { 0.0f, 0.0f, 1.5708f, 3.1416f };
+static pthread_mutex_t joints_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static double uniform(unsigned int *seed)
+{
+    return (double)rand_r(seed) / ((double)RAND_MAX + 1.0);
+}
+
+static void sleep_ms(double ms)
+{
+    if (ms <= 0) {
+        return;
+    }
+    struct timespec ts = { .tv_sec = (time_t)(ms / 1000), .tv_nsec = (long)((ms - (time_t)(ms / 1000) * 1000) * 1e6) };
+    nanosleep(&ts, NULL);
+}
+
+// Decode %XX escapes in place
+static void url_decode(char *s)
+{
+    char *out = s;
+    for (; *s; s++) {
+        if (s[0] == '%' && s[1] && s[2]) {
+            char hex[3] = { s[1], s[2], 0 };
+            *out++ = (char)strtol(hex, NULL, 16);
+            s += 2;
+        } else if (*s == '+') {
+            *out++ = ' ';
+        } else {
+            *out++ = *s;
+        }
+    }
+    *out = '\0';
+}
+
+// Value of a numeric key in flat JSON, or false if absent
+static bool json_number(const char *json, const char *key, double *value)
+{
+    char pattern[16];
+    snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *p = strstr(json, pattern);
+    if (!p) {
+        return false;
+    }
+    *value = strtod(p + strlen(pattern), NULL);
+    return true;
+}
+
+static void count_command(int code)
+{
+    for (int i = 0; i < COUNTED_TYPES; i++) {
+        if (counted_codes[i] == code) {
+            atomic_fetch_add(&counted[i], 1);
+            return;
+        }
+    }
+    atomic_fetch_add(&counted[COUNTED_TYPES], 1);
+}
+
+// Apply a move to the joint model and build the reply body
+static int handle_command(const char *json, char *body, size_t size)
+{
+    double code = 0;
+    json_number(json, "T", &code);
+    count_command((int)code);
+
+    pthread_mutex_lock(&joints_lock);
+    if ((int)code == 101) {
+        double joint = 0, rad = 0;
+        if (json_number(json, "joint", &joint) && json_number(json, "rad", &rad) && joint >= 1 && joint <= 4) {
+            joints[(int)joint - 1] = (float)rad;
+        }
+    } else if ((int)code == 102) {
+        static const char *keys[4] = { "base", "shoulder", "elbow", "hand" };
+        for (int i = 0; i < 4; i++) {
+            double rad;
+            if (json_number(json, keys[i], &rad)) {
+                joints[i] = (float)rad;
+            }
+        }
+    }
+    float b = joints[0], s = joints[1], e = joints[2], t = joints[3];
+    pthread_mutex_unlock(&joints_lock);
+
+    if ((int)code == 105) {
+        return snprintf(body, size,
+                        "{\"T\":1051,\"x\":310.1,\"y\":0,\"z\":362.9,\"b\":%.4f,\"s\":%.4f,\"e\":%.4f,\"t\":%.4f,"
+                        "\"torB\":0,\"torS\":-12,\"torE\":8,\"torH\":0}",
+                        b, s, e, t);
+    }
+    return snprintf(body, size, "%s", json);
+}
+
+// SHA-1 of a short message (RFC 3174), for the WebSocket accept key
+static void sha1(const uint8_t *data, size_t len, uint8_t digest[20])
+{
+    uint32_t h[5] = { 0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0 };
+    uint8_t block[64];
+    uint64_t bits = (uint64_t)len * 8;
+    size_t total = ((len + 8) / 64 + 1) * 64;
+
+    for (size_t offset = 0; offset < total; offset += 64) {
+        for (size_t i = 0; i < 64; i++) {
+            size_t pos = offset + i;
+            block[i] = (pos < len) ? data[pos] : (pos == len) ? 0x80 : 0;
+            if (pos >= total - 8) {
+                block[i] = (uint8_t)(bits >> (8 * (total - 1 - pos)));
+            }
+        }
+        uint32_t w[80];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 |
+                   (uint32_t)block[4 * i + 2] << 8 | block[4 * i + 3];
+        }
+        for (int i = 16; i < 80; i++) {
+            uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = (x << 1) | (x >> 31);
+        }
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) { f = (b & c) | (~b & d); k = 0x5A827999; }
+            else if (i < 40) { f = b ^ c ^ d; k = 0x6ED9EBA1; }
+            else if (i < 60) { f = (b & c) | (b & d) | (c & d); k = 0x8F1BBCDC; }
+            else { f = b ^ c ^ d; k = 0xCA62C1D6; }
+            uint32_t temp = ((a << 5) | (a >> 27)) + f + e + k + w[i];
+            e = d; d = c; c = (b << 30) | (b >> 2); b = a; a = temp;
+        }
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+    }
+    for (int i = 0; i < 20; i++) {
+        digest[i] = (uint8_t)(h[i / 4] >> (24 - 8 * (i % 4)));
+    }
+}
+
+static void base64(const uint8_t *data, size_t len, char *out)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16 | (i + 1 < len ? (uint32_t)data[i + 1] << 8 : 0) | (i + 2 < len ? data[i + 2] : 0);
+        *out++ = alphabet[(v >> 18) & 63];
+        *out++ = alphabet[(v >> 12) & 63];
+        *out++ = (i + 1 < len) ? alphabet[(v >> 6) & 63] : '=';
+        *out++ = (i + 2 < len) ? alphabet[v & 63] : '=';
+    }
+    *out = '\0';
+}
+
+// Value of a request header, copied up to the end of its line
+static bool header_value(const char *headers, const char *name, char *value, size_t size)
+{
+    char pattern[64];
+    snprintf(pattern, sizeof(pattern), "\r\n%s:", name);
+    const char *p = strcasestr(headers, pattern);
+    if (!p) {
+        return false;
+    }
+    p += strlen(pattern);
+    while (*p == ' ') {
+        p++;
+    }
+    size_t n = strcspn(p, "\r\n");
+    if (n >= size) {
+        return false;
+    }
+    memcpy(value, p, n);
+    value[n] = '\0';
+    return true;
+}
+
+static bool recv_exact(int fd, void *buffer, size_t len)
+{
+    char *p = buffer;
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+// Server frames are never masked
+static bool ws_send_frame(int fd, int opcode, const char *payload, int len)
+{
+    uint8_t frame[4 + REQUEST_BUFFER_SIZE];
+    int header = 2;
+    if (len > REQUEST_BUFFER_SIZE) {
+        return false;
+    }
+    frame[0] = 0x80 | (uint8_t)opcode;
+    if (len < 126) {
+        frame[1] = (uint8_t)len;
+    } else {
+        frame[1] = 126;
+        frame[2] = (uint8_t)(len >> 8);
+        frame[3] = (uint8_t)len;
+        header = 4;
+    }
+    memcpy(frame + header, payload, (size_t)len);
+    return send(fd, frame, (size_t)(header + len), MSG_NOSIGNAL) == header + len;
+}
+
+// Serve an upgraded connection: one command per text frame, only T:105 is answered
+static void ws_session(int fd, unsigned int *seed)
+{
+    atomic_fetch_add(&websockets_total, 1);
+    char payload[REQUEST_BUFFER_SIZE];
+
+    while (!stop_requested) {
+        uint8_t header[8];
+        if (!recv_exact(fd, header, 2)) {
+            return;
+        }
+        int opcode = header[0] & 0x0f;
+        size_t len = header[1] & 0x7f;
+        if (len == 126) {
+            if (!recv_exact(fd, header, 2)) {
+                return;
+            }
+            len = (size_t)header[0] << 8 | header[1];
+        }
+        uint8_t mask[4] = { 0 };
+        if (len >= sizeof(payload) || ((header[1] & 0x80) && !recv_exact(fd, mask, 4)) || !recv_exact(fd, payload, len)) {
+            return;
+        }
+        for (size_t i = 0; i < len; i++) {
+            payload[i] ^= (char)mask[i % 4];
+        }
+        payload[len] = '\0';
+
+        if (opcode == 0x8) {
+            ws_send_frame(fd, 0x8, payload, (int)len);
+            return;
+        }
+        if (opcode == 0x9) {
+            ws_send_frame(fd, 0xA, payload, (int)len);
+            continue;
+        }
+        if (opcode != 0x1) {
+            continue;
+        }
+
+        atomic_fetch_add(&requests_total, 1);
+        double roll = uniform(seed);
+        if (roll < config.close_rate) {
+            atomic_fetch_add(&requests_closed, 1);
+            struct linger hard = { .l_onoff = 1, .l_linger = 0 };
+            setsockopt(fd, SOL_SOCKET, SO_LINGER, &hard, sizeof(hard));
+            return;
+        }
+        if (roll < config.close_rate + config.drop_rate) {
+            atomic_fetch_add(&requests_dropped, 1);
+            continue;
+        }
+
+        sleep_ms(config.latency_ms + uniform(seed) * config.jitter_ms);
+        char body[512];
+        int body_len = handle_command(payload, body, sizeof(body));
+        double code = 0;
+        json_number(payload, "T", &code);
+        if (config.verbose) {
+            fprintf(stderr, "WS %s\n", payload);
+        }
+        if ((int)code == 105 && !ws_send_frame(fd, 0x1, body, body_len)) {
+            return;
+        }
+    }
+}
+
+// Answer an upgrade request: 101 with the accept key of RFC 6455
+static bool ws_upgrade(int fd, const char *headers)
+{
+    static const char guid[] = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    char key[64 + sizeof(guid)], accept[32];
+    if (!header_value(headers, "Sec-WebSocket-Key", key, 64)) {
+        return false;
+    }
+    strcat(key, guid);
+    uint8_t digest[20];
+    sha1((const uint8_t *)key, strlen(key), digest);
+    base64(digest, sizeof(digest), accept);
+
+    char reply[256];
+    int len = snprintf(reply, sizeof(reply),
+                       "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                       "Sec-WebSocket-Accept: %s\r\n\r\n", accept);
+    return send(fd, reply, (size_t)len, MSG_NOSIGNAL) == len;
+}
+
+// Create the pty the firmware's UART driver opens and link its device node at config.serial_link.
+// The robot's end stays open for the whole run, so clients can come and go.
+static int serial_open(void)
+{
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        perror("mock_roarm: pty");
+        return -1;
+    }
+    const char *device = ptsname(master);
+    int device_fd = device ? open(device, O_RDWR | O_NOCTTY) : -1;
+    struct termios tio;
+    if (device_fd < 0 || tcgetattr(device_fd, &tio) != 0) {
+        perror("mock_roarm: pty device");
+        return -1;
+    }
+    // Raw before any client opens it, so nothing is echoed or translated
+    cfmakeraw(&tio);
+    tcsetattr(device_fd, TCSANOW, &tio);
+
+    unlink(config.serial_link);
+    if (symlink(device, config.serial_link) != 0) {
+        perror("mock_roarm: serial link");
+        return -1;
+    }
+    return master;
+}
+
+// One command per line, only T:105 is answered
+static void *serial_thread(void *param)
+{
+    int fd = (int)(intptr_t)param;
+    unsigned int seed = (unsigned int)time(NULL) ^ (unsigned int)fd;
+    char line[REQUEST_BUFFER_SIZE];
+    size_t used = 0;
+
+    while (!stop_requested) {
+        char chunk[256];
+        ssize_t n = read(fd, chunk, sizeof(chunk));
+        if (n <= 0) {
+            if (n < 0 && errno != EINTR && errno != EIO) {
+                perror("mock_roarm: serial read");
+                break;
+            }
+            continue;
+        }
+        for (ssize_t i = 0; i < n; i++) {
+            if (chunk[i] != '\n') {
+                if (used < sizeof(line) - 1) {
+                    line[used++] = chunk[i];
+                }
+                continue;
+            }
+            line[used] = '\0';
+            used = 0;
+            atomic_fetch_add(&serial_lines, 1);
+            atomic_fetch_add(&requests_total, 1);
+            if (uniform(&seed) < config.drop_rate) {
+                atomic_fetch_add(&requests_dropped, 1);
+                continue;
+            }
+
+            char body[512];
+            int body_len = handle_command(line, body, sizeof(body));
+            double code = 0;
+            json_number(line, "T", &code);
+            if (config.verbose) {
+                fprintf(stderr, "SERIAL %s\n", line);
+            }
+            if ((int)code == 105) {
+                sleep_ms(config.latency_ms + uniform(&seed) * config.jitter_ms);
+                body[body_len++] = '\n';
+                if (write(fd, body, (size_t)body_len) != body_len) {
+                    perror("mock_roarm: serial write");
+                }
+            }
+        }
+    }
+    return NULL;
+}
+
+static void *connection_thread(void *param)
+{
+    int fd = (int)(intptr_t)param;
+    unsigned int seed = (unsigned int)time(NULL) ^ (unsigned int)fd ^ (unsigned int)(uintptr_t)pthread_self();
+    char buffer[REQUEST_BUFFER_SIZE] = "";
+    int used = 0;
+
+    while (!stop_requested) {
+        char *end = NULL;
+        while (!(end = strstr(buffer, "\r\n\r\n"))) {
+            if (used >= (int)sizeof(buffer) - 1) {
+                goto done;
+            }
+            ssize_t n = recv(fd, buffer + used, sizeof(buffer) - 1 - used, 0);
+            if (n <= 0) {
+                goto done;
+            }
+            used += (int)n;
+            buffer[used] = '\0';
+        }
+        int request_len = (int)(end - buffer) + 4;
+        atomic_fetch_add(&requests_total, 1);
+
+        char path[REQUEST_BUFFER_SIZE];
+        if (sscanf(buffer, "GET %4095s", path) != 1) {
+            path[0] = '\0';
+        }
+        char upgrade[32];
+        if (strcmp(path, config.ws_path) == 0 && header_value(buffer, "Upgrade", upgrade, sizeof(upgrade)) &&
+            strcasecmp(upgrade, "websocket") == 0) {
+            // The client waits for the 101 before its first frame, so nothing follows the headers
+            if (ws_upgrade(fd, buffer)) {
+                ws_session(fd, &seed);
+            }
+            goto done;
+        }
+        memmove(buffer, buffer + request_len, used - request_len);
+        used -= request_len;
+        buffer[used] = '\0';
+
+        double roll = uniform(&seed);
+        if (roll < config.close_rate) {
+            atomic_fetch_add(&requests_closed, 1);
+            struct linger hard = { .l_onoff = 1, .l_linger = 0 };
+            setsockopt(fd, SOL_SOCKET, SO_LINGER, &hard, sizeof(hard));
+            goto done;
+        }
+        if (roll < config.close_rate + config.drop_rate) {
+            atomic_fetch_add(&requests_dropped, 1);
+            continue;
+        }
+
+        sleep_ms(config.latency_ms + uniform(&seed) * config.jitter_ms);
+
+        char body[512];
+        int body_len;
+        int status = 200;
+        const char *query = strstr(path, "/js?json=");
+        if (query) {
+            url_decode(path);
+            body_len = handle_command(path + strlen("/js?json="), body, sizeof(body));
+        } else {
+            status = 404;
+            body_len = snprintf(body, sizeof(body), "not found");
+        }
+        if (config.verbose) {
+            fprintf(stderr, "%d %s\n", status, path);
+        }
+
+        char reply[768];
+        int reply_len = snprintf(reply, sizeof(reply),
+                                 "HTTP/1.1 %d %s\r\nContent-Type: text/plain\r\nContent-Length: %d\r\n\r\n%s",
+                                 status, status == 200 ? "OK" : "Not Found", body_len, body);
+        if (send(fd, reply, reply_len, MSG_NOSIGNAL) != reply_len) {
+            break;
+        }
+    }
+
+done:
+    close(fd);
+    return NULL;
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    stop_requested = 1;
+}
+
+static void print_summary(void)
+{
+    printf("mock_roarm: %u connections (%u WebSocket), %u serial lines, %u requests, %u dropped, %u closed\n",
+           atomic_load(&connections_total), atomic_load(&websockets_total), atomic_load(&serial_lines),
+           atomic_load(&requests_total), atomic_load(&requests_dropped), atomic_load(&requests_closed));
+    for (int i = 0; i < COUNTED_TYPES; i++) {
+        printf("  T:%-4d %u\n", counted_codes[i], atomic_load(&counted[i]));
+    }
+    printf("  other  %u\n", atomic_load(&counted[COUNTED_TYPES]));
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [-a address] [-p port] [-w ws_path] [-u serial_link] [-l latency_ms] [-j jitter_ms] [-d drop_rate] [-c close_rate] [-v]\n"
+            "  -a  loopback address to listen on, e.g. 127.0.0.2 for a second robot (default 127.0.0.1)\n"
+            "  -p  TCP port (default 8080)\n"
+            "  -w  path WebSocket upgrades are accepted on (default /ws)\n"
+            "  -u  also serve a serial port: symlink to create for the pty device (default none)\n"
+            "  -l  fixed reply latency in ms (default 0)\n"
+            "  -j  extra uniform random latency, 0..jitter ms (default 0)\n"
+            "  -d  fraction of requests never answered, 0..1 (default 0)\n"
+            "  -c  fraction of requests answered with a connection reset, 0..1 (default 0)\n"
+            "  -v  log every request to stderr\n",
+            argv0);
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    while ((opt = getopt(argc, argv, "a:p:w:u:l:j:d:c:vh")) != -1) {
+        switch (opt) {
+            case 'a': config.address = optarg; break;
+            case 'p': config.port = atoi(optarg); break;
+            case 'w': config.ws_path = optarg; break;
+            case 'u': config.serial_link = optarg; break;
+            case 'l': config.latency_ms = atoi(optarg); break;
+            case 'j': config.jitter_ms = atoi(optarg); break;
+            case 'd': config.drop_rate = atof(optarg); break;
+            case 'c': config.close_rate = atof(optarg); break;
+            case 'v': config.verbose = true; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 2;
+        }
+    }
+
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons((uint16_t)config.port) };
+    if (inet_pton(AF_INET, config.address, &addr.sin_addr) != 1) {
+        fprintf(stderr, "mock_roarm: bad address %s\n", config.address);
+        return 2;
+    }
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 16) != 0) {
+        perror("mock_roarm: bind/listen");
+        return 1;
+    }
+
+    if (config.serial_link) {
+        int serial_fd = serial_open();
+        pthread_t thread;
+        if (serial_fd < 0 || pthread_create(&thread, NULL, serial_thread, (void *)(intptr_t)serial_fd) != 0) {
+            return 1;
+        }
+        pthread_detach(thread);
+        fprintf(stderr, "mock_roarm: serial port at %s\n", config.serial_link);
+    }
+
+    // No SA_RESTART, so accept() returns on a signal and the summary gets printed
+    struct sigaction sa = { .sa_handler = on_signal };
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    fprintf(stderr, "mock_roarm: listening on %s:%d (latency %d ms, jitter %d ms, drop %.3f, close %.3f)\n",
+            config.address, config.port, config.latency_ms, config.jitter_ms, config.drop_rate, config.close_rate);
+
+    while (!stop_requested) {
+        int fd = accept(listener, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("mock_roarm: accept");
+            break;
+        }
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        atomic_fetch_add(&connections_total, 1);
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, connection_thread, (void *)(intptr_t)fd) != 0) {
+            close(fd);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+
+    close(listener);
+    if (config.serial_link) {
+        unlink(config.serial_link);
+    }
+    print_summary();
+    return 0;
+}
@@ -0,0 +1,6 @@
+#ifndef HOST_SHIM_ESP_EVENT_H
+#define HOST_SHIM_ESP_EVENT_H
+
+#include "esp_err.h"
+
+#endif // HOST_SHIM_ESP_EVENT_H
@@ -0,0 +1,13 @@
+#ifndef HOST_SHIM_ESP_HEAP_CAPS_H
+#define HOST_SHIM_ESP_HEAP_CAPS_H
+
+#include <stdlib.h>
+
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_8BIT     (1 << 2)
+
+#define heap_caps_malloc(size, caps) malloc(size)
+#define heap_caps_free(ptr)          free(ptr)
+
+#endif // HOST_SHIM_ESP_HEAP_CAPS_H
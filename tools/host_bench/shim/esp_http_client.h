@@ -0,0 +1,57 @@
+#ifndef HOST_SHIM_ESP_HTTP_CLIENT_H
+#define HOST_SHIM_ESP_HTTP_CLIENT_H
+
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Blocking HTTP/1.1 keep-alive client over POSIX sockets with the esp_http_client calls the
+// HTTP transport makes. Every host resolves to 127.0.0.1:host_shim_http_port.
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_EVENT_ERROR,
+    HTTP_EVENT_ON_CONNECTED,
+    HTTP_EVENT_HEADER_SENT,
+    HTTP_EVENT_ON_HEADER,
+    HTTP_EVENT_ON_HEADERS_COMPLETE,
+    HTTP_EVENT_ON_DATA,
+    HTTP_EVENT_ON_FINISH,
+    HTTP_EVENT_DISCONNECTED,
+    HTTP_EVENT_REDIRECT,
+} esp_http_client_event_id_t;
+
+typedef struct {
+    esp_http_client_event_id_t event_id;
+    esp_http_client_handle_t client;
+    void *data;
+    int data_len;
+    void *user_data;
+    char *header_key;
+    char *header_value;
+} esp_http_client_event_t;
+
+typedef esp_err_t (*http_event_handle_cb)(esp_http_client_event_t *evt);
+
+typedef struct {
+    const char *url;
+    http_event_handle_cb event_handler;
+    void *user_data;
+    int timeout_ms;
+    int buffer_size;
+    bool keep_alive_enable;
+} esp_http_client_config_t;
+
+#define ESP_ERR_HTTP_BASE       0x7000
+#define ESP_ERR_HTTP_CONNECT    (ESP_ERR_HTTP_BASE + 3)
+#define ESP_ERR_HTTP_EAGAIN     (ESP_ERR_HTTP_BASE + 7)
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config);
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url);
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int timeout_ms);
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client);
+int esp_http_client_get_status_code(esp_http_client_handle_t client);
+int esp_http_client_get_errno(esp_http_client_handle_t client);
+esp_err_t esp_http_client_close(esp_http_client_handle_t client);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client);
+
+#endif // HOST_SHIM_ESP_HTTP_CLIENT_H
@@ -0,0 +1,26 @@
+#ifndef HOST_SHIM_ESP_TIMER_H
+#define HOST_SHIM_ESP_TIMER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+// Microseconds of CLOCK_MONOTONIC since the process started
+int64_t esp_timer_get_time(void);
+
+// Periodic timers only, each on a thread of its own (the firmware runs them all on one task)
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+
+typedef struct esp_timer *esp_timer_handle_t;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle);
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);   // Returns once the callback is not running
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+#endif // HOST_SHIM_ESP_TIMER_H
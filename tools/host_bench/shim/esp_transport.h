@@ -0,0 +1,17 @@
+#ifndef HOST_SHIM_ESP_TRANSPORT_H
+#define HOST_SHIM_ESP_TRANSPORT_H
+
+#include "esp_err.h"
+
+// The esp_transport calls the WebSocket transport makes, over POSIX sockets. Every host
+// resolves to 127.0.0.1:host_shim_http_port, where mock_roarm serves HTTP and WebSocket alike.
+typedef struct esp_transport_item *esp_transport_handle_t;
+
+int esp_transport_connect(esp_transport_handle_t t, const char *host, int port, int timeout_ms);
+int esp_transport_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms);
+int esp_transport_poll_read(esp_transport_handle_t t, int timeout_ms);
+int esp_transport_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms);
+int esp_transport_close(esp_transport_handle_t t);
+esp_err_t esp_transport_destroy(esp_transport_handle_t t);
+
+#endif // HOST_SHIM_ESP_TRANSPORT_H
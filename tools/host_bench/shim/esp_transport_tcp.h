@@ -0,0 +1,8 @@
+#ifndef HOST_SHIM_ESP_TRANSPORT_TCP_H
+#define HOST_SHIM_ESP_TRANSPORT_TCP_H
+
+#include "esp_transport.h"
+
+esp_transport_handle_t esp_transport_tcp_init(void);
+
+#endif // HOST_SHIM_ESP_TRANSPORT_TCP_H
@@ -0,0 +1,26 @@
+#ifndef HOST_SHIM_ESP_TRANSPORT_WS_H
+#define HOST_SHIM_ESP_TRANSPORT_WS_H
+
+#include "esp_transport.h"
+
+// RFC 6455 client on top of a TCP transport: masked frames out, unmasked frames in. Pings are
+// answered inside esp_transport_read() like the real transport does.
+typedef enum ws_transport_opcodes {
+    WS_TRANSPORT_OPCODES_CONT = 0x00,
+    WS_TRANSPORT_OPCODES_TEXT = 0x01,
+    WS_TRANSPORT_OPCODES_BINARY = 0x02,
+    WS_TRANSPORT_OPCODES_CLOSE = 0x08,
+    WS_TRANSPORT_OPCODES_PING = 0x09,
+    WS_TRANSPORT_OPCODES_PONG = 0x0a,
+    WS_TRANSPORT_OPCODES_FIN = 0x80,
+    WS_TRANSPORT_OPCODES_NONE = 0x100,
+} ws_transport_opcodes_t;
+
+esp_transport_handle_t esp_transport_ws_init(esp_transport_handle_t parent_handle);
+esp_err_t esp_transport_ws_set_path(esp_transport_handle_t t, const char *path);
+int esp_transport_ws_send_raw(esp_transport_handle_t t, ws_transport_opcodes_t opcode, const char *b, int len,
+                              int timeout_ms);
+ws_transport_opcodes_t esp_transport_ws_get_read_opcode(esp_transport_handle_t t);
+int esp_transport_ws_get_read_payload_len(esp_transport_handle_t t);
+
+#endif // HOST_SHIM_ESP_TRANSPORT_WS_H
@@ -0,0 +1,6 @@
+#ifndef HOST_SHIM_ESP_WIFI_H
+#define HOST_SHIM_ESP_WIFI_H
+
+// wifi_manager.h includes this; the host link is always up
+
+#endif // HOST_SHIM_ESP_WIFI_H
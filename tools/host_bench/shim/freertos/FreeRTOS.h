@@ -0,0 +1,36 @@
+#ifndef HOST_SHIM_FREERTOS_H
+#define HOST_SHIM_FREERTOS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+// Just enough FreeRTOS for the comm stack, on POSIX threads. One tick is one millisecond.
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define portMAX_DELAY       ((TickType_t)0xffffffffu)
+#define portTICK_PERIOD_MS  1
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define pdTRUE              1
+#define pdFALSE             0
+#define pdPASS              1
+#define pdFAIL              0
+#define tskNO_AFFINITY      0x7fffffff
+
+// Critical sections are spinlocks, as on the dual-core ESP32-S3
+typedef struct {
+    atomic_int locked;
+} portMUX_TYPE;
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+#define portMUX_INITIALIZE(mux)      atomic_init(&(mux)->locked, 0)
+
+void host_shim_mux_enter(portMUX_TYPE *mux);
+void host_shim_mux_exit(portMUX_TYPE *mux);
+#define portENTER_CRITICAL(mux) host_shim_mux_enter(mux)
+#define portEXIT_CRITICAL(mux)  host_shim_mux_exit(mux)
+
+#endif // HOST_SHIM_FREERTOS_H
@@ -0,0 +1,958 @@
+#define _GNU_SOURCE  // strcasestr
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <time.h>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <termios.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_http_client.h"
+#include "esp_transport.h"
+#include "esp_transport_tcp.h"
+#include "esp_transport_ws.h"
+#include "driver/uart.h"
+#include "host_shim.h"
+#include "robot_arm_transport.h"
+#include "wifi_manager.h"
+#include "wifi_supervisor.h"
+
+static const char *SHIM_TAG = "HOST_SHIM";
+
+int host_shim_http_port = 80;
+const char *host_shim_uart_path = NULL;
+
+// ---------------------------------------------------------------------------------------------
+// Time
+
+static int64_t monotonic_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static int64_t boot_us;
+
+__attribute__((constructor)) static void host_shim_boot(void)
+{
+    boot_us = monotonic_us();
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return monotonic_us() - boot_us;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / 1000);
+}
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+    pthread_t thread;
+    uint64_t period_us;
+    atomic_bool running;
+};
+
+static void *timer_entry(void *param)
+{
+    struct esp_timer *timer = param;
+    struct timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    while (1) {
+        // Absolute deadlines, so the period does not drift by the callback's run time
+        next.tv_nsec += (long)(timer->period_us % 1000000) * 1000;
+        next.tv_sec += (time_t)(timer->period_us / 1000000) + next.tv_nsec / 1000000000;
+        next.tv_nsec %= 1000000000;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+        if (!atomic_load(&timer->running)) {
+            return NULL;
+        }
+        timer->args.callback(timer->args.arg);
+    }
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args, esp_timer_handle_t *handle)
+{
+    if (!args || !args->callback || !handle) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    struct esp_timer *timer = calloc(1, sizeof(*timer));
+    if (!timer) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *args;
+    atomic_init(&timer->running, false);
+    *handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period_us)
+{
+    if (!timer || period_us == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (atomic_load(&timer->running)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    timer->period_us = period_us;
+    atomic_store(&timer->running, true);
+    if (pthread_create(&timer->thread, NULL, timer_entry, timer) != 0) {
+        ESP_LOGE(SHIM_TAG, "Could not start timer %s", timer->args.name ? timer->args.name : "?");
+        atomic_store(&timer->running, false);
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    if (!timer || !atomic_exchange(&timer->running, false)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    pthread_join(timer->thread, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    if (!timer) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (atomic_load(&timer->running)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    free(timer);
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Critical sections
+
+void host_shim_mux_enter(portMUX_TYPE *mux)
+{
+    int expected = 0;
+    while (!atomic_compare_exchange_weak(&mux->locked, &expected, 1)) {
+        expected = 0;
+        sched_yield();
+    }
+}
+
+void host_shim_mux_exit(portMUX_TYPE *mux)
+{
+    atomic_store(&mux->locked, 0);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Tasks and notifications
+
+struct host_shim_task {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t notify_count;
+    TaskFunction_t fn;
+    void *arg;
+};
+
+static _Thread_local struct host_shim_task *current_task;
+
+static void *task_entry(void *param)
+{
+    struct host_shim_task *task = param;
+    current_task = task;
+    task->fn(task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *handle, BaseType_t core_id)
+{
+    // Plain threads: default stack, no priorities, no pinning
+    (void)stack_size;
+    (void)priority;
+    (void)core_id;
+    struct host_shim_task *task = calloc(1, sizeof(*task));
+    if (!task) {
+        return pdFAIL;
+    }
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&task->cond, &attr);
+    pthread_condattr_destroy(&attr);
+    pthread_mutex_init(&task->lock, NULL);
+    task->fn = fn;
+    task->arg = arg;
+
+    // Publish the handle before the task runs: the comm tasks are notified through it
+    if (handle) {
+        *handle = task;
+    }
+    if (pthread_create(&task->thread, NULL, task_entry, task) != 0) {
+        ESP_LOGE(SHIM_TAG, "Could not start task %s", name);
+        if (handle) {
+            *handle = NULL;
+        }
+        free(task);
+        return pdFAIL;
+    }
+    pthread_detach(task->thread);
+    return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_size, void *arg,
+                       UBaseType_t priority, TaskHandle_t *handle)
+{
+    return xTaskCreatePinnedToCore(fn, name, stack_size, arg, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    struct host_shim_task *self = current_task;
+    if (task || !self) {
+        ESP_LOGE(SHIM_TAG, "vTaskDelete is only supported on the calling task");
+        return;
+    }
+    pthread_mutex_destroy(&self->lock);
+    pthread_cond_destroy(&self->cond);
+    free(self);
+    current_task = NULL;
+    pthread_exit(NULL);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    struct timespec ts = { .tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000 };
+    nanosleep(&ts, NULL);
+}
+
+BaseType_t xPortGetCoreID(void)
+{
+    return 0;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    pthread_mutex_lock(&task->lock);
+    task->notify_count++;
+    pthread_cond_signal(&task->cond);
+    pthread_mutex_unlock(&task->lock);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks_to_wait)
+{
+    struct host_shim_task *task = current_task;
+    if (!task) {
+        return 0;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (ticks_to_wait != portMAX_DELAY) {
+        deadline.tv_sec += ticks_to_wait / 1000;
+        deadline.tv_nsec += (long)(ticks_to_wait % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    pthread_mutex_lock(&task->lock);
+    while (task->notify_count == 0 && ticks_to_wait != 0) {
+        int rc = (ticks_to_wait == portMAX_DELAY) ? pthread_cond_wait(&task->cond, &task->lock)
+                                                  : pthread_cond_timedwait(&task->cond, &task->lock, &deadline);
+        if (rc == ETIMEDOUT) {
+            break;
+        }
+    }
+    uint32_t count = task->notify_count;
+    if (count) {
+        task->notify_count = clear_on_exit ? 0 : count - 1;
+    }
+    pthread_mutex_unlock(&task->lock);
+    return count;
+}
+
+// ---------------------------------------------------------------------------------------------
+// esp_http_client
+
+#define CLIENT_HEADER_SIZE 2048
+
+struct esp_http_client {
+    http_event_handle_cb event_handler;
+    void *user_data;
+    int timeout_ms;
+    int buffer_size;
+    char path[512];
+    struct in_addr host;
+    int fd;
+    int status_code;
+    int sock_errno;
+};
+
+const char *esp_err_to_name(esp_err_t err)
+{
+    switch (err) {
+        case ESP_OK: return "ESP_OK";
+        case ESP_FAIL: return "ESP_FAIL";
+        case ESP_ERR_NO_MEM: return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG: return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_TIMEOUT: return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_HTTP_CONNECT: return "ESP_ERR_HTTP_CONNECT";
+        case ESP_ERR_HTTP_EAGAIN: return "ESP_ERR_HTTP_EAGAIN";
+        default: return "UNKNOWN ERROR";
+    }
+}
+
+// The robot IP is dialled as given, so mocks bound to other loopback addresses (127.0.0.2, ...)
+// stand in for separate robots; a host that is not an IPv4 address goes to 127.0.0.1
+static struct sockaddr_in shim_robot_addr(const char *host)
+{
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons((uint16_t)host_shim_http_port) };
+    if (!host || inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    }
+    return addr;
+}
+
+static void client_event(esp_http_client_handle_t client, esp_http_client_event_id_t id, void *data, int len)
+{
+    if (!client->event_handler) {
+        return;
+    }
+    esp_http_client_event_t evt = {
+        .event_id = id, .client = client, .data = data, .data_len = len, .user_data = client->user_data,
+    };
+    client->event_handler(&evt);
+}
+
+static void client_disconnect(esp_http_client_handle_t client)
+{
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+        client_event(client, HTTP_EVENT_DISCONNECTED, NULL, 0);
+    }
+}
+
+static void client_apply_timeout(esp_http_client_handle_t client, int fd)
+{
+    struct timeval tv = { .tv_sec = client->timeout_ms / 1000, .tv_usec = (client->timeout_ms % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+}
+
+static esp_err_t client_connect(esp_http_client_handle_t client)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        client->sock_errno = errno;
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    client_apply_timeout(client, fd);
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons((uint16_t)host_shim_http_port),
+                                .sin_addr = client->host };
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        client->sock_errno = errno;
+        close(fd);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    client->fd = fd;
+    client_event(client, HTTP_EVENT_ON_CONNECTED, NULL, 0);
+    return ESP_OK;
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    esp_http_client_handle_t client = calloc(1, sizeof(*client));
+    if (!client) {
+        return NULL;
+    }
+    client->event_handler = config->event_handler;
+    client->user_data = config->user_data;
+    client->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : 5000;
+    client->buffer_size = config->buffer_size > 0 ? config->buffer_size : 512;
+    client->fd = -1;
+    client->host.s_addr = htonl(INADDR_LOOPBACK);
+    esp_http_client_set_url(client, config->url);
+    return client;
+}
+
+// A full URL also sets the robot to dial; the port is always host_shim_http_port
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    const char *path = url;
+    if (strncmp(url, "http://", 7) == 0) {
+        path = strchr(url + 7, '/');
+        if (!path) {
+            path = url + strlen(url);
+        }
+        char host[INET_ADDRSTRLEN] = "";
+        size_t host_len = (size_t)(path - (url + 7));
+        if (host_len < sizeof(host)) {
+            memcpy(host, url + 7, host_len);
+            host[host_len] = '\0';
+        }
+        client->host = shim_robot_addr(host).sin_addr;
+        if (!*path) {
+            path = "/";
+        }
+    }
+    if (strlen(path) >= sizeof(client->path)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strcpy(client->path, path);
+    return ESP_OK;
+}
+
+// Like the real client, a new timeout also applies to the open connection
+esp_err_t esp_http_client_set_timeout_ms(esp_http_client_handle_t client, int timeout_ms)
+{
+    if (timeout_ms <= 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->timeout_ms = timeout_ms;
+    if (client->fd >= 0) {
+        client_apply_timeout(client, client->fd);
+    }
+    return ESP_OK;
+}
+
+// Receive until the header terminator; returns the header length or -1
+static int client_read_headers(esp_http_client_handle_t client, char *buffer, int size, int *received)
+{
+    *received = 0;
+    while (*received < size - 1) {
+        ssize_t n = recv(client->fd, buffer + *received, size - 1 - *received, 0);
+        if (n <= 0) {
+            client->sock_errno = (n < 0) ? errno : ECONNRESET;
+            return -1;
+        }
+        *received += (int)n;
+        buffer[*received] = '\0';
+        char *end = strstr(buffer, "\r\n\r\n");
+        if (end) {
+            return (int)(end - buffer) + 4;
+        }
+    }
+    client->sock_errno = EMSGSIZE;
+    return -1;
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
+{
+    client->status_code = 0;
+    client->sock_errno = 0;
+
+    if (client->fd < 0) {
+        esp_err_t err = client_connect(client);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    char request[640];
+    int len = snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: robot\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n\r\n",
+                       client->path);
+    if (send(client->fd, request, len, MSG_NOSIGNAL) != len) {
+        client->sock_errno = errno;
+        client_disconnect(client);
+        return ESP_FAIL;
+    }
+    client_event(client, HTTP_EVENT_HEADER_SENT, NULL, 0);
+
+    char buffer[CLIENT_HEADER_SIZE];
+    int received = 0;
+    int header_len = client_read_headers(client, buffer, sizeof(buffer), &received);
+    if (header_len < 0) {
+        bool timed_out = (client->sock_errno == EAGAIN || client->sock_errno == EWOULDBLOCK);
+        client_disconnect(client);
+        return timed_out ? ESP_ERR_HTTP_EAGAIN : ESP_FAIL;
+    }
+
+    if (sscanf(buffer, "HTTP/1.%*d %d", &client->status_code) != 1) {
+        client_disconnect(client);
+        return ESP_FAIL;
+    }
+    int content_length = 0;
+    const char *field = strcasestr(buffer, "\r\nContent-Length:");
+    if (field && field < buffer + header_len) {
+        content_length = atoi(field + 17);
+    }
+    const char *connection = strcasestr(buffer, "\r\nConnection: close");
+    bool keep_alive = !(connection && connection < buffer + header_len);
+    client_event(client, HTTP_EVENT_ON_HEADERS_COMPLETE, NULL, 0);
+
+    // Body: whatever followed the headers, then the rest in buffer_size chunks
+    int body_in_buffer = received - header_len;
+    if (body_in_buffer > content_length) {
+        body_in_buffer = content_length;
+    }
+    if (body_in_buffer > 0) {
+        client_event(client, HTTP_EVENT_ON_DATA, buffer + header_len, body_in_buffer);
+    }
+    int remaining = content_length - body_in_buffer;
+    while (remaining > 0) {
+        int chunk = remaining < (int)sizeof(buffer) ? remaining : (int)sizeof(buffer);
+        ssize_t n = recv(client->fd, buffer, chunk, 0);
+        if (n <= 0) {
+            client->sock_errno = (n < 0) ? errno : ECONNRESET;
+            bool timed_out = (client->sock_errno == EAGAIN || client->sock_errno == EWOULDBLOCK);
+            client_disconnect(client);
+            return timed_out ? ESP_ERR_HTTP_EAGAIN : ESP_FAIL;
+        }
+        client_event(client, HTTP_EVENT_ON_DATA, buffer, (int)n);
+        remaining -= (int)n;
+    }
+
+    client_event(client, HTTP_EVENT_ON_FINISH, NULL, 0);
+    if (!keep_alive) {
+        client_disconnect(client);
+    }
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client->status_code;
+}
+
+int esp_http_client_get_errno(esp_http_client_handle_t client)
+{
+    return client->sock_errno;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+    client_disconnect(client);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    client_disconnect(client);
+    free(client);
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------------------------------------
+// esp_transport: TCP, and a WebSocket client layered on it
+
+#define WS_KEY          "dGhlIHNhbXBsZSBub25jZQ=="   // Any 16 bytes, base64; the reply is not checked
+#define WS_PATH_SIZE    64
+#define WS_MAX_FRAME    4096                          // Largest payload sent; commands are far smaller
+
+struct esp_transport_item {
+    esp_transport_handle_t parent;   // NULL for TCP, the TCP transport for WebSocket
+    int fd;                          // TCP only
+    char path[WS_PATH_SIZE];
+    ws_transport_opcodes_t read_opcode;
+    int read_payload_len;
+    int read_payload_left;           // Payload of the current frame still to be read
+};
+
+esp_transport_handle_t esp_transport_tcp_init(void)
+{
+    esp_transport_handle_t t = calloc(1, sizeof(*t));
+    if (t) {
+        t->fd = -1;
+    }
+    return t;
+}
+
+esp_transport_handle_t esp_transport_ws_init(esp_transport_handle_t parent_handle)
+{
+    esp_transport_handle_t t = calloc(1, sizeof(*t));
+    if (t) {
+        t->parent = parent_handle;
+        t->fd = -1;
+        strcpy(t->path, "/");
+    }
+    return t;
+}
+
+esp_err_t esp_transport_ws_set_path(esp_transport_handle_t t, const char *path)
+{
+    if (strlen(path) >= sizeof(t->path)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strcpy(t->path, path);
+    return ESP_OK;
+}
+
+static esp_transport_handle_t transport_tcp(esp_transport_handle_t t)
+{
+    return t->parent ? t->parent : t;
+}
+
+// Wait until the socket is readable: 1 if it is, 0 on timeout, -1 on error
+static int tcp_poll(esp_transport_handle_t tcp, int timeout_ms)
+{
+    if (tcp->fd < 0) {
+        return -1;
+    }
+    struct pollfd pfd = { .fd = tcp->fd, .events = POLLIN };
+    int rc = poll(&pfd, 1, timeout_ms);
+    if (rc > 0 && (pfd.revents & (POLLERR | POLLNVAL))) {
+        return -1;
+    }
+    return rc;
+}
+
+// Read exactly len bytes, each wait bounded by timeout_ms; false on timeout, error or EOF
+static bool tcp_read_exact(esp_transport_handle_t tcp, void *buffer, int len, int timeout_ms)
+{
+    char *p = buffer;
+    while (len > 0) {
+        if (tcp_poll(tcp, timeout_ms) <= 0) {
+            return false;
+        }
+        ssize_t n = recv(tcp->fd, p, (size_t)len, 0);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= (int)n;
+    }
+    return true;
+}
+
+static int tcp_connect(esp_transport_handle_t tcp, const char *host, int timeout_ms)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    struct timeval tv = { .tv_sec = timeout_ms / 1000, .tv_usec = (timeout_ms % 1000) * 1000 };
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    struct sockaddr_in addr = shim_robot_addr(host);
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    tcp->fd = fd;
+    return 0;
+}
+
+// Upgrade request; the response headers are read a byte at a time so no frame is swallowed
+static int ws_handshake(esp_transport_handle_t t, int timeout_ms)
+{
+    esp_transport_handle_t tcp = transport_tcp(t);
+    char buffer[CLIENT_HEADER_SIZE];
+    int len = snprintf(buffer, sizeof(buffer),
+                       "GET %s HTTP/1.1\r\nHost: robot\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+                       "Sec-WebSocket-Key: " WS_KEY "\r\nSec-WebSocket-Version: 13\r\n\r\n", t->path);
+    if (send(tcp->fd, buffer, (size_t)len, MSG_NOSIGNAL) != len) {
+        return -1;
+    }
+
+    int used = 0;
+    while (used < (int)sizeof(buffer) - 1) {
+        if (!tcp_read_exact(tcp, buffer + used, 1, timeout_ms)) {
+            return -1;
+        }
+        buffer[++used] = '\0';
+        if (used >= 4 && strcmp(buffer + used - 4, "\r\n\r\n") == 0) {
+            int status = 0;
+            return (sscanf(buffer, "HTTP/1.1 %d", &status) == 1 && status == 101) ? 0 : -1;
+        }
+    }
+    return -1;
+}
+
+int esp_transport_connect(esp_transport_handle_t t, const char *host, int port, int timeout_ms)
+{
+    (void)port;  // The mock serves WebSocket on its HTTP port
+    esp_transport_handle_t tcp = transport_tcp(t);
+    if (tcp_connect(tcp, host, timeout_ms) != 0) {
+        return -1;
+    }
+    if (t->parent && ws_handshake(t, timeout_ms) != 0) {
+        esp_transport_close(t);
+        return -1;
+    }
+    t->read_payload_left = 0;
+    return 0;
+}
+
+int esp_transport_ws_send_raw(esp_transport_handle_t t, ws_transport_opcodes_t opcode, const char *b, int len,
+                              int timeout_ms)
+{
+    esp_transport_handle_t tcp = transport_tcp(t);
+    if (tcp->fd < 0 || len < 0 || len > WS_MAX_FRAME) {
+        return -1;
+    }
+
+    // Client frames are always masked
+    static const uint8_t mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+    uint8_t frame[8 + WS_MAX_FRAME];
+    int header = 2;
+    frame[0] = (uint8_t)opcode;
+    if (len < 126) {
+        frame[1] = 0x80 | (uint8_t)len;
+    } else {
+        frame[1] = 0x80 | 126;
+        frame[2] = (uint8_t)(len >> 8);
+        frame[3] = (uint8_t)len;
+        header = 4;
+    }
+    memcpy(frame + header, mask, sizeof(mask));
+    header += sizeof(mask);
+    for (int i = 0; i < len; i++) {
+        frame[header + i] = (uint8_t)b[i] ^ mask[i % 4];
+    }
+
+    // A socket that stays full for timeout_ms is a timeout: nothing of the frame is sent
+    int total = header + len;
+    struct pollfd pfd = { .fd = tcp->fd, .events = POLLOUT };
+    if (poll(&pfd, 1, timeout_ms) == 0) {
+        return 0;
+    }
+    if (send(tcp->fd, frame, (size_t)total, MSG_NOSIGNAL) != total) {
+        return -1;
+    }
+    return len;
+}
+
+int esp_transport_write(esp_transport_handle_t t, const char *buffer, int len, int timeout_ms)
+{
+    if (t->parent) {
+        return esp_transport_ws_send_raw(t, WS_TRANSPORT_OPCODES_BINARY | WS_TRANSPORT_OPCODES_FIN, buffer, len, timeout_ms);
+    }
+    if (t->fd < 0) {
+        return -1;
+    }
+    ssize_t n = send(t->fd, buffer, (size_t)len, MSG_NOSIGNAL);
+    return (n < 0) ? -1 : (int)n;
+}
+
+int esp_transport_poll_read(esp_transport_handle_t t, int timeout_ms)
+{
+    if (t->read_payload_left > 0) {
+        return 1;
+    }
+    return tcp_poll(transport_tcp(t), timeout_ms);
+}
+
+// Start the next frame: its opcode and payload length. Server frames are never masked.
+static bool ws_read_header(esp_transport_handle_t t, int timeout_ms)
+{
+    esp_transport_handle_t tcp = transport_tcp(t);
+    uint8_t header[8];
+    if (!tcp_read_exact(tcp, header, 2, timeout_ms)) {
+        return false;
+    }
+    int len = header[1] & 0x7f;
+    if (len == 126) {
+        if (!tcp_read_exact(tcp, header, 2, timeout_ms)) {
+            return false;
+        }
+        len = (header[0] << 8) | header[1];
+    } else if (len == 127) {
+        return false;   // Nothing the mock sends is that large
+    }
+    t->read_opcode = (ws_transport_opcodes_t)(header[0] & 0x0f);
+    t->read_payload_len = len;
+    t->read_payload_left = len;
+    return true;
+}
+
+int esp_transport_read(esp_transport_handle_t t, char *buffer, int len, int timeout_ms)
+{
+    esp_transport_handle_t tcp = transport_tcp(t);
+    if (!t->parent) {
+        if (tcp_poll(tcp, timeout_ms) <= 0) {
+            return -1;
+        }
+        ssize_t n = recv(tcp->fd, buffer, (size_t)len, 0);
+        return (n <= 0) ? -1 : (int)n;
+    }
+
+    if (t->read_payload_left == 0) {
+        if (!ws_read_header(t, timeout_ms)) {
+            return -1;
+        }
+    }
+
+    int chunk = (t->read_payload_left < len) ? t->read_payload_left : len;
+    if (!tcp_read_exact(tcp, buffer, chunk, timeout_ms)) {
+        return -1;
+    }
+    t->read_payload_left -= chunk;
+
+    if (t->read_opcode == WS_TRANSPORT_OPCODES_PING && t->read_payload_left == 0) {
+        esp_transport_ws_send_raw(t, WS_TRANSPORT_OPCODES_PONG | WS_TRANSPORT_OPCODES_FIN, buffer, chunk, timeout_ms);
+    } else if (t->read_opcode == WS_TRANSPORT_OPCODES_CLOSE) {
+        return -1;
+    }
+    return chunk;
+}
+
+ws_transport_opcodes_t esp_transport_ws_get_read_opcode(esp_transport_handle_t t)
+{
+    return t->read_opcode;
+}
+
+int esp_transport_ws_get_read_payload_len(esp_transport_handle_t t)
+{
+    return t->read_payload_len;
+}
+
+int esp_transport_close(esp_transport_handle_t t)
+{
+    esp_transport_handle_t tcp = transport_tcp(t);
+    if (tcp->fd >= 0) {
+        close(tcp->fd);
+        tcp->fd = -1;
+    }
+    t->read_payload_left = 0;
+    return 0;
+}
+
+esp_err_t esp_transport_destroy(esp_transport_handle_t t)
+{
+    if (t && !t->parent) {
+        esp_transport_close(t);
+    }
+    free(t);
+    return ESP_OK;
+}
+
+// ---------------------------------------------------------------------------------------------
+// wifi_manager: the loopback link is always up
+
+bool wifi_is_connected(void)
+{
+    return true;
+}
+
+// No radio, so no power save either
+void wifi_note_activity(void)
+{
+}
+
+bool wifi_power_save_active(void)
+{
+    return false;
+}
+
+// wifi_supervisor: loopback never degrades, so the rate is never capped below its maximum
+uint8_t wifi_get_link_quality(void)
+{
+    return 100;
+}
+
+// ---------------------------------------------------------------------------------------------
+// UART driver on host_shim_uart_path. The device stands in for the driver's ring buffers: writes
+// go straight to it and reads wait on it, so the transport runs unmodified against a pty.
+
+static int uart_fd = -1;
+
+esp_err_t uart_driver_install(uart_port_t port, int rx_buffer_size, int tx_buffer_size, int queue_size,
+                              void *uart_queue, int intr_alloc_flags)
+{
+    (void)port, (void)rx_buffer_size, (void)tx_buffer_size, (void)queue_size, (void)uart_queue, (void)intr_alloc_flags;
+    if (uart_fd >= 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (!host_shim_uart_path) {
+        return ESP_FAIL;
+    }
+    uart_fd = open(host_shim_uart_path, O_RDWR | O_NOCTTY);
+    if (uart_fd < 0) {
+        ESP_LOGE(SHIM_TAG, "Could not open %s: %s", host_shim_uart_path, strerror(errno));
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+}
+
+esp_err_t uart_driver_delete(uart_port_t port)
+{
+    (void)port;
+    if (uart_fd < 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    close(uart_fd);
+    uart_fd = -1;
+    return ESP_OK;
+}
+
+// Raw 8N1, so bytes pass through the tty layer unchanged; the baud rate means nothing on a pty
+esp_err_t uart_param_config(uart_port_t port, const uart_config_t *config)
+{
+    (void)port, (void)config;
+    struct termios tio;
+    if (uart_fd < 0 || tcgetattr(uart_fd, &tio) != 0) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    cfmakeraw(&tio);
+    return tcsetattr(uart_fd, TCSANOW, &tio) == 0 ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t uart_set_pin(uart_port_t port, int tx_io_num, int rx_io_num, int rts_io_num, int cts_io_num)
+{
+    (void)port, (void)tx_io_num, (void)rx_io_num, (void)rts_io_num, (void)cts_io_num;
+    return uart_fd >= 0 ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+int uart_read_bytes(uart_port_t port, void *buffer, uint32_t length, TickType_t ticks_to_wait)
+{
+    (void)port;
+    struct pollfd pfd = { .fd = uart_fd, .events = POLLIN };
+    int timeout_ms = (ticks_to_wait == portMAX_DELAY) ? -1 : (int)ticks_to_wait;
+    int ready = poll(&pfd, 1, timeout_ms);
+    if (ready <= 0) {
+        return (ready < 0) ? -1 : 0;
+    }
+    ssize_t n = read(uart_fd, buffer, length);
+    if (n <= 0) {
+        // The fake robot hung up: wait out the timeout rather than spin the reader
+        vTaskDelay(ticks_to_wait == portMAX_DELAY ? 100 : ticks_to_wait);
+        return (n < 0) ? -1 : 0;
+    }
+    return (int)n;
+}
+
+int uart_write_bytes(uart_port_t port, const void *src, size_t size)
+{
+    (void)port;
+    const char *p = src;
+    size_t left = size;
+    while (left > 0) {
+        ssize_t n = write(uart_fd, p, left);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        p += n;
+        left -= (size_t)n;
+    }
+    return (int)size;
+}
@@ -0,0 +1,8 @@
+#ifndef HOST_SHIM_H
+#define HOST_SHIM_H
+
+// Knobs of the host shims, set by the benchmark driver before robot_arm_init()
+extern int host_shim_http_port;   // Port the esp_http_client and esp_transport shims connect to (default 80)
+extern const char *host_shim_uart_path;   // Serial device the UART driver shim opens (default none)
+
+#endif // HOST_SHIM_H
@@ -0,0 +1,93 @@
+// The pre-encoded command cache must produce exactly what the encoder does, for single-joint
+// (T:101) and all-joint (T:102) moves on slider steps, in both wire forms, and stay out of the
+// way for everything else.
+#include "host_test.h"
+#include "robot_arm_cmd_cache.h"
+#include "robot_arm_encode.h"
+
+#define SPEED        0
+#define ACCELERATION 10
+
+// The UI's slider ranges
+static const float ranges[ROBOT_ARM_JOINT_COUNT][2] = {
+    { -1.57f, 1.57f }, { -0.2f, 1.4f }, { -1.0f, 1.5f }, { 1.08f, 3.14f },
+};
+
+// Same arithmetic as map_slider_to_joint_range()
+static float slider_radians(int joint_index, int step)
+{
+    const float *range = ranges[joint_index];
+    return range[0] + (float)step * (range[1] - range[0]) / 100.0f;
+}
+
+static void check_matches_encoder(const robot_arm_cmd_t *cmd)
+{
+    static const robot_arm_payload_t formats[] = { ROBOT_ARM_PAYLOAD_JSON, ROBOT_ARM_PAYLOAD_HTTP_PATH };
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+        char expected[256], buffer[256];
+        CHECK(robot_arm_encode_command(cmd, formats[i], expected, sizeof(expected)) > 0);
+        CHECK_STR(robot_arm_cmd_cache_lookup(cmd, formats[i], buffer, sizeof(buffer)), expected);
+    }
+}
+
+int main(void)
+{
+    robot_arm_cmd_t cmd = { .type = ROBOT_ARM_CMD_MOVE_JOINT };
+    cmd.move.speed = SPEED;
+    cmd.move.acceleration = ACCELERATION;
+    CHECK(robot_arm_cmd_cache_lookup(&cmd, ROBOT_ARM_PAYLOAD_JSON, NULL, 0) == NULL);  // Not built yet
+
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        CHECK(robot_arm_cmd_cache_build((robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + i), ranges[i][0], ranges[i][1],
+                                        SPEED, ACCELERATION));
+    }
+    CHECK(!robot_arm_cmd_cache_build(ROBOT_ARM_JOINT_BASE, ranges[0][0], ranges[0][1], SPEED, ACCELERATION));
+
+    // Every slider step of every joint
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        for (int step = 0; step <= ROBOT_ARM_CMD_CACHE_STEPS; step++) {
+            cmd.move.joint = (robot_arm_joint_t)(ROBOT_ARM_JOINT_BASE + i);
+            cmd.move.radians = slider_radians(i, step);
+            check_matches_encoder(&cmd);
+        }
+    }
+
+    // All-joint moves across the grid, as the batch send window produces them
+    robot_arm_cmd_t joints = { .type = ROBOT_ARM_CMD_MOVE_JOINTS };
+    joints.joints.speed = SPEED;
+    joints.joints.acceleration = ACCELERATION;
+    for (int step = 0; step <= ROBOT_ARM_CMD_CACHE_STEPS; step++) {
+        for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+            joints.joints.radians[i] = slider_radians(i, (step * (i + 3)) % (ROBOT_ARM_CMD_CACHE_STEPS + 1));
+        }
+        check_matches_encoder(&joints);
+    }
+
+    // Misses fall back to the encoder: off the grid, other speed, too small a buffer, other types
+    char buffer[256];
+    uint32_t hits_before, misses_before, hits, misses;
+    robot_arm_cmd_cache_get_stats(&hits_before, &misses_before);
+
+    robot_arm_cmd_t off_grid = joints;
+    off_grid.joints.radians[2] += 0.001f;
+    CHECK(robot_arm_cmd_cache_lookup(&off_grid, ROBOT_ARM_PAYLOAD_JSON, buffer, sizeof(buffer)) == NULL);
+
+    robot_arm_cmd_t streamed = joints;
+    streamed.joints.acceleration = 0;
+    CHECK(robot_arm_cmd_cache_lookup(&streamed, ROBOT_ARM_PAYLOAD_HTTP_PATH, buffer, sizeof(buffer)) == NULL);
+
+    CHECK(robot_arm_cmd_cache_lookup(&joints, ROBOT_ARM_PAYLOAD_HTTP_PATH, buffer, 40) == NULL);
+    CHECK(robot_arm_cmd_cache_lookup(&joints, ROBOT_ARM_PAYLOAD_JSON, NULL, 0) == NULL);
+
+    cmd.move.radians = 5.0f;
+    CHECK(robot_arm_cmd_cache_lookup(&cmd, ROBOT_ARM_PAYLOAD_JSON, NULL, 0) == NULL);
+
+    robot_arm_cmd_t feedback = { .type = ROBOT_ARM_CMD_FEEDBACK };
+    CHECK(robot_arm_cmd_cache_lookup(&feedback, ROBOT_ARM_PAYLOAD_JSON, buffer, sizeof(buffer)) == NULL);
+
+    robot_arm_cmd_cache_get_stats(&hits, &misses);
+    CHECK(hits == hits_before);
+    CHECK(misses - misses_before == 5);  // The feedback request is not a move and not counted
+
+    return host_test_finish("test_cmd_cache");
+}
@@ -0,0 +1,112 @@
+// Kinematics: FK matches the arm's geometry, and FK -> IK -> FK lands back on the same tip across
+// the UI's joint ranges. Targets out of reach or outside the ranges are flagged, not silently moved.
+#include "host_test.h"
+#include "robot_arm_kinematics.h"
+
+#define GRID_STEPS     24
+#define FK_TOLERANCE   0.05    // mm, table trig against libm
+#define TIP_TOLERANCE  0.1     // mm, round trip through the solver
+
+// Same table as ui_robot_interface.c
+static const robot_arm_traj_limits_t joint_limits[] = {
+    { -1.57f, 1.57f, 1.5f, 4.0f, 80.0f },
+    { -0.2f, 1.4f, 1.0f, 3.0f, 60.0f },
+    { -1.0f, 1.5f, 1.2f, 3.0f, 60.0f },
+    { 1.08f, 3.14f, 2.0f, 6.0f, 120.0f },
+};
+
+#define L2_MM          hypot(ROBOT_ARM_L2A_MM, ROBOT_ARM_L2B_MM)
+// The solver keeps this far inside full stretch and reports anything beyond it as out of reach
+#define STRETCH_MM     ((L2_MM + ROBOT_ARM_L3_MM) * 0.9999)
+
+// The header's frame and conventions, in double precision. Returns the shoulder-to-tip distance.
+static double reference_fk(const float radians[ROBOT_ARM_JOINT_COUNT], double tip[3])
+{
+    double l2 = L2_MM;
+    double upper = radians[1] + atan2(ROBOT_ARM_L2B_MM, ROBOT_ARM_L2A_MM);
+    double fore = (double)radians[1] + radians[2];
+    double reach = l2 * sin(upper) + ROBOT_ARM_L3_MM * sin(fore);
+    tip[0] = reach * cos(radians[0]);
+    tip[1] = reach * sin(radians[0]);
+    double height = l2 * cos(upper) + ROBOT_ARM_L3_MM * cos(fore);
+    tip[2] = ROBOT_ARM_L1_MM + height;
+    return hypot(reach, height);
+}
+
+static double tip_distance(const robot_arm_cartesian_t *a, const robot_arm_cartesian_t *b)
+{
+    return sqrt((a->x - b->x) * (a->x - b->x) + (a->y - b->y) * (a->y - b->y) + (a->z - b->z) * (a->z - b->z));
+}
+
+static float grid(int joint, int step)
+{
+    return joint_limits[joint].min_rad + (joint_limits[joint].max_rad - joint_limits[joint].min_rad) * step / GRID_STEPS;
+}
+
+int main(void)
+{
+    robot_arm_kinematics_init();
+
+    // Home: upper arm upright, forearm level and forward
+    float home[ROBOT_ARM_JOINT_COUNT] = { 0.0f, 0.0f, 1.5707963f, 3.14f };
+    robot_arm_cartesian_t pose;
+    robot_arm_fk(home, &pose);
+    CHECK_NEAR(pose.x, ROBOT_ARM_L2B_MM + ROBOT_ARM_L3_MM, FK_TOLERANCE);
+    CHECK_NEAR(pose.y, 0.0, FK_TOLERANCE);
+    CHECK_NEAR(pose.z, ROBOT_ARM_L1_MM + ROBOT_ARM_L2A_MM, FK_TOLERANCE);
+    CHECK_NEAR(pose.gripper, 3.14, 1e-6);
+
+    double worst_fk = 0.0, worst_tip = 0.0;
+    for (int b = 0; b <= GRID_STEPS; b++) {
+        for (int s = 0; s <= GRID_STEPS; s++) {
+            for (int e = 0; e <= GRID_STEPS; e++) {
+                float radians[ROBOT_ARM_JOINT_COUNT] = { grid(0, b), grid(1, s), grid(2, e), grid(3, e) };
+                robot_arm_fk(radians, &pose);
+
+                double tip[3];
+                double distance = reference_fk(radians, tip);
+                double fk_error = sqrt((pose.x - tip[0]) * (pose.x - tip[0]) + (pose.y - tip[1]) * (pose.y - tip[1]) +
+                                       (pose.z - tip[2]) * (pose.z - tip[2]));
+                worst_fk = fmax(worst_fk, fk_error);
+                CHECK(fk_error <= FK_TOLERANCE);
+
+                // Every pose the joints can reach solves within range and back onto the same tip.
+                // Only a pose within the stretch margin is flagged, and a joint sitting exactly
+                // on its limit may come back clamped by a rounding error.
+                float solved[ROBOT_ARM_JOINT_COUNT];
+                robot_arm_ik_status_t status = robot_arm_ik(&pose, joint_limits, solved);
+                bool on_limit = b == 0 || b == GRID_STEPS || s == 0 || s == GRID_STEPS || e == 0 || e == GRID_STEPS;
+                CHECK(status == ((distance > STRETCH_MM) ? ROBOT_ARM_IK_OUT_OF_REACH : ROBOT_ARM_IK_OK) ||
+                      (on_limit && status == ROBOT_ARM_IK_JOINT_LIMIT));
+                robot_arm_cartesian_t again;
+                robot_arm_fk(solved, &again);
+                double tip_error = tip_distance(&pose, &again);
+                worst_tip = fmax(worst_tip, tip_error);
+                CHECK(tip_error <= TIP_TOLERANCE);
+                CHECK(solved[3] == radians[3]);
+                for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+                    CHECK(solved[i] >= joint_limits[i].min_rad && solved[i] <= joint_limits[i].max_rad);
+                }
+            }
+        }
+    }
+    printf("test_kinematics: worst FK error %.4f mm, worst round trip %.4f mm\n", worst_fk, worst_tip);
+
+    // Beyond full stretch: pulled in along the same ray
+    robot_arm_cartesian_t far = { .x = 600.0f, .y = 600.0f, .z = 300.0f, .gripper = 2.0f };
+    float solved[ROBOT_ARM_JOINT_COUNT];
+    CHECK(robot_arm_ik(&far, joint_limits, solved) == ROBOT_ARM_IK_OUT_OF_REACH);
+    robot_arm_fk(solved, &pose);
+    CHECK_NEAR(atan2(pose.y, pose.x), atan2(far.y, far.x), 1e-3);
+    CHECK_NEAR(sqrt(pose.x * pose.x + pose.y * pose.y + (pose.z - ROBOT_ARM_L1_MM) * (pose.z - ROBOT_ARM_L1_MM)),
+               STRETCH_MM, 0.5);
+
+    // Low, straight behind the base: neither turning the base nor leaning back reaches it in range
+    robot_arm_cartesian_t behind = { .x = -300.0f, .y = 0.0f, .z = 200.0f, .gripper = 2.0f };
+    CHECK(robot_arm_ik(&behind, joint_limits, solved) == ROBOT_ARM_IK_JOINT_LIMIT);
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        CHECK(solved[i] >= joint_limits[i].min_rad && solved[i] <= joint_limits[i].max_rad);
+    }
+
+    return host_test_finish("test_kinematics");
+}
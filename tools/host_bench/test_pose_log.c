@@ -0,0 +1,110 @@
+// Pose log codec: a recording decodes back to every pose within half a fixed-point unit, and a
+// record cut short or a buffer too small is reported instead of decoding garbage.
+#include <stdlib.h>
+#include "host_test.h"
+#include "robot_arm_pose_log.h"
+
+#define SAMPLES     2000
+#define LOG_SIZE    (ROBOT_ARM_POSE_LOG_HEADER_SIZE + SAMPLES * ROBOT_ARM_POSE_MAX_RECORD_SIZE)
+#define HALF_UNIT   (0.5 / ROBOT_ARM_POSE_UNITS_PER_RAD + 1e-6)
+
+static uint8_t log_data[LOG_SIZE];
+static robot_arm_pose_t poses[SAMPLES];
+
+// A 50 Hz recording of a slow sweep (hand-guided pace), with sampling jitter, a pause and a few jumps
+static void make_poses(void)
+{
+    uint32_t time_ms = 0;
+    srand(1);
+    for (int n = 0; n < SAMPLES; n++) {
+        time_ms += (n == SAMPLES / 2) ? 70000 : 20 + rand() % 3;
+        poses[n].time_ms = time_ms;
+        for (int j = 0; j < ROBOT_ARM_JOINT_COUNT; j++) {
+            poses[n].radians[j] = 0.8f * sinf(0.3f * time_ms / 1000.0f + j) + ((n % 500 == 7) ? 3.0f - j : 0.0f);
+        }
+    }
+}
+
+static size_t encode_all(void)
+{
+    robot_arm_pose_codec_t codec;
+    robot_arm_pose_codec_reset(&codec);
+    int pos = robot_arm_pose_write_header(log_data, sizeof(log_data));
+    CHECK(pos == ROBOT_ARM_POSE_LOG_HEADER_SIZE);
+    for (int n = 0; n < SAMPLES; n++) {
+        int written = robot_arm_pose_encode(&codec, &poses[n], log_data + pos, sizeof(log_data) - pos);
+        CHECK(written > 0 && written <= ROBOT_ARM_POSE_MAX_RECORD_SIZE);
+        pos += written;
+    }
+    return (size_t)pos;
+}
+
+int main(void)
+{
+    make_poses();
+    size_t len = encode_all();
+    CHECK(robot_arm_pose_check_header(log_data, len));
+    // A slow move costs what the header comment promises, jumps included
+    CHECK(len - ROBOT_ARM_POSE_LOG_HEADER_SIZE <= SAMPLES * 7);
+
+    // Round trip, then a clean end
+    robot_arm_pose_codec_t codec;
+    robot_arm_pose_codec_reset(&codec);
+    robot_arm_pose_t pose;
+    size_t pos = ROBOT_ARM_POSE_LOG_HEADER_SIZE;
+    for (int n = 0; n < SAMPLES; n++) {
+        int used = robot_arm_pose_decode(&codec, log_data + pos, len - pos, &pose);
+        CHECK(used > 0);
+        if (used <= 0) {
+            break;
+        }
+        pos += used;
+        CHECK(pose.time_ms == poses[n].time_ms);
+        for (int j = 0; j < ROBOT_ARM_JOINT_COUNT; j++) {
+            CHECK_NEAR(pose.radians[j], poses[n].radians[j], HALF_UNIT);
+        }
+    }
+    CHECK(pos == len);
+    CHECK(robot_arm_pose_decode(&codec, log_data + pos, len - pos, &pose) == 0);
+
+    // Every cut inside the first record is truncation, not a shorter pose
+    uint8_t record[ROBOT_ARM_POSE_MAX_RECORD_SIZE];
+    robot_arm_pose_codec_reset(&codec);
+    int record_len = robot_arm_pose_encode(&codec, &poses[7], record, sizeof(record));
+    CHECK(record_len > 0);
+    for (int cut = 1; cut < record_len; cut++) {
+        robot_arm_pose_codec_reset(&codec);
+        CHECK(robot_arm_pose_decode(&codec, record, (size_t)cut, &pose) == -1);
+    }
+
+    // A record that does not fit leaves the delta state alone, so the next one still decodes
+    robot_arm_pose_codec_reset(&codec);
+    robot_arm_pose_codec_t before = codec;
+    CHECK(robot_arm_pose_encode(&codec, &poses[7], record, (size_t)record_len - 1) == -1);
+    CHECK(memcmp(&codec, &before, sizeof(codec)) == 0);
+
+    // Extremes: a full turn either way and a long gap
+    robot_arm_pose_t extreme = { .time_ms = UINT32_MAX / 2, .radians = { -6.2832f, 6.2832f, 0.0f, -0.00005f } };
+    robot_arm_pose_codec_reset(&codec);
+    record_len = robot_arm_pose_encode(&codec, &extreme, record, sizeof(record));
+    robot_arm_pose_codec_reset(&codec);
+    CHECK(robot_arm_pose_decode(&codec, record, (size_t)record_len, &pose) == record_len);
+    CHECK(pose.time_ms == extreme.time_ms);
+    for (int j = 0; j < ROBOT_ARM_JOINT_COUNT; j++) {
+        CHECK_NEAR(pose.radians[j], extreme.radians[j], HALF_UNIT);
+    }
+
+    // Headers from another format or build are refused
+    uint8_t header[ROBOT_ARM_POSE_LOG_HEADER_SIZE];
+    CHECK(robot_arm_pose_write_header(header, sizeof(header) - 1) == -1);
+    robot_arm_pose_write_header(header, sizeof(header));
+    CHECK(!robot_arm_pose_check_header(header, sizeof(header) - 1));
+    for (size_t i = 0; i < sizeof(header); i++) {
+        header[i] ^= 0x01;
+        CHECK(!robot_arm_pose_check_header(header, sizeof(header)));
+        header[i] ^= 0x01;
+    }
+    CHECK(robot_arm_pose_check_header(header, sizeof(header)));
+
+    return host_test_finish("test_pose_log");
+}
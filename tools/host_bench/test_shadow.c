@@ -0,0 +1,85 @@
+// Joint shadow: an edit is in flight until the robot accepts it, moving until the arm gets there,
+// and failed or diverged when it does not within the timeouts. A failure only sticks to the edit
+// it carried, and a value adopted from the robot needs no acknowledgement.
+#include "host_test.h"
+#include "robot_arm_shadow.h"
+
+#define MS(ms)   ((int64_t)(ms) * 1000)
+
+static robot_arm_shadow_t shadow;
+
+// One update of joint 0 at now_ms with feedback taken at the same instant
+static robot_arm_shadow_state_t update(float acked, float measured, int64_t now_ms)
+{
+    return robot_arm_shadow_update(&shadow, 0, acked, measured, MS(now_ms), MS(now_ms));
+}
+
+int main(void)
+{
+    // Nothing commanded: settled until the robot reports, then the report is the truth to show
+    robot_arm_shadow_init(&shadow);
+    CHECK(robot_arm_shadow_generation(&shadow) == 0);
+    CHECK(update(NAN, NAN, 100) == ROBOT_ARM_SHADOW_SETTLED);
+    CHECK(update(NAN, 0.3f, 200) == ROBOT_ARM_SHADOW_DIVERGED);
+    // Stale feedback says nothing
+    CHECK(robot_arm_shadow_update(&shadow, 0, NAN, NAN, 0, MS(1300)) == ROBOT_ARM_SHADOW_SETTLED);
+
+    // Edit -> in flight -> accepted within the tolerance -> moving -> reached
+    robot_arm_shadow_init(&shadow);
+    uint32_t generation = robot_arm_shadow_command(&shadow, 0, 1.0f, MS(1000));
+    CHECK(generation == 1 && robot_arm_shadow_generation(&shadow) == 1);
+    CHECK(update(NAN, 0.0f, 1000) == ROBOT_ARM_SHADOW_IN_FLIGHT);
+    CHECK(update(0.99f, 0.0f, 1100) == ROBOT_ARM_SHADOW_IN_FLIGHT);
+    CHECK(update(1.004f, 0.0f, 1200) == ROBOT_ARM_SHADOW_MOVING);
+    CHECK(update(1.004f, 0.5f, 2000) == ROBOT_ARM_SHADOW_MOVING);
+    CHECK(update(1.004f, 0.96f, 2500) == ROBOT_ARM_SHADOW_SETTLED);
+    // Accepted with no fresh feedback is as good as it gets
+    CHECK(update(1.004f, NAN, 5000) == ROBOT_ARM_SHADOW_SETTLED);
+
+    // The settle timeout runs from acceptance, not from the edit
+    robot_arm_shadow_command(&shadow, 0, 0.0f, MS(10000));
+    CHECK(update(1.0f, 1.0f, 12000) == ROBOT_ARM_SHADOW_IN_FLIGHT);
+    CHECK(update(0.0f, 1.0f, 14000) == ROBOT_ARM_SHADOW_MOVING);
+    CHECK(update(0.0f, 1.0f, 17000) == ROBOT_ARM_SHADOW_MOVING);
+    CHECK(update(0.0f, 1.0f, 17001) == ROBOT_ARM_SHADOW_DIVERGED);
+    CHECK(update(0.0f, 0.01f, 17100) == ROBOT_ARM_SHADOW_SETTLED);
+
+    // Never accepted: failed once the acknowledgement timeout runs out
+    robot_arm_shadow_command(&shadow, 0, 0.5f, MS(20000));
+    CHECK(update(0.0f, 0.0f, 28000) == ROBOT_ARM_SHADOW_IN_FLIGHT);
+    CHECK(update(0.0f, 0.0f, 28001) == ROBOT_ARM_SHADOW_FAILED);
+    CHECK(update(0.5f, 0.0f, 28100) == ROBOT_ARM_SHADOW_MOVING);
+
+    // A failed send counts for the edits it carried, not for a newer one made since
+    robot_arm_shadow_init(&shadow);
+    uint32_t first = robot_arm_shadow_command(&shadow, 0, 0.2f, MS(1000));
+    robot_arm_shadow_command(&shadow, 1, 0.4f, MS(1000));
+    uint32_t sent = robot_arm_shadow_generation(&shadow);
+    uint32_t second = robot_arm_shadow_command(&shadow, 0, 0.3f, MS(1100));
+    CHECK(second > sent && sent > first);
+    robot_arm_shadow_fail(&shadow, 0x3, sent);
+    CHECK(update(NAN, NAN, 1200) == ROBOT_ARM_SHADOW_IN_FLIGHT);
+    CHECK(robot_arm_shadow_update(&shadow, 1, NAN, NAN, 0, MS(1200)) == ROBOT_ARM_SHADOW_FAILED);
+    CHECK(robot_arm_shadow_update(&shadow, 2, NAN, NAN, 0, MS(1200)) == ROBOT_ARM_SHADOW_SETTLED);
+    robot_arm_shadow_fail(&shadow, 0x1, second);
+    CHECK(update(NAN, NAN, 1300) == ROBOT_ARM_SHADOW_FAILED);
+    // A late report of an older failure does not wind the joint back
+    robot_arm_shadow_fail(&shadow, 0x1, sent);
+    CHECK(atomic_load(&shadow.failed_generation[0]) == second);
+    // Even the robot accepting the value does not clear a failure, only a new edit does
+    CHECK(update(0.3f, NAN, 1400) == ROBOT_ARM_SHADOW_FAILED);
+    robot_arm_shadow_command(&shadow, 0, 0.3f, MS(1500));
+    CHECK(update(0.3f, NAN, 1600) == ROBOT_ARM_SHADOW_SETTLED);
+
+    // Adopting the robot's value: settled at once, failures and the robot's acks no longer apply
+    robot_arm_shadow_fail(&shadow, 0x1, robot_arm_shadow_generation(&shadow) + 5);
+    robot_arm_shadow_reconcile(&shadow, 0, 0.8f, MS(2000));
+    CHECK(shadow.joints[0].state == ROBOT_ARM_SHADOW_SETTLED);
+    CHECK(shadow.joints[0].commanded == 0.8f && shadow.joints[0].adopted);
+    CHECK(update(NAN, 0.8f, 2100) == ROBOT_ARM_SHADOW_SETTLED);
+    CHECK(update(NAN, 0.2f, 2200) == ROBOT_ARM_SHADOW_MOVING);
+    CHECK(update(NAN, 0.2f, 5001) == ROBOT_ARM_SHADOW_DIVERGED);
+    CHECK(update(NAN, NAN, 20000) == ROBOT_ARM_SHADOW_SETTLED);
+
+    return host_test_finish("test_shadow");
+}
@@ -0,0 +1,53 @@
+// Latency histogram: percentiles land on the upper bound of their bucket, within the histogram's
+// relative error, and never report more than was recorded.
+#include "host_test.h"
+#include "robot_arm_stats.h"
+
+int main(void)
+{
+    static robot_arm_latency_hist_t hist;
+    CHECK(robot_arm_latency_percentile(&hist, 50.0f) == 0);
+
+    // Small values have exact buckets
+    for (int us = 0; us < 4; us++) {
+        robot_arm_latency_record(&hist, us);
+    }
+    CHECK(robot_arm_latency_percentile(&hist, 100.0f) == 3);
+    robot_arm_latency_reset(&hist);
+
+    // 1..1000 us: every percentile within 25% above the exact value
+    for (int us = 1; us <= 1000; us++) {
+        robot_arm_latency_record(&hist, us);
+    }
+    for (int p = 1; p <= 100; p++) {
+        uint32_t value = robot_arm_latency_percentile(&hist, (float)p);
+        CHECK(value >= (uint32_t)(p * 10));
+        CHECK(value <= (uint32_t)(p * 10 * 1.25));
+    }
+    CHECK(robot_arm_latency_max(&hist) == 1000);
+
+    // One sample at the bottom of a wide bucket: its upper bound would be 1279 us
+    robot_arm_latency_reset(&hist);
+    robot_arm_latency_record(&hist, 1025);
+    CHECK(robot_arm_latency_percentile(&hist, 50.0f) == 1025);
+    CHECK(robot_arm_latency_percentile(&hist, 99.0f) == 1025);
+
+    // The tail is clamped to the max, lower percentiles keep their bucket bound
+    robot_arm_latency_reset(&hist);
+    for (int i = 0; i < 99; i++) {
+        robot_arm_latency_record(&hist, 100);
+    }
+    robot_arm_latency_record(&hist, 9314);
+    CHECK(robot_arm_latency_percentile(&hist, 50.0f) == 111);
+    CHECK(robot_arm_latency_percentile(&hist, 100.0f) == 9314);
+    CHECK(robot_arm_latency_percentile(&hist, 100.0f) <= robot_arm_latency_max(&hist));
+
+    // Out-of-range samples are clamped, not lost
+    robot_arm_latency_reset(&hist);
+    robot_arm_latency_record(&hist, -5);
+    CHECK(robot_arm_latency_percentile(&hist, 50.0f) == 0);
+    robot_arm_latency_record(&hist, (int64_t)1 << 40);
+    CHECK(robot_arm_latency_max(&hist) == UINT32_MAX);
+
+    return host_test_finish("test_stats");
+}
@@ -0,0 +1,125 @@
+// Joint telemetry: the timer's samples come out of the ring once each and in order, a full ring
+// drops and counts new samples instead of overwriting unread ones, and a min/max bucket keeps a
+// signal's extremes in the order they occurred.
+#include <stdatomic.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "robot_arm_telemetry.h"
+#include "robot_arm_feedback.h"
+
+#define RING_LENGTH  64   // Same as robot_arm_telemetry.c
+
+// Stand-ins for the comm stack: every sample reads the next value of a counter, so a sample lost,
+// repeated or reordered by the ring shows up as a gap in the sequence
+static atomic_uint next_value = 0;
+static atomic_bool have_feedback = false;
+
+bool robot_arm_get_commanded_joints(float radians[ROBOT_ARM_JOINT_COUNT])
+{
+    unsigned int value = atomic_fetch_add(&next_value, 1);
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        radians[i] = (float)value + 0.25f * i;
+    }
+    return true;
+}
+
+bool robot_arm_get_feedback(robot_arm_feedback_t *feedback)
+{
+    if (!atomic_load(&have_feedback)) {
+        return false;
+    }
+    for (int i = 0; i < ROBOT_ARM_JOINT_COUNT; i++) {
+        feedback->joint_rad[i] = -1.0f - i;
+    }
+    return true;
+}
+
+// Pop everything there is; every sample must follow on from *expected
+static int drain(unsigned int *expected, int64_t *last_us)
+{
+    robot_arm_telemetry_sample_t sample;
+    int popped = 0;
+    while (robot_arm_telemetry_pop(&sample)) {
+        CHECK(sample.commanded[0] == (float)*expected);
+        CHECK(sample.commanded[ROBOT_ARM_JOINT_COUNT - 1] == (float)*expected + 0.25f * (ROBOT_ARM_JOINT_COUNT - 1));
+        CHECK(sample.time_us >= *last_us);
+        CHECK(atomic_load(&have_feedback) ? sample.measured[1] == -2.0f : isnan(sample.measured[1]));
+        (*expected)++;
+        *last_us = sample.time_us;
+        popped++;
+    }
+    return popped;
+}
+
+static void check_minmax(void)
+{
+    robot_arm_minmax_t bucket;
+    float first, second;
+    robot_arm_minmax_reset(&bucket);
+    CHECK(!robot_arm_minmax_get(&bucket, &first, &second));
+    robot_arm_minmax_add(&bucket, NAN);
+    CHECK(!robot_arm_minmax_get(&bucket, &first, &second));
+
+    // One value is both extremes
+    robot_arm_minmax_add(&bucket, 0.5f);
+    CHECK(robot_arm_minmax_get(&bucket, &first, &second) && first == 0.5f && second == 0.5f);
+
+    // Rising then a dip: the peak came first
+    robot_arm_minmax_add(&bucket, 2.0f);
+    robot_arm_minmax_add(&bucket, NAN);
+    robot_arm_minmax_add(&bucket, 1.0f);
+    CHECK(robot_arm_minmax_get(&bucket, &first, &second) && first == 0.5f && second == 2.0f);
+    robot_arm_minmax_add(&bucket, -3.0f);
+    CHECK(robot_arm_minmax_get(&bucket, &first, &second) && first == 2.0f && second == -3.0f);
+    // A new peak after the dip puts the dip first again
+    robot_arm_minmax_add(&bucket, 4.0f);
+    CHECK(robot_arm_minmax_get(&bucket, &first, &second) && first == -3.0f && second == 4.0f);
+
+    // Falling from the first value: the maximum is the first sample
+    robot_arm_minmax_reset(&bucket);
+    robot_arm_minmax_add(&bucket, 1.0f);
+    robot_arm_minmax_add(&bucket, 0.0f);
+    CHECK(robot_arm_minmax_get(&bucket, &first, &second) && first == 1.0f && second == 0.0f);
+}
+
+int main(void)
+{
+    check_minmax();
+
+    CHECK(robot_arm_telemetry_pop(&(robot_arm_telemetry_sample_t){0}) == false);
+    CHECK(robot_arm_telemetry_start(0) == ESP_ERR_INVALID_ARG);
+
+    // Nobody reading: the ring fills up, then new samples are dropped and counted
+    unsigned int expected = 0;
+    int64_t last_us = 0;
+    CHECK(robot_arm_telemetry_start(1000) == ESP_OK);
+    usleep(200 * 1000);
+    robot_arm_telemetry_stop();
+    CHECK(robot_arm_telemetry_get_overruns() > 0);
+    CHECK(drain(&expected, &last_us) == RING_LENGTH);
+    CHECK(atomic_load(&next_value) == RING_LENGTH);
+
+    // Read while it runs, faster than the UI would: every sample taken comes out once, in order
+    atomic_store(&have_feedback, true);
+    CHECK(robot_arm_telemetry_start(2000) == ESP_OK);
+    int popped = 0;
+    for (int n = 0; n < 100; n++) {
+        usleep(2 * 1000);
+        popped += drain(&expected, &last_us);
+    }
+    // Starting again switches the rate without a second timer
+    CHECK(robot_arm_telemetry_start(500) == ESP_OK);
+    usleep(20 * 1000);
+    robot_arm_telemetry_stop();
+    popped += drain(&expected, &last_us);
+    CHECK(popped > 100);
+    CHECK(expected == atomic_load(&next_value));
+
+    // Stopped means stopped
+    unsigned int value = atomic_load(&next_value);
+    usleep(20 * 1000);
+    CHECK(atomic_load(&next_value) == value);
+    CHECK(drain(&expected, &last_us) == 0);
+
+    return host_test_finish("test_telemetry");
+}
@@ -0,0 +1,116 @@
+// Trajectory interpolator: with the UI's joint limits at every streamer rate Kconfig allows, each
+// move stays in range, within the velocity, acceleration and jerk limits, and settles exactly on
+// its target.
+#include "host_test.h"
+#include "robot_arm_traj.h"
+
+#define MAX_STEPS      2000
+// Output derivatives are finite differences of float positions: allow for rounding only
+#define LIMIT_SLACK    1.001f
+
+// Same table as ui_robot_interface.c
+static const robot_arm_traj_limits_t joint_limits[] = {
+    { -1.57f, 1.57f, 1.5f, 4.0f, 80.0f },
+    { -0.2f, 1.4f, 1.0f, 3.0f, 60.0f },
+    { -1.0f, 1.5f, 1.2f, 3.0f, 60.0f },
+    { 1.08f, 3.14f, 2.0f, 6.0f, 120.0f },
+};
+
+typedef struct {
+    float peak_velocity;
+    float peak_acceleration;
+    float peak_jerk;
+    int steps;
+    bool settled;
+} run_result_t;
+
+// Range and default of ROBOT_ARM_UI_TRAJECTORY_RATE_HZ
+static const int rates_hz[] = { 10, 50, 100 };
+static int rate_hz;
+
+// Step toward target, switching to second_target after switch_step steps (never if negative)
+static run_result_t run(const robot_arm_traj_limits_t *limits, float start, float target, int switch_step, float second_target)
+{
+    robot_arm_traj_state_t state;
+    float dt = 1.0f / rate_hz;
+    robot_arm_traj_reset(&state, limits, start, dt);
+
+    run_result_t result = { 0 };
+    float velocity = 0.0f, acceleration = 0.0f;
+    for (int step = 0; step < MAX_STEPS; step++) {
+        if (step == switch_step) {
+            target = second_target;
+        }
+        if (!robot_arm_traj_step(&state, limits, target)) {
+            result.settled = true;
+            result.steps = step;
+            CHECK(state.position == fminf(fmaxf(target, limits->min_rad), limits->max_rad));
+            CHECK(state.velocity == 0.0f);
+            break;
+        }
+        CHECK(state.position >= limits->min_rad && state.position <= limits->max_rad);
+
+        float new_acceleration = (state.velocity - velocity) / dt;
+        float jerk = (new_acceleration - acceleration) / dt;
+        velocity = state.velocity;
+        acceleration = new_acceleration;
+        result.peak_velocity = fmaxf(result.peak_velocity, fabsf(velocity));
+        result.peak_acceleration = fmaxf(result.peak_acceleration, fabsf(acceleration));
+        result.peak_jerk = fmaxf(result.peak_jerk, fabsf(jerk));
+    }
+    return result;
+}
+
+static void check_within_limits(const robot_arm_traj_limits_t *limits, const run_result_t *result)
+{
+    CHECK(result->settled);
+    CHECK(result->peak_velocity <= limits->max_velocity * LIMIT_SLACK);
+    CHECK(result->peak_acceleration <= limits->max_acceleration * LIMIT_SLACK);
+    CHECK(result->peak_jerk <= limits->max_jerk * LIMIT_SLACK);
+}
+
+int main(void)
+{
+    for (size_t r = 0; r < sizeof(rates_hz) / sizeof(rates_hz[0]); r++) {
+        rate_hz = rates_hz[r];
+        for (size_t i = 0; i < sizeof(joint_limits) / sizeof(joint_limits[0]); i++) {
+            const robot_arm_traj_limits_t *limits = &joint_limits[i];
+            float span = limits->max_rad - limits->min_rad;
+            float mid = limits->min_rad + 0.5f * span;
+
+            // Full-range move: cruises at the velocity limit and takes no longer than the ramps plus
+            // the smoothing window
+            run_result_t full = run(limits, limits->min_rad, limits->max_rad, -1, 0.0f);
+            check_within_limits(limits, &full);
+            CHECK(full.peak_velocity >= limits->max_velocity * 0.95f);
+            float ideal_s = span / limits->max_velocity + limits->max_velocity / limits->max_acceleration;
+            float window_s = 2.0f * limits->max_acceleration / limits->max_jerk;
+            CHECK(full.steps / (float)rate_hz <= ideal_s + window_s + 0.1f);
+
+            // Short hop: never reaches cruise speed
+            run_result_t hop = run(limits, mid, mid + 0.01f, -1, 0.0f);
+            check_within_limits(limits, &hop);
+            CHECK(hop.peak_velocity < limits->max_velocity * 0.5f);
+
+            // Target reversed at full speed, as when a slider is dragged back
+            run_result_t reversed = run(limits, limits->min_rad, limits->max_rad, rate_hz / 2, limits->min_rad);
+            check_within_limits(limits, &reversed);
+
+            // Targets outside the range are clamped
+            run_result_t beyond = run(limits, mid, limits->max_rad + 1.0f, -1, 0.0f);
+            check_within_limits(limits, &beyond);
+
+            // Already on target: nothing to do
+            run_result_t still = run(limits, mid, mid, -1, 0.0f);
+            CHECK(still.settled && still.steps == 0);
+        }
+    }
+
+    // A jerk limit too low for the window caps it at ROBOT_ARM_TRAJ_MAX_TAPS
+    robot_arm_traj_limits_t gentle = { -1.0f, 1.0f, 1.0f, 3.0f, 1.0f };
+    robot_arm_traj_state_t state;
+    robot_arm_traj_reset(&state, &gentle, 0.0f, 1.0f / 50);
+    CHECK(state.taps == ROBOT_ARM_TRAJ_MAX_TAPS);
+
+    return host_test_finish("test_traj");
+}